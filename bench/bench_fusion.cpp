@@ -0,0 +1,76 @@
+/**
+ * @file bench_fusion.cpp
+ * @brief Compares fused repetition over a single character matcher with a hand-written loop.
+ * @details `Tok::many(Tok::digit())` is expected to run as fast as
+ * `while (isdigit(*p)) ++p;`, whereas adding a per-character Map forces the
+ * per-token protocol and serves as the unfused reference.
+ */
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <string>
+
+#include "lextok.h"
+
+static volatile std::size_t sink; /**< Keeps the compiler from discarding the results. */
+
+/**
+ * @brief Time a span function over the same buffer several times.
+ * @tparam Span A callable type `std::size_t (Tok::Input)`.
+ * @param[in] name Name reported for the span function.
+ * @param[in] buffer The buffer to be scanned.
+ * @param[in] span A callable object of type `Span`.
+ * @returns Length of the span found by `span`.
+ */
+template<typename Span>
+static std::size_t run(const char* name, const std::string& buffer, Span&& span)
+{
+  constexpr int iterations = 200;
+  std::size_t length = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    length = span(Tok::Input(buffer));
+    sink = length;
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  const double bytes = static_cast<double>(buffer.size()) * iterations;
+  std::printf("%-28s %10.3f ns/byte %10.1f MB/s\n", name,
+      elapsed.count() * 1e9 / bytes, bytes / elapsed.count() / 1e6);
+  return length;
+}
+
+/**
+ * @brief Main entry point.
+ * @retval 0 On success
+ * @retval 1 If the variants disagree on the length of the span
+ */
+int main()
+{
+  const std::string buffer = std::string(1 << 20, '7') + "x";
+
+  const auto handwritten = run("handwritten isdigit loop", buffer, [](Tok::Input input) {
+    const char* p = input.data();
+    const char* const end = p + input.size();
+    while (p != end && std::isdigit(static_cast<unsigned char>(*p)))
+      ++p;
+    return static_cast<std::size_t>(p - input.data());
+  });
+
+  const auto digits = Tok::many(Tok::digit());
+  const auto fused = run("Tok::many(Tok::digit())", buffer, [&digits](Tok::Input input) {
+    return (*digits(input)).size();
+  });
+
+  const auto custom_digits = Tok::many(Tok::impl::single_char_tokenizer(
+        [](char c) { return c >= '0' && c <= '9'; }, Tok::mapper::none));
+  const auto fused_predicate = run("fused custom predicate", buffer, [&custom_digits](Tok::Input input) {
+    return (*custom_digits(input)).size();
+  });
+
+  const auto unfused_digits = Tok::many(Tok::digit([](Tok::Token_view) {}));
+  const auto unfused = run("per-character protocol", buffer, [&unfused_digits](Tok::Input input) {
+    return (*unfused_digits(input)).size();
+  });
+
+  return (handwritten == fused && fused == fused_predicate && fused == unfused) ? 0 : 1;
+}
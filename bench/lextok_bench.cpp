@@ -0,0 +1,592 @@
+/**
+ * @file lextok_bench.cpp
+ * @brief Throughput of every building block of lextok.h and of whole parsers over realistic corpora.
+ * @details Microbenchmarks apply one building block repeatedly over a corpus made for it. Macro
+ * benchmarks parse AT responses, CSV records, log lines and configuration files, each with a
+ * tokenizer and with handwritten, `sscanf` and `std::regex` baselines that must agree with it.
+ *
+ * Results are printed as CSV on the standard output, one row per benchmark:
+ * `group,benchmark,bytes,tokens,iterations,ns_per_token,bytes_per_sec`.
+ *
+ * Usage: `lextok-bench [filter] [seconds]`. Only benchmarks whose name contains `filter` are run,
+ * each for about `seconds` (0.2 by default).
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <regex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "lextok.h"
+
+static volatile std::size_t sink;   /**< Keeps the compiler from discarding the results. */
+static const char* filter = "";     /**< Only benchmarks whose name contains this are run. */
+static double budget = 0.2;         /**< Approximate run time of a benchmark, in seconds. */
+static int failures = 0;            /**< Number of benchmarks disagreeing with their reference. */
+
+/**
+ * @brief Outcome of a run of a macro benchmark.
+ */
+struct outcome {
+  std::size_t tokens;   /**< Number of records found. */
+  std::size_t checksum; /**< Summary of the values found, compared against the reference. */
+};
+
+/**
+ * @brief Time a benchmark and print its row.
+ * @details The body is run until the time budget is spent, at least three times.
+ * @tparam Body A callable type `std::size_t (Tok::Input)` returning the number of tokens found,
+ * or `outcome (Tok::Input)`.
+ * @param[in] group Name of the group of the benchmark.
+ * @param[in] name Name of the benchmark.
+ * @param[in] corpus The input given to the body on every run.
+ * @param[in] body A callable object of type `Body`.
+ * @returns The checksum, or else the number of tokens found by the body. 0 if the benchmark
+ * was filtered out.
+ */
+template<typename Body>
+static std::size_t run(const char* group, const char* name, const std::string& corpus, Body&& body)
+{
+  if (!std::strstr(name, filter) && !std::strstr(group, filter))
+    return 0;
+  outcome result{};
+  std::size_t iterations = 0;
+  std::chrono::duration<double> elapsed{};
+  const auto start = std::chrono::steady_clock::now();
+  while (iterations < 3 || elapsed.count() < budget) {
+    if constexpr (std::is_same_v<decltype(body(Tok::Input(corpus))), outcome>)
+      result = body(Tok::Input(corpus));
+    else
+      result.tokens = result.checksum = body(Tok::Input(corpus));
+    sink = result.checksum;
+    iterations++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  }
+  const double runs = static_cast<double>(iterations);
+  const double bytes = static_cast<double>(corpus.size()) * runs;
+  const double tokens = static_cast<double>(result.tokens);
+  const double ns_per_token = result.tokens ? elapsed.count() * 1e9 / (tokens * runs) : 0;
+  std::printf("%s,%s,%zu,%zu,%zu,%.3f,%.0f\n", group, name, corpus.size(), result.tokens, iterations,
+      ns_per_token, bytes / elapsed.count());
+  std::fflush(stdout);
+  return result.checksum;
+}
+
+/**
+ * @brief Report a benchmark whose result disagrees with its reference.
+ * @param[in] name Name of the benchmark.
+ * @param[in] result Checksum of the benchmark.
+ * @param[in] reference Expected checksum, 0 if the reference was filtered out.
+ */
+static void check(const char* name, std::size_t result, std::size_t reference)
+{
+  if (result && reference && result != reference) {
+    std::fprintf(stderr, "%s found %zu instead of %zu\n", name, result, reference);
+    failures++;
+  }
+}
+
+/**
+ * @brief Count the tokens a tokenizer extracts from an input by applying it repeatedly.
+ * @details A character is skipped wherever the tokenizer does not consume any input. Only
+ * tokens that consume input are counted.
+ * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+ * @param[in] tokenizer A callable object of type `Tokenizer`.
+ * @param[in] input The input to be tokenized.
+ * @returns Number of tokens extracted.
+ */
+template<typename Tokenizer>
+static std::size_t drain(const Tokenizer& tokenizer, Tok::Input input)
+{
+  std::size_t count = 0;
+  while (!input.empty()) {
+    const auto before = input.size();
+    tokenizer(input);
+    if (input.size() == before)
+      input.remove_prefix(1);
+    else
+      count++;
+  }
+  return count;
+}
+
+/**
+ * @brief Repeat a piece of text with a counter substituted for every `@`.
+ * @param[in] pattern The text to be repeated.
+ * @param[in] size Least size of the result.
+ * @returns The repeated text.
+ */
+static std::string repeat(const char* pattern, std::size_t size)
+{
+  std::string text;
+  for (unsigned i = 0; text.size() < size; i++)
+    for (const char* p = pattern; *p; p++)
+      if (*p == '@')
+        text += std::to_string(i % 1000);
+      else
+        text += *p;
+  return text;
+}
+
+/**
+ * @brief Split a corpus into lines for the `sscanf` baselines.
+ * @details Each line is copied into a NUL-terminated buffer, since `sscanf` would otherwise
+ * measure the length of the rest of the corpus on every call.
+ * @tparam Visitor A callable type `void (const char* line)`.
+ * @param[in] input The corpus.
+ * @param[in] visit Called on every line, without its newline.
+ */
+template<typename Visitor>
+static void for_each_line(Tok::Input input, Visitor&& visit)
+{
+  char line[256];
+  while (!input.empty()) {
+    const auto end = input.find('\n');
+    const auto size = std::min<std::size_t>(end == Tok::Input::npos ? input.size() : end, sizeof(line) - 1);
+    input.copy(line, size);
+    line[size] = '\0';
+    visit(static_cast<const char*>(line));
+    input.remove_prefix(end == Tok::Input::npos ? input.size() : end + 1);
+  }
+}
+
+/** Size of every corpus. */
+static constexpr std::size_t corpus_size = 1 << 20;
+
+/**
+ * @brief Benchmark every building block on its own.
+ */
+static void micro()
+{
+  const auto digits = repeat("0123456789", corpus_size);
+  const auto words = repeat("lorem ipsum dolor sit amet consectetur ", corpus_size);
+  const auto commas = std::string(corpus_size, ',');
+  const auto oks = repeat("OK\r\n", corpus_size);
+  const auto results = repeat("OK\r\nERROR\r\n+CME ERROR: @\r\nNO CARRIER\r\n", corpus_size);
+  const auto fields = repeat("1234567@,1234567@,1234567@,1234567@,1234567@.", corpus_size);
+  const auto settings = repeat("  timeout =  @ ;\n\tretries= 3;\n", corpus_size);
+  const auto hex = repeat("1f2e3d4c", corpus_size);
+  const auto hex_numbers = repeat("1f2e 3d4c ", corpus_size);
+  const auto signed_numbers = repeat("-@ @ ", corpus_size);
+  const auto decimals = repeat("-@.25e-3 ", corpus_size);
+  const auto lines = repeat("+CGPADDR: 1,\"10.0.0.@\" some opaque payload of the modem response\n", corpus_size);
+  const auto noise = repeat("garbage garbage garbage garbage garbage garbage garbage garbage @\n", corpus_size) +
+    "+CGPADDR: 1,10.0.0.1\r\n";
+  const auto source = repeat("if counter == @ else total = total + @ ;\n", corpus_size);
+
+  run("micro", "char_class digit", digits, [](Tok::Input input) { return drain(Tok::digit(), input); });
+  run("micro", "any_of", words, [](Tok::Input input) { return drain(Tok::any_of("aeiou"), input); });
+  run("micro", "none_of", words, [](Tok::Input input) { return drain(Tok::none_of(" "), input); });
+  run("micro", "char_token", commas, [](Tok::Input input) { return drain(Tok::char_token(','), input); });
+  run("micro", "str_token", oks, [](Tok::Input input) { return drain(Tok::str_token("OK\r\n"), input); });
+  run("micro", "istr_token", oks, [](Tok::Input input) { return drain(Tok::istr_token("ok\r\n"), input); });
+  run("micro", "keyword_set", results, [](Tok::Input input) {
+    return drain(Tok::keyword_set({"OK", "ERROR", "+CME ERROR", "NO CARRIER"}), input);
+  });
+  run("micro", "alternation", results, [](Tok::Input input) {
+    return drain(Tok::str_token("OK") | Tok::str_token("ERROR") | Tok::str_token("+CME ERROR") |
+        Tok::str_token("NO CARRIER"), input);
+  });
+  run("micro", "alternation skewed", fields, [](Tok::Input input) {
+    const auto digits = Tok::at_least_one(Tok::digit());
+    return drain((digits & Tok::char_token(':')) | (digits & Tok::char_token(';')) |
+        (digits & Tok::char_token('.')) | (digits & Tok::char_token(',')), input);
+  });
+  run("micro", "adaptive_alt skewed", fields, [](Tok::Input input) {
+    static Tok::branch_stats stats;
+    const auto digits = Tok::at_least_one(Tok::digit());
+    return drain(Tok::adaptive_alt(stats, digits & Tok::char_token(':'), digits & Tok::char_token(';'),
+          digits & Tok::char_token('.'), digits & Tok::char_token(',')), input);
+  });
+  const auto handwritten_words = run("micro", "handwritten word loop", words, [](Tok::Input input) {
+    std::size_t count = 0;
+    const char* p = input.data();
+    const char* const end = p + input.size();
+    while (p != end) {
+      const char* const start = p;
+      while (p != end && *p >= 'a' && *p <= 'z')
+        ++p;
+      count += p != start;
+      if (p != end)
+        ++p;
+    }
+    return count;
+  });
+  check("many", run("micro", "many", words, [](Tok::Input input) {
+    return drain(Tok::many(Tok::lower_alphabet()), input);
+  }), handwritten_words);
+  check("at_least_one", run("micro", "at_least_one", words, [](Tok::Input input) {
+    return drain(Tok::at_least_one(Tok::lower_alphabet()), input);
+  }), handwritten_words);
+  run("micro", "exactly", hex, [](Tok::Input input) { return drain(Tok::exactly(Tok::hex_digit(), 4), input); });
+  run("micro", "maybe & sequence", signed_numbers, [](Tok::Input input) {
+    return drain(Tok::maybe(Tok::char_token('-')) & Tok::at_least_one(Tok::digit()), input);
+  });
+  run("micro", "map", signed_numbers, [](Tok::Input input) {
+    std::size_t bytes = 0;
+    drain(Tok::map(Tok::at_least_one(Tok::digit()), [&bytes](Tok::Token_view t) { bytes += t.size(); }), input);
+    return bytes;
+  });
+  run("micro", "integer", signed_numbers, [](Tok::Input input) { return drain(Tok::integer<int>(), input); });
+  run("micro", "hex_integer", hex_numbers, [](Tok::Input input) {
+    return drain(Tok::hex_integer<std::uint16_t>(), input);
+  });
+  run("micro", "decimal", decimals, [](Tok::Input input) { return drain(Tok::decimal<double>(), input); });
+  const auto handwritten_lines = run("micro", "handwritten memchr", lines, [](Tok::Input input) {
+    std::size_t count = 0;
+    const char* p = input.data();
+    const char* const end = p + input.size();
+    while (const void* found = std::memchr(p, '\n', static_cast<std::size_t>(end - p))) {
+      p = static_cast<const char*>(found) + 1;
+      count++;
+    }
+    return count;
+  });
+  check("until", run("micro", "until", lines, [](Tok::Input input) {
+    return drain(Tok::until('\n') & Tok::char_token('\n'), input);
+  }), handwritten_lines);
+  check("many none_of", run("micro", "many none_of", lines, [](Tok::Input input) {
+    return drain(Tok::many(Tok::none_of("\n")) & Tok::char_token('\n'), input);
+  }), handwritten_lines);
+  run("micro", "search", noise, [](Tok::Input input) {
+    return static_cast<std::size_t>(Tok::search(Tok::str_token("+CGPADDR: ") & Tok::integer<int>(), input).has_value());
+  });
+  run("micro", "line_index", lines, [](Tok::Input input) {
+    static std::size_t arena[corpus_size / 16];
+    Tok::line_index index(input, arena);
+    std::size_t queries = 0;
+    for (std::size_t offset = 0; offset < input.size(); offset += 4099)
+      queries += index.position(offset).line != 0;
+    return queries;
+  });
+  run("micro", "tokens", words, [](Tok::Input input) {
+    std::size_t count = 0;
+    for (const auto token : Tok::tokens(Tok::at_least_one(Tok::lower_alphabet()) & Tok::maybe(Tok::char_token(' ')), input))
+      count += !token.empty();
+    return count;
+  });
+  run("micro", "explicit whitespace", settings, [](Tok::Input input) {
+    const auto blanks = Tok::many(Tok::whitespace());
+    return drain(blanks & Tok::at_least_one(Tok::alphabet()) & blanks & Tok::char_token('=') & blanks &
+        Tok::at_least_one(Tok::digit()) & blanks & Tok::char_token(';') & blanks, input);
+  });
+  run("micro", "skip", settings, [](Tok::Input input) {
+    return drain(Tok::skip(Tok::whitespace(), Tok::at_least_one(Tok::alphabet()) & Tok::char_token('=') &
+          Tok::at_least_one(Tok::digit()) & Tok::char_token(';')), input);
+  });
+  const auto identifier = Tok::at_least_one(Tok::alphabet()) & Tok::many(Tok::alphabet() | Tok::digit());
+  run("micro", "combinators", words, [&identifier](Tok::Input input) { return drain(identifier, input); });
+  static constexpr auto compiled = Tok::compile(Tok::at_least_one(Tok::alphabet()) &
+      Tok::many(Tok::alphabet() | Tok::digit()));
+  run("micro", "compile", words, [](Tok::Input input) { return drain(compiled, input); });
+  const auto lex = Tok::lexer(
+      std::pair{0, Tok::str_token("if") | Tok::str_token("else")},
+      std::pair{1, Tok::at_least_one(Tok::alphabet())},
+      std::pair{2, Tok::at_least_one(Tok::digit())},
+      std::pair{3, Tok::str_token("==") | Tok::any_of("=+;")},
+      std::pair{4, Tok::at_least_one(Tok::whitespace())});
+  run("micro", "lexer", source, [&lex](Tok::Input input) {
+    std::size_t count = 0;
+    lex(input, [&count](Tok::token_record) { count++; });
+    return count;
+  });
+  run("micro", "lexer into vector", source, [&lex](Tok::Input input) {
+    static std::vector<Tok::token_record> records;
+    records.clear();
+    lex(input, [](Tok::token_record token) { records.push_back(token); });
+    return records.size();
+  });
+  run("micro", "lexer into token_buffer", source, [&lex](Tok::Input input) {
+    static Tok::token_arena<corpus_size> arena;
+    Tok::token_buffer buffer(arena);
+    lex(input, buffer);
+    return buffer.size();
+  });
+  run("micro", "memo", results, [](Tok::Input input) {
+    static Tok::memo_entry arena[64];
+    Tok::memo_cache cache(arena);
+    const auto head = Tok::memo(Tok::at_least_one(Tok::none_of("\r")), cache);
+    const auto line = (head & Tok::str_token("\r\n")) | (head & Tok::char_token('\r'));
+    std::size_t count = 0;
+    while (!input.empty()) {
+      cache.clear();
+      if (!line(input))
+        break;
+      count++;
+    }
+    return count;
+  });
+  run("micro", "attr", signed_numbers, [](Tok::Input input) {
+    const auto pair = Tok::attr::integer<int>() & Tok::char_token(' ') & Tok::attr::integer<int>() &
+      Tok::char_token(' ');
+    std::size_t count = 0;
+    while (const auto values = pair.parse(input))
+      count += 2;
+    return count;
+  });
+}
+
+/**
+ * @brief Parse AT command responses, summing the last octet of every PDP address.
+ */
+static void at_responses()
+{
+  const auto corpus = repeat("\r\n+CSQ: 21,99\r\n\r\nOK\r\n\r\n+CGPADDR: 1,\"10.0.1.@\"\r\n\r\nOK\r\n", corpus_size);
+  const auto reference = run("at", "handwritten", corpus, [](Tok::Input input) {
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    for (auto at = input.find("+CGPADDR: "); at != Tok::Input::npos; at = input.find("+CGPADDR: ", at + 1)) {
+      auto p = at + 10;
+      while (p < input.size() && input[p] != ',')
+        p++;
+      p += 2;
+      for (int dots = 0; p < input.size() && dots < 3; p++)
+        dots += input[p] == '.';
+      unsigned octet = 0;
+      while (p < input.size() && input[p] >= '0' && input[p] <= '9')
+        octet = octet * 10 + static_cast<unsigned>(input[p++] - '0');
+      sum += octet;
+      records++;
+    }
+    return outcome{records, sum};
+  });
+  check("at lextok", run("at", "lextok", corpus, [](Tok::Input input) {
+    unsigned octet = 0;
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    const auto address = Tok::str_token("+CGPADDR: ") & Tok::integer<int>() & Tok::str_token(",\"") &
+      Tok::exactly(Tok::integer<unsigned>() & Tok::char_token('.'), 3) & Tok::integer(octet) & Tok::char_token('"');
+    while (Tok::search(address, input)) {
+      sum += octet;
+      records++;
+    }
+    return outcome{records, sum};
+  }), reference);
+  check("at sscanf", run("at", "sscanf", corpus, [](Tok::Input input) {
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    for_each_line(input, [&](const char* line) {
+      int cid = 0;
+      unsigned a = 0, b = 0, c = 0, d = 0;
+      if (std::sscanf(line, "+CGPADDR: %d,\"%u.%u.%u.%u\"", &cid, &a, &b, &c, &d) == 5) {
+        sum += d;
+        records++;
+      }
+    });
+    return outcome{records, sum};
+  }), reference);
+  check("at regex", run("at", "regex", corpus, [](Tok::Input input) {
+    static const std::regex address(R"re(\+CGPADDR: \d+,"\d+\.\d+\.\d+\.(\d+)")re");
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    for (std::cregex_iterator it(input.data(), input.data() + input.size(), address), end; it != end; ++it) {
+      sum += static_cast<std::size_t>(std::atoi((*it)[1].first));
+      records++;
+    }
+    return outcome{records, sum};
+  }), reference);
+}
+
+/**
+ * @brief Parse CSV records of an identifier, a name and a reading, summing the identifiers.
+ */
+static void csv()
+{
+  const auto corpus = repeat("@,sensor_@,@.25\n", corpus_size);
+  const auto reference = run("csv", "handwritten", corpus, [](Tok::Input input) {
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    const char* p = input.data();
+    const char* const end = p + input.size();
+    while (p != end) {
+      std::size_t id = 0;
+      while (*p != ',')
+        id = id * 10 + static_cast<std::size_t>(*p++ - '0');
+      p = static_cast<const char*>(std::memchr(p + 1, ',', static_cast<std::size_t>(end - p - 1)));
+      p = static_cast<const char*>(std::memchr(p + 1, '\n', static_cast<std::size_t>(end - p - 1))) + 1;
+      sum += id;
+      records++;
+    }
+    return outcome{records, sum};
+  });
+  check("csv lextok", run("csv", "lextok", corpus, [](Tok::Input input) {
+    std::size_t id = 0;
+    double reading = 0;
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    const auto record = Tok::integer(id) & Tok::char_token(',') & Tok::until(',') & Tok::char_token(',') &
+      Tok::decimal(reading) & Tok::char_token('\n');
+    while (record(input)) {
+      sum += id;
+      records++;
+    }
+    return outcome{records, sum};
+  }), reference);
+  check("csv attr", run("csv", "attr", corpus, [](Tok::Input input) {
+    const auto record = Tok::attr::integer<std::size_t>() & Tok::char_token(',') &
+      Tok::attr::token(Tok::until(',')) & Tok::char_token(',') & Tok::attr::decimal() & Tok::char_token('\n');
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    while (const auto fields = record.parse(input)) {
+      sum += std::get<0>(*fields);
+      records++;
+    }
+    return outcome{records, sum};
+  }), reference);
+  check("csv sscanf", run("csv", "sscanf", corpus, [](Tok::Input input) {
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    for_each_line(input, [&](const char* line) {
+      std::size_t id = 0;
+      double reading = 0;
+      if (std::sscanf(line, "%zu,%*[^,],%lf", &id, &reading) == 2) {
+        sum += id;
+        records++;
+      }
+    });
+    return outcome{records, sum};
+  }), reference);
+  check("csv regex", run("csv", "regex", corpus, [](Tok::Input input) {
+    static const std::regex record(R"((\d+),([^,]*),([-0-9.eE]+)\n)");
+    std::size_t sum = 0;
+    std::size_t records = 0;
+    for (std::cregex_iterator it(input.data(), input.data() + input.size(), record), end; it != end; ++it) {
+      sum += static_cast<std::size_t>(std::atol((*it)[1].first));
+      records++;
+    }
+    return outcome{records, sum};
+  }), reference);
+}
+
+/**
+ * @brief Parse timestamped log lines, counting the warnings.
+ */
+static void log_lines()
+{
+  const auto corpus = repeat("2026-10-14T12:34:56.789 INFO modem: attached rssi=-73 cell=@\n"
+      "2026-10-14T12:34:57.001 WARN modem: weak signal rssi=-107 cell=@\n", corpus_size);
+  const auto reference = run("log", "handwritten", corpus, [](Tok::Input input) {
+    std::size_t count = 0;
+    std::size_t records = 0;
+    while (!input.empty()) {
+      const auto end = input.find('\n');
+      count += input.compare(24, 4, "WARN") == 0;
+      records++;
+      input.remove_prefix(end + 1);
+    }
+    return outcome{records, count};
+  });
+  check("log lextok", run("log", "lextok", corpus, [](Tok::Input input) {
+    std::size_t count = 0;
+    std::size_t records = 0;
+    std::size_t level = 0;
+    const auto date = Tok::exactly(Tok::digit(), 4) & Tok::char_token('-') & Tok::exactly(Tok::digit(), 2) &
+      Tok::char_token('-') & Tok::exactly(Tok::digit(), 2);
+    const auto time = Tok::exactly(Tok::digit(), 2) & Tok::char_token(':') & Tok::exactly(Tok::digit(), 2) &
+      Tok::char_token(':') & Tok::exactly(Tok::digit(), 2) & Tok::char_token('.') & Tok::exactly(Tok::digit(), 3);
+    const auto severity = Tok::keyword_set({"DEBUG", "INFO", "WARN", "ERROR"},
+        [&level](std::size_t index, Tok::Token_view) { level = index; });
+    const auto line = date & Tok::char_token('T') & time & Tok::char_token(' ') & severity & Tok::char_token(' ') &
+      Tok::until('\n') & Tok::char_token('\n');
+    while (line(input)) {
+      count += level == 2;
+      records++;
+    }
+    return outcome{records, count};
+  }), reference);
+  check("log sscanf", run("log", "sscanf", corpus, [](Tok::Input input) {
+    std::size_t count = 0;
+    std::size_t records = 0;
+    for_each_line(input, [&](const char* line) {
+      char severity[8];
+      if (std::sscanf(line, "%*4d-%*2d-%*2dT%*2d:%*2d:%*2d.%*3d %7s", severity) == 1) {
+        count += std::strcmp(severity, "WARN") == 0;
+        records++;
+      }
+    });
+    return outcome{records, count};
+  }), reference);
+  check("log regex", run("log", "regex", corpus, [](Tok::Input input) {
+    static const std::regex line(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3} (DEBUG|INFO|WARN|ERROR) [^\n]*\n)");
+    std::size_t count = 0;
+    std::size_t records = 0;
+    for (std::cregex_iterator it(input.data(), input.data() + input.size(), line), end; it != end; ++it) {
+      count += (*it)[1].compare("WARN") == 0;
+      records++;
+    }
+    return outcome{records, count};
+  }), reference);
+}
+
+/**
+ * @brief Parse `key = value` configuration files with comments, counting the settings.
+ */
+static void config()
+{
+  const auto corpus = repeat("# Modem setting number @\napn = internet\nretries = @\n\nband_mask=0x1f\n", corpus_size);
+  const auto reference = run("config", "handwritten", corpus, [](Tok::Input input) {
+    std::size_t count = 0;
+    while (!input.empty()) {
+      const auto end = input.find('\n');
+      const auto line = input.substr(0, end);
+      count += !line.empty() && line[0] != '#' && line.find('=') != Tok::Input::npos;
+      input.remove_prefix(end == Tok::Input::npos ? input.size() : end + 1);
+    }
+    return count;
+  });
+  check("config lextok", run("config", "lextok", corpus, [](Tok::Input input) {
+    std::size_t count = 0;
+    const auto blank = Tok::many(Tok::any_of(" \t"));
+    const auto key = Tok::at_least_one(Tok::any_of(Tok::char_class::alphabet | Tok::char_class::digit |
+          Tok::char_set::of('_')));
+    const auto setting = Tok::map(key & blank & Tok::char_token('=') & blank & Tok::until('\n'),
+        [&count](Tok::Token_view) { count++; });
+    const auto comment = Tok::char_token('#') & Tok::until('\n');
+    const auto line = Tok::maybe(comment | setting) & Tok::char_token('\n');
+    while (line(input))
+      ;
+    return count;
+  }), reference);
+  check("config sscanf", run("config", "sscanf", corpus, [](Tok::Input input) {
+    std::size_t count = 0;
+    for_each_line(input, [&count](const char* line) {
+      char key[64];
+      char equals = 0;
+      count += std::sscanf(line, "%63[A-Za-z0-9_] %c", key, &equals) == 2 && equals == '=';
+    });
+    return count;
+  }), reference);
+  check("config regex", run("config", "regex", corpus, [](Tok::Input input) {
+    static const std::regex setting(R"([A-Za-z0-9_]+[ \t]*=[^\n]*\n)");
+    std::size_t count = 0;
+    for (std::cregex_iterator it(input.data(), input.data() + input.size(), setting), end; it != end; ++it)
+      count++;
+    return count;
+  }), reference);
+}
+
+/**
+ * @brief Main entry point.
+ * @param[in] argc Number of arguments.
+ * @param[in] argv The filter and the time budget, both optional.
+ * @retval 0 On success
+ * @retval 1 If a benchmark disagrees with its reference
+ */
+int main(int argc, char* argv[])
+{
+  if (argc > 1)
+    filter = argv[1];
+  if (argc > 2)
+    budget = std::atof(argv[2]);
+  std::printf("group,benchmark,bytes,tokens,iterations,ns_per_token,bytes_per_sec\n");
+  micro();
+  at_responses();
+  csv();
+  log_lines();
+  config();
+  return failures ? 1 : 0;
+}
@@ -7,17 +7,82 @@
  * @details This library provides a toolkit for building tokenizers. The tokenizers
  * work on `std::string_view` as input.
  *
- * A tokenizer is a lambda with the type `Tok::Token (Tok::Input& input)`.
+ * A tokenizer is a callable object with the type `Tok::Token (Tok::Input& input)`.
  */
 #ifndef LEXTOK_H
 #define LEXTOK_H
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
 #include <utility>
 #include <optional>
 #include <tuple>
 #include <type_traits>
 
 #include <string_view>
+#include <new>
+
+#if defined(__clang__)
+#  if __has_builtin(__builtin_is_constant_evaluated)
+#    define LEXTOK_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#  endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#  define LEXTOK_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+/*
+ * Vector kernels are only used when the compiler can tell constant evaluation apart,
+ * so that every tokenizer stays usable at compile time. Define LEXTOK_NO_SIMD to
+ * always use the scalar fallback.
+ */
+#if defined(LEXTOK_CONSTANT_EVALUATED) && !defined(LEXTOK_NO_SIMD)
+#  if defined(__AVX2__)
+#    include <immintrin.h>
+#    define LEXTOK_SIMD_AVX2
+#  elif defined(__SSSE3__)
+#    include <tmmintrin.h>
+#    define LEXTOK_SIMD_SSSE3
+#  elif defined(__SSE2__)
+#    include <emmintrin.h>
+#    define LEXTOK_SIMD_SSE2
+#  elif defined(__aarch64__) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define LEXTOK_SIMD_NEON
+#  endif
+#  if defined(LEXTOK_SIMD_AVX2) || defined(LEXTOK_SIMD_SSSE3) || defined(LEXTOK_SIMD_SSE2) || defined(LEXTOK_SIMD_NEON)
+#    define LEXTOK_SIMD
+#  endif
+#endif
+
+/*
+ * Define LEXTOK_PROFILE to count, per node wrapped with Tok::profiled, its invocations, matches,
+ * bytes consumed, backtracks and alternation branches tried. Define LEXTOK_PROFILE_CYCLES as well
+ * to also count CPU cycles. Without LEXTOK_PROFILE, Tok::profiled returns the tokenizer unchanged.
+ */
+#if defined(LEXTOK_PROFILE)
+#  if !defined(LEXTOK_CONSTANT_EVALUATED)
+#    error "LEXTOK_PROFILE needs a compiler that supports __builtin_is_constant_evaluated"
+#  endif
+#  include <cstdio>
+#  include <initializer_list>
+#  if defined(LEXTOK_PROFILE_CYCLES) && (defined(__x86_64__) || defined(__i386__))
+#    include <x86intrin.h>
+#  endif
+#endif
+
+/*
+ * Define LEXTOK_TRACK_FAILURES to record, within Tok::diagnose, the furthest offset at which a
+ * sequence or an alternation failed and what was expected there. Without it, Tok::diagnose and
+ * Tok::named return the tokenizer unchanged.
+ */
+#if defined(LEXTOK_TRACK_FAILURES) && !defined(LEXTOK_CONSTANT_EVALUATED)
+#  error "LEXTOK_TRACK_FAILURES needs a compiler that supports __builtin_is_constant_evaluated"
+#endif
 
 /**
  * @brief A helper macro to assert in case of invalid Map type.
@@ -43,10 +108,41 @@
       "Acceptor_Predicate must be a callable type 'bool (char c)'"); \
 }
 
+/**
+ * @brief A helper macro to assert in case of invalid Map type over characters of any type.
+ */
+#define VALIDATE_BASIC_MAP_TYPE(char_type, map_type) { \
+  static_assert(std::is_same_v<std::decay_t<map_type>, Tok::mapper::none_t> || \
+      std::is_invocable_r_v<void, map_type, Tok::basic_input<char_type>>, \
+      "Map must be a callable type 'void (Tok::basic_input<CharT>)'"); \
+}
+
+/**
+ * @brief A helper macro to assert in case of invalid Tokenizer type over characters of any type.
+ */
+#define VALIDATE_BASIC_TOKENIZER_TYPE(char_type, tokenizer_type) { \
+  static_assert(std::is_invocable_r_v<Tok::basic_token<char_type>, tokenizer_type, Tok::basic_input<char_type>&>, \
+      "Tokenizer must be a callable type 'Tok::basic_token<CharT> (Tok::basic_input<CharT>&)'"); \
+}
+
+/**
+ * @brief A helper macro to assert in case of invalid Indexed_Map type.
+ */
+#define VALIDATE_INDEXED_MAP_TYPE(map_type) { \
+  static_assert(std::is_invocable_r_v<void, map_type, std::size_t, Tok::Token_view>, \
+      "Indexed_Map must be a callable type 'void (std::size_t index, Tok::Token_view)'"); \
+}
+
 
 /// The main namespace for the lexical tokenization library
 namespace Tok {
 
+  template<typename CharT>
+    using basic_input = std::basic_string_view<CharT>;  /**< Define an input type of characters of type `CharT`. */
+
+  template<typename CharT>
+    using basic_token = std::optional<std::basic_string_view<CharT>>;  /**< Define a type to optionally hold a token of characters of type `CharT`. */
+
   using Input = std::string_view;  /**< Define an input type. */
 
   using Token = std::optional<std::string_view>; /**< Define a type to optionally hold a token. */
@@ -55,485 +151,8427 @@ namespace Tok {
 
   using Predicate = std::string_view;  /**< Define a type that provides a view into characters that serve as predicates. */
 
-  /// Private namespace that holds implementation details
-  namespace impl {
-    /**
-     * @brief Attempt to extract a single character token.
-     * @details The token is extracted based on a predicate passed to specialize
-     * the function template. On a match, `func` is called on it.
-     * @tparam Acceptor_Predicate A callable object that is of the type `bool (char c)`. It returns
-     * `true` if the character `c` satisfies the condition to be classified as a token.
-     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-     * @param[in] pred A predicate that decides if a character is an acceptable token.
-     * @param[in] func A callable object to further process / map the extracted token.
-     * @returns A lambda that extracts a single character token based on the predicate.
-     */
-    template<typename Acceptor_Predicate, typename Map>
-      constexpr auto single_char_tokenizer(Acceptor_Predicate&& pred, Map&& func) noexcept
+  /**
+   * @brief A set of 8-bit characters stored as a 256-bit bitmap.
+   * @details Membership of a character is tested with a single table lookup, independent
+   * of the number of characters in the set. Sets can be built at compile time and
+   * composed with union (`|`), intersection (`&`), difference (`-`) and complement (`~`),
+   * so a combined class costs the same to test as a single one. A `Tok::char_set` is
+   * itself an Acceptor_Predicate of the type `bool (char c)`.
+   */
+  class char_set {
+    public:
+      /**
+       * @brief Create an empty set.
+       */
+      constexpr char_set() noexcept = default;
+
+      /**
+       * @brief Create a set holding every character of a group.
+       * @param[in] char_group A view into the group of characters that make up the set.
+       */
+      constexpr explicit char_set(Predicate char_group) noexcept
       {
-        VALIDATE_MAP_TYPE(Map);
-        VALIDATE_ACCEPTOR_TYPE(Acceptor_Predicate);
-        return [p = std::forward<Acceptor_Predicate>(pred),
-        func = std::forward<Map>(func)](Input& input) -> Token {
-          if (input.size() == 0 || !p(input[0]))
-            return {};
-          const Token_view token(input.substr(0, 1));
-          func(token);
-          input.remove_prefix(1);
-          return {token};
-        };
+        for (const auto& c : char_group)
+          insert(c);
       }
 
-    /**
-     * @brief Compute the size of the largest token obtained by repeatedly applying `Tokenizer` on the input.
-     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
-     * @param[in] tokenizer A callable object of type `Tokenizer`.
-     * @param[in] input The input to the tokenizer.
-     * @returns Size of the largest token obtained by repeatedly applying `Tokenizer` on the input.
-     */
-    template<typename Tokenizer>
-      constexpr std::size_t accumulation_size(Tokenizer&& tokenizer, Input input) noexcept
+      /**
+       * @brief Create a set holding a single character.
+       * @param[in] c Character that makes up the set.
+       * @returns A set containing only `c`.
+       */
+      static constexpr char_set of(char c) noexcept
       {
-        std::size_t sz = 0;
-        while (!input.empty()) {
-          const auto token = tokenizer(input);
-          if (!token)
-            return sz;
-          sz += (*token).size();
-        }
-        return sz;
+        char_set set;
+        set.insert(c);
+        return set;
+      }
+
+      /**
+       * @brief Create a set holding an inclusive range of characters.
+       * @param[in] first The first character of the range.
+       * @param[in] last The last character of the range.
+       * @returns A set containing all characters in [first, last]. It is empty if `first > last`.
+       */
+      static constexpr char_set range(char first, char last) noexcept
+      {
+        char_set set;
+        for (unsigned c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++)
+          set.insert(static_cast<char>(c));
+        return set;
+      }
+
+      /**
+       * @brief Create a set holding all 8-bit characters.
+       * @returns A set containing every character.
+       */
+      static constexpr char_set all() noexcept
+      {
+        return ~char_set{};
+      }
+
+      /**
+       * @brief Add a character to the set.
+       * @param[in] c Character to be added.
+       */
+      constexpr void insert(char c) noexcept
+      {
+        const auto u = static_cast<unsigned char>(c);
+        bits[u >> 6] |= std::uint64_t{1} << (u & 63);
+      }
+
+      /**
+       * @brief Check if a character is a member of the set.
+       * @param[in] c Character to be checked.
+       * @retval true `c` is a member of the set.
+       * @retval false `c` is not a member of the set.
+       */
+      constexpr bool contains(char c) const noexcept
+      {
+        const auto u = static_cast<unsigned char>(c);
+        return (bits[u >> 6] >> (u & 63)) & 1;
+      }
+
+      /**
+       * @brief Check if a character is a member of the set.
+       * @details This allows a set to be used wherever an Acceptor_Predicate is expected.
+       * @param[in] c Character to be checked.
+       * @retval true `c` is a member of the set.
+       * @retval false `c` is not a member of the set.
+       */
+      constexpr bool operator()(char c) const noexcept
+      {
+        return contains(c);
+      }
+
+      /**
+       * @brief Count the number of characters in the set.
+       * @returns The number of members of the set.
+       */
+      constexpr std::size_t count() const noexcept
+      {
+        std::size_t n = 0;
+        for (const auto& word : bits)
+          for (auto w = word; w; w &= w - 1)
+            n++;
+        return n;
+      }
+
+      /**
+       * @brief Check if the set has no members.
+       * @retval true The set is empty.
+       * @retval false The set has at least one member.
+       */
+      constexpr bool empty() const noexcept
+      {
+        return (bits[0] | bits[1] | bits[2] | bits[3]) == 0;
+      }
+
+      /**
+       * @brief Compute the union of two sets.
+       * @param[in] l The left operand.
+       * @param[in] r The right operand.
+       * @returns A set containing characters that are in either `l` or `r`.
+       */
+      friend constexpr char_set operator|(const char_set& l, const char_set& r) noexcept
+      {
+        char_set set;
+        for (std::size_t i = 0; i < 4; i++)
+          set.bits[i] = l.bits[i] | r.bits[i];
+        return set;
+      }
+
+      /**
+       * @brief Compute the intersection of two sets.
+       * @param[in] l The left operand.
+       * @param[in] r The right operand.
+       * @returns A set containing characters that are in both `l` and `r`.
+       */
+      friend constexpr char_set operator&(const char_set& l, const char_set& r) noexcept
+      {
+        char_set set;
+        for (std::size_t i = 0; i < 4; i++)
+          set.bits[i] = l.bits[i] & r.bits[i];
+        return set;
+      }
+
+      /**
+       * @brief Compute the difference of two sets.
+       * @param[in] l The left operand.
+       * @param[in] r The right operand.
+       * @returns A set containing characters that are in `l` but not in `r`.
+       */
+      friend constexpr char_set operator-(const char_set& l, const char_set& r) noexcept
+      {
+        char_set set;
+        for (std::size_t i = 0; i < 4; i++)
+          set.bits[i] = l.bits[i] & ~r.bits[i];
+        return set;
+      }
+
+      /**
+       * @brief Compute the complement of a set.
+       * @param[in] s The operand.
+       * @returns A set containing all characters that are not in `s`.
+       */
+      friend constexpr char_set operator~(const char_set& s) noexcept
+      {
+        char_set set;
+        for (std::size_t i = 0; i < 4; i++)
+          set.bits[i] = ~s.bits[i];
+        return set;
+      }
+
+      /**
+       * @brief Check if two sets have the same members.
+       * @param[in] l The left operand.
+       * @param[in] r The right operand.
+       * @retval true Both sets have the same members.
+       * @retval false The sets differ in at least one member.
+       */
+      friend constexpr bool operator==(const char_set& l, const char_set& r) noexcept
+      {
+        return l.bits[0] == r.bits[0] && l.bits[1] == r.bits[1] &&
+          l.bits[2] == r.bits[2] && l.bits[3] == r.bits[3];
+      }
+
+      /**
+       * @brief Check if two sets differ.
+       * @param[in] l The left operand.
+       * @param[in] r The right operand.
+       * @retval true The sets differ in at least one member.
+       * @retval false Both sets have the same members.
+       */
+      friend constexpr bool operator!=(const char_set& l, const char_set& r) noexcept
+      {
+        return !(l == r);
       }
 
+    private:
+      std::uint64_t bits[4] = {}; /**< One bit per 8-bit character. */
+  };
+
+  /// Namespace that lists the predefined character sets used by the character class matchers
+  namespace char_class {
+    inline constexpr char_set lower_alphabet = char_set::range('a', 'z'); /**< [a-z] */
+    inline constexpr char_set upper_alphabet = char_set::range('A', 'Z'); /**< [A-Z] */
+    inline constexpr char_set alphabet = lower_alphabet | upper_alphabet; /**< [a-zA-Z] */
+    inline constexpr char_set digit = char_set::range('0', '9');          /**< [0-9] */
+    inline constexpr char_set hex_digit = digit |
+      char_set::range('a', 'f') | char_set::range('A', 'F');              /**< [0-9a-fA-F] */
+    inline constexpr char_set newline = char_set("\r\n");                 /**< [\\r\\n] */
+    inline constexpr char_set whitespace = char_set(" \t") | newline;     /**< [ \\t\\r\\n] */
+    inline constexpr char_set any = char_set::all();                      /**< [.] */
+  }
+
+  namespace impl {
     /**
-     * @brief Check if a std::string_view starts with the contents of another std::string_view.
-     * @details This routine is in lieu of a C++20 feature where it is a member function
-     * of std::string_view.
-     * @param[in] target The target of the check.
-     * @param[in] value std::string_view that is supposed to be a sub-string.
-     * @retval true `value` is the start of the `target` std::string_view.
-     * @retval false `value` is not the start of the `target` std::string_view.
+     * @brief Report a set of code points with more ranges than it can hold.
+     * @details It is deliberately not `constexpr`, so that reaching it during constant evaluation
+     * fails to compile.
      */
-    constexpr bool starts_with(const std::string_view& target, const std::string_view& value)
-    {
-      return target.size() >= value.size() && target.compare(0, value.size(), value) == 0;
-    }
+    inline void code_point_capacity_exceeded() noexcept {}
 
     /**
-     * @brief Check if a std::string_view starts with a given character.
-     * @details This routine is in lieu of a C++20 feature where it is a member function
-     * of std::string_view.
-     * @param[in] target The target of the check.
-     * @param[in] value Character to compare against.
-     * @retval true `value` is the start of the `target` std::string_view.
-     * @retval false `value` is not the start of the `target` std::string_view.
+     * @brief Compute the leading byte of the UTF-8 encoding of a code point.
+     * @param[in] cp A code point of at least U+0080.
+     * @returns The leading byte of its encoding.
      */
-    constexpr bool starts_with(const std::string_view& target, char value)
+    constexpr unsigned char utf8_lead(char32_t cp) noexcept
     {
-      return target.size() >= 1 && target[0] == value;
+      if (cp < 0x800)
+        return static_cast<unsigned char>(0xc0 | (cp >> 6));
+      if (cp < 0x10000)
+        return static_cast<unsigned char>(0xe0 | (cp >> 12));
+      return static_cast<unsigned char>(0xf0 | (cp >> 18));
     }
   }
 
-  /// Private namespace that lists default Maps
-  namespace mapper {
+  /// Namespace that holds the tokenizers of UTF-8 encoded code points
+  namespace utf8 {
     /**
-     * @brief Define a no-op callable object that can be invoked on a token.
-     * @param[in] token A view into the string representing the token.
+     * @brief A set of Unicode code points stored as a bitmap of ASCII characters and a list of ranges.
+     * @details ASCII members are tested with a single table lookup, other code points against up
+     * to `max_ranges` inclusive ranges. Exceeding them fails to compile in a constant expression;
+     * at run time, the extra ranges are dropped.
      */
-    constexpr void none(Token_view token) noexcept {}
-  }
+    class code_point_set {
+      public:
+        static constexpr std::size_t max_ranges = 32; /**< Most ranges of non-ASCII code points. */
 
-  /**
-   * @brief Create a tokenizer that matches lower and upper case alphabets.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches an alphabet [a-zA-Z] as a token.
-   */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto alphabet(Map&& func = mapper::none) noexcept
-    {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
-          }, func);
-    }
+        /**
+         * @brief Create an empty set.
+         */
+        constexpr code_point_set() noexcept = default;
 
-  /**
-   * @brief Create a tokenizer that matches only lower case alphabets.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches a lower case alphabet [a-z] as a token.
-   */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto lower_alphabet(Map&& func = mapper::none) noexcept
-    {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return c >= 'a' && c <= 'z';
-          }, func);
-    }
+        /**
+         * @brief Create a set holding an inclusive range of code points.
+         * @param[in] first The first code point of the range.
+         * @param[in] last The last code point of the range.
+         * @returns A set containing all code points in [first, last]. It is empty if `first > last`.
+         */
+        static constexpr code_point_set range(char32_t first, char32_t last) noexcept
+        {
+          code_point_set set;
+          set.insert(first, last);
+          return set;
+        }
 
-  /**
-   * @brief Create a tokenizer that matches only upper case alphabets.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches an upper case alphabet [A-Z] as a token.
-   */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto upper_alphabet(Map&& func = mapper::none) noexcept
-    {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return c >= 'A' && c <= 'Z';
-          }, func);
-    }
+        /**
+         * @brief Add an inclusive range of code points to the set.
+         * @param[in] first The first code point of the range.
+         * @param[in] last The last code point of the range.
+         */
+        constexpr void insert(char32_t first, char32_t last) noexcept
+        {
+          if (last > 0x10ffff)
+            last = 0x10ffff;
+          for (; first <= last && first < 0x80; first++)
+            ascii_members.insert(static_cast<char>(first));
+          if (first > last)
+            return;
+          if (ranges == max_ranges) {
+            impl::code_point_capacity_exceeded();
+            return;
+          }
+          firsts[ranges] = first;
+          lasts[ranges] = last;
+          ranges++;
+        }
 
-  /**
-   * @brief Create a tokenizer that matches only decimal digits.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches a decimal digit [0-9] as a token.
-   */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto digit(Map&& func = mapper::none) noexcept
+        /**
+         * @brief Check if a code point is a member of the set.
+         * @param[in] cp Code point to be checked.
+         * @retval true `cp` is a member of the set.
+         * @retval false `cp` is not a member of the set.
+         */
+        constexpr bool contains(char32_t cp) const noexcept
+        {
+          if (cp < 0x80)
+            return ascii_members.contains(static_cast<char>(cp));
+          for (std::size_t i = 0; i < ranges; i++)
+            if (firsts[i] <= cp && cp <= lasts[i])
+              return true;
+          return false;
+        }
+
+        /**
+         * @brief Access the ASCII members of the set.
+         * @returns The members below U+0080, as characters.
+         */
+        constexpr const char_set& ascii() const noexcept
+        {
+          return ascii_members;
+        }
+
+        /**
+         * @brief Compute the bytes the encoding of a member can start with.
+         * @returns The ASCII members and the leading bytes of the other members.
+         */
+        constexpr char_set leading_bytes() const noexcept
+        {
+          auto set = ascii_members;
+          for (std::size_t i = 0; i < ranges; i++)
+            set = set | char_set::range(static_cast<char>(impl::utf8_lead(firsts[i])),
+                static_cast<char>(impl::utf8_lead(lasts[i])));
+          return set;
+        }
+
+        /**
+         * @brief Compute the union of two sets.
+         * @param[in] l The left operand.
+         * @param[in] r The right operand.
+         * @returns A set containing code points that are in either `l` or `r`.
+         */
+        friend constexpr code_point_set operator|(const code_point_set& l, const code_point_set& r) noexcept
+        {
+          auto set = l;
+          set.ascii_members = set.ascii_members | r.ascii_members;
+          for (std::size_t i = 0; i < r.ranges; i++)
+            set.insert(r.firsts[i], r.lasts[i]);
+          return set;
+        }
+
+      private:
+        char_set ascii_members;             /**< Members below U+0080. */
+        char32_t firsts[max_ranges] = {};   /**< First code point of each range of other members. */
+        char32_t lasts[max_ranges] = {};    /**< Last code point of each range of other members. */
+        std::size_t ranges = 0;             /**< Number of ranges of other members. */
+    };
+
+    /**
+     * @brief Build the set of letters.
+     * @returns ASCII letters and the letters of the Latin, Greek, Cyrillic, Armenian, Hebrew,
+     * Arabic and Thai scripts, kana, CJK ideographs and Hangul syllables, by block.
+     */
+    constexpr code_point_set make_letters() noexcept
     {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return c >= '0' && c <= '9';
-          }, func);
+      constexpr char32_t blocks[][2] = {
+        {'A', 'Z'}, {'a', 'z'}, {0xaa, 0xaa}, {0xb5, 0xb5}, {0xba, 0xba}, {0xc0, 0xd6}, {0xd8, 0xf6},
+        {0xf8, 0x2c1}, {0x370, 0x373}, {0x376, 0x377}, {0x37b, 0x37d}, {0x386, 0x386}, {0x388, 0x3ff},
+        {0x400, 0x481}, {0x48a, 0x52f}, {0x531, 0x556}, {0x561, 0x587}, {0x5d0, 0x5ea}, {0x620, 0x64a},
+        {0xe01, 0xe30}, {0x1e00, 0x1fbc}, {0x3041, 0x3096}, {0x30a1, 0x30fa}, {0x4e00, 0x9fff},
+        {0xac00, 0xd7a3}
+      };
+      code_point_set set;
+      for (const auto& block : blocks)
+        set.insert(block[0], block[1]);
+      return set;
     }
 
+    inline constexpr code_point_set letters = make_letters();                  /**< Letters of common scripts */
+    inline constexpr code_point_set any = code_point_set::range(0, 0x10ffff); /**< Every code point */
+  }
+
   /**
-   * @brief Create a tokenizer that matches only hexadecimal digits.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches a hexadecimal digit [a-fA-F0-9] as a token.
+   * @brief Describe the inputs a tokenizer can succeed on, based on their first character.
+   * @details This is the FIRST set of the tokenizer. Alternation uses it to skip branches
+   * that cannot match the next character of the input.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto hex_digit(Map&& func = mapper::none) noexcept
-    {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
-          }, func);
-    }
+  struct first_set {
+    char_set chars;         /**< Characters a non-empty match can start with. */
+    bool nullable = false;  /**< `true` if the tokenizer can succeed without consuming input. */
+  };
 
   /**
-   * @brief Create a tokenizer that matches whitespace.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches a whitespace [ \\t\\r\\n] as a token.
+   * @brief Bounds on the number of characters a tokenizer consumes when it matches.
+   * @details Sequences and repetitions use the lower bound to fail without trying their parts
+   * when too little input is left.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto whitespace(Map&& func = mapper::none) noexcept
-    {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
-          }, func);
-    }
+  struct match_width {
+    std::size_t min = 0;                                /**< Fewest characters of a match. */
+    std::size_t max = static_cast<std::size_t>(-1);     /**< Most characters of a match, `Tok::impl::unbounded` for no limit. */
+  };
 
   /**
-   * @brief Create a tokenizer that matches any 8-bit character.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches an 8-bit character [.] as a token.
+   * @brief Outcome of resumable matching over input that may be incomplete.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto any(Map&& func = mapper::none) noexcept
-    {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return true;
-          }, func);
-    }
+  enum class match_status {
+    matched,      /**< The tokenizer matched. */
+    mismatched,   /**< The tokenizer cannot match, no matter what input follows. */
+    incomplete    /**< The input ran out before the tokenizer could decide. */
+  };
 
   /**
-   * @brief Create a tokenizer that matches a newline character.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches a newline characters [\\r\\n] as a token.
+   * @brief A token emitted by a lexer, as a position in the input instead of a view.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto newline(Map&& func = mapper::none) noexcept
-    {
-      return impl::single_char_tokenizer(
-          [](char c) -> bool {
-            return c == '\r' || c == '\n';
-          }, func);
-    }
+  struct token_record {
+    std::size_t id;       /**< Identifier of the rule that matched. */
+    std::size_t offset;   /**< Offset of the token from the start of the input. */
+    std::size_t length;   /**< Number of characters in the token. */
+  };
 
   /**
-   * @brief Create a tokenizer to match a character.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] c Character to be matched.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches the character specified, as a token.
+   * @brief Storage of a `Tok::token_buffer`, as one array per field of the tokens.
+   * @tparam N Number of tokens.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto char_token(char c, Map&& func = mapper::none) noexcept
-    {
-      VALIDATE_MAP_TYPE(Map);
-      return impl::single_char_tokenizer(
-          [c](char ch) -> bool {
-            return c == ch;
-          }, func);
-    }
+  template<std::size_t N>
+    struct token_arena {
+      std::uint32_t offsets[N];  /**< Offsets of the tokens from the start of the input. */
+      std::uint32_t lengths[N];  /**< Numbers of characters in the tokens. */
+      std::uint16_t ids[N];      /**< Identifiers of the rules that matched the tokens. */
+    };
 
   /**
-   * @brief Create a tokenizer to match a literal string pointed to by 'str'.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] str A view into the string that needs to be extracted into a token.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches the given string as a token.
+   * @brief A compact sink of tokens, stored as parallel arrays in a caller-supplied arena.
+   * @details Each token takes 10 bytes: a 32-bit offset from the start of the input, a 32-bit
+   * length and a 16-bit rule identifier, instead of the 16 bytes of a `Tok::Token_view` or the 24
+   * of a `Tok::token_record`. The buffer can be passed as the sink of a lexer, or filled from a
+   * lazy range of tokens. Clearing it frees nothing, so the arena can be reused for every input.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto str_token(Predicate str, Map&& func = mapper::none) noexcept
-    {
-      VALIDATE_MAP_TYPE(Map);
-      return [=, func = std::forward<Map>(func)](Input& input) -> Token {
-        if (!impl::starts_with(input, str))
-          return {};
-        func(str);
-        input.remove_prefix(str.size());
-        return {str};
-      };
-    }
+  class token_buffer {
+    public:
+      /**
+       * @brief Create a buffer over an arena.
+       * @tparam N Number of tokens.
+       * @param[in] arena The arrays. They must outlive the buffer.
+       */
+      template<std::size_t N>
+        explicit token_buffer(token_arena<N>& arena) noexcept :
+          token_buffer(arena.offsets, arena.lengths, arena.ids, N)
+        {}
+
+      /**
+       * @brief Create a buffer over separate arrays.
+       * @param[in] offsets Receives the offsets of the tokens.
+       * @param[in] lengths Receives the lengths of the tokens.
+       * @param[in] ids Receives the rule identifiers of the tokens.
+       * @param[in] capacity Number of tokens each array can hold. The arrays must outlive the buffer.
+       */
+      token_buffer(std::uint32_t* offsets, std::uint32_t* lengths, std::uint16_t* ids, std::size_t capacity) noexcept :
+        offset_slots(offsets), length_slots(lengths), id_slots(ids), capacity(capacity)
+      {}
+
+      /**
+       * @brief Append a token.
+       * @details Tokens that do not fit, or whose fields do not fit their arrays, are dropped and
+       * the buffer is marked as overflowed.
+       * @param[in] id Identifier of the rule that matched the token.
+       * @param[in] offset Offset of the token from the start of the input.
+       * @param[in] length Number of characters in the token.
+       */
+      void append(std::size_t id, std::size_t offset, std::size_t length) noexcept
+      {
+        if (count == capacity || id > max_id || (offset | length) > max_position) {
+          full = true;
+          return;
+        }
+        offset_slots[count] = static_cast<std::uint32_t>(offset);
+        length_slots[count] = static_cast<std::uint32_t>(length);
+        id_slots[count] = static_cast<std::uint16_t>(id);
+        count++;
+      }
+
+      /**
+       * @brief Append a token emitted by a lexer.
+       * @param[in] token The token.
+       */
+      void operator()(token_record token) noexcept
+      {
+        append(token.id, token.offset, token.length);
+      }
+
+      /**
+       * @brief Count the tokens.
+       * @returns Number of tokens appended and not dropped.
+       */
+      std::size_t size() const noexcept
+      {
+        return count;
+      }
+
+      /**
+       * @brief Access a token.
+       * @param[in] i Index of the token, less than `size()`.
+       * @returns The token.
+       */
+      token_record operator[](std::size_t i) const noexcept
+      {
+        return {id_slots[i], offset_slots[i], length_slots[i]};
+      }
+
+      /**
+       * @brief View a token in the input it was extracted from.
+       * @param[in] i Index of the token, less than `size()`.
+       * @param[in] input The input, from the position the offsets are counted from.
+       * @returns A view into the input.
+       */
+      Token_view view(std::size_t i, Input input) const noexcept
+      {
+        return input.substr(offset_slots[i], length_slots[i]);
+      }
+
+      /**
+       * @brief Access the offsets of the tokens, e.g. to scan them without touching the other fields.
+       * @returns The first of `size()` offsets.
+       */
+      const std::uint32_t* offsets() const noexcept
+      {
+        return offset_slots;
+      }
+
+      /**
+       * @brief Access the lengths of the tokens.
+       * @returns The first of `size()` lengths.
+       */
+      const std::uint32_t* lengths() const noexcept
+      {
+        return length_slots;
+      }
+
+      /**
+       * @brief Access the rule identifiers of the tokens.
+       * @returns The first of `size()` identifiers.
+       */
+      const std::uint16_t* ids() const noexcept
+      {
+        return id_slots;
+      }
+
+      /**
+       * @brief Check if tokens were dropped.
+       * @retval true Some tokens did not fit since the buffer was last cleared.
+       * @retval false Every token fit.
+       */
+      bool overflowed() const noexcept
+      {
+        return full;
+      }
+
+      /**
+       * @brief Drop every token and reset the overflow flag, keeping the arena.
+       */
+      void clear() noexcept
+      {
+        count = 0;
+        full = false;
+      }
+
+    private:
+      static constexpr std::size_t max_id = UINT16_MAX;        /**< Largest rule identifier that fits. */
+      static constexpr std::size_t max_position = UINT32_MAX;  /**< Largest offset or length that fits. */
+
+      std::uint32_t* offset_slots;  /**< Offsets of the tokens. */
+      std::uint32_t* length_slots;  /**< Lengths of the tokens. */
+      std::uint16_t* id_slots;      /**< Rule identifiers of the tokens. */
+      std::size_t capacity;         /**< Number of tokens each array can hold. */
+      std::size_t count = 0;        /**< Number of tokens. */
+      bool full = false;            /**< `true` if tokens were dropped. */
+  };
 
   /**
-   * @brief Create a tokenizer that matches a single character out of the group of characters provided.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] char_group A view into the group of characters that could be matched.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches any of the characters (only one) in the group as a token.
+   * @brief A slot of a `Tok::memo_cache`, holding the outcome of one rule at one position.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto any_of(Predicate char_group, Map&& func = mapper::none) noexcept
-    {
-      VALIDATE_MAP_TYPE(Map);
-      return [=, func = std::forward<Map>(func)](Input& input) -> Token {
-        for (const auto& c : char_group)
-          if (impl::starts_with(input, c)) {
-            const Token_view token(input.substr(0, 1));
-            func(token);
-            input.remove_prefix(1);
-            return {token};
-          }
-        return {};
-      };
-    }
+  struct memo_entry {
+    std::size_t rule = 0;             /**< Identifier of the rule, 0 for an empty slot. */
+    const char* position = nullptr;   /**< Start of the input the rule was applied to. */
+    std::size_t remaining = 0;        /**< Size of the input the rule was applied to. */
+    std::size_t size = 0;             /**< Size of the token on a match. */
+    bool matched = false;             /**< `true` if the rule matched. */
+  };
 
   /**
-   * @brief Create a tokenizer that will match a character **not** in the group of characters provided.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] char_group A view into the group of characters that will not be matched.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches a character **not** in the group of characters, as a token.
+   * @brief A packrat cache of the outcomes of memoized rules, stored in a caller-supplied arena.
+   * @details The cache is an open addressing hash table keyed on the rule and the input it was
+   * applied to. When the probed slots are all taken, the outcome in the first of them is
+   * overwritten, whatever its age, so the arena bounds the memory used rather than the size of
+   * the input.
    */
-  template<typename Map = decltype(mapper::none)>
-    constexpr auto none_of(Predicate char_group, Map&& func = mapper::none) noexcept
-    {
+  class memo_cache {
+    public:
+      /**
+       * @brief Create a cache over an array of slots.
+       * @tparam N Number of slots.
+       * @param[in] arena The slots. They must outlive the cache.
+       */
+      template<std::size_t N>
+        explicit memo_cache(memo_entry (&arena)[N]) noexcept : memo_cache(arena, N)
+        {}
+
+      /**
+       * @brief Create a cache over a range of slots.
+       * @param[in] arena The first slot. The slots must outlive the cache.
+       * @param[in] capacity Number of slots.
+       */
+      memo_cache(memo_entry* arena, std::size_t capacity) noexcept : slots(arena), capacity(capacity)
+      {
+        clear();
+      }
+
+      /**
+       * @brief Forget every outcome, e.g. before parsing another input.
+       * @details The identifiers handed out to rules stay valid.
+       */
+      void clear() noexcept
+      {
+        for (std::size_t i = 0; i < capacity; i++)
+          slots[i] = {};
+        lookups = 0;
+        found = 0;
+      }
+
+      /**
+       * @brief Hand out an identifier to a new rule.
+       * @details Identifiers are odd. The even one following each is reserved for the rule as
+       * rewritten by `Tok::skip`, see `skipped_rule()`.
+       * @returns An identifier that no other rule of this cache has.
+       */
+      std::size_t new_rule() noexcept
+      {
+        rules += 2;
+        return rules - 1;
+      }
+
+      /**
+       * @brief Find the identifier of a rule once `Tok::skip` put a skipper between its elements.
+       * @details Copies of a rule keep sharing outcomes after the rewrite, and never share them
+       * with the rule as it was.
+       * @param[in] rule Identifier handed out by `new_rule()`.
+       * @returns The identifier reserved for the rewritten rule.
+       */
+      static constexpr std::size_t skipped_rule(std::size_t rule) noexcept
+      {
+        return rule + 1;
+      }
+
+      /**
+       * @brief Look up the outcome of a rule.
+       * @param[in] rule Identifier of the rule.
+       * @param[in] input The input the rule is applied to.
+       * @returns The slot holding the outcome or `nullptr` if it is unknown.
+       */
+      const memo_entry* find(std::size_t rule, Input input) noexcept
+      {
+        if (capacity == 0)
+          return nullptr;
+        lookups++;
+        for (std::size_t i = 0, slot = home(rule, input); i < probes && i < capacity; i++, slot = next(slot)) {
+          const auto& entry = slots[slot];
+          if (entry.rule == 0)
+            return nullptr;
+          if (entry.rule == rule && entry.position == input.data() && entry.remaining == input.size()) {
+            found++;
+            return &entry;
+          }
+        }
+        return nullptr;
+      }
+
+      /**
+       * @brief Record the outcome of a rule.
+       * @param[in] rule Identifier of the rule.
+       * @param[in] input The input the rule was applied to.
+       * @param[in] token The token extracted by the rule.
+       */
+      void store(std::size_t rule, Input input, const Token& token) noexcept
+      {
+        if (capacity == 0)
+          return;
+        auto slot = home(rule, input);
+        for (std::size_t i = 0; i < probes && i < capacity && slots[slot].rule != 0; i++)
+          slot = next(slot);
+        if (slots[slot].rule != 0)
+          slot = home(rule, input);
+        slots[slot] = {rule, input.data(), input.size(), token ? (*token).size() : 0, token.has_value()};
+      }
+
+      /**
+       * @brief Count the lookups that found an outcome since the cache was last cleared.
+       * @returns Number of hits.
+       */
+      std::size_t hits() const noexcept
+      {
+        return found;
+      }
+
+      /**
+       * @brief Count the lookups since the cache was last cleared.
+       * @returns Number of lookups.
+       */
+      std::size_t attempts() const noexcept
+      {
+        return lookups;
+      }
+
+    private:
+      static constexpr std::size_t probes = 4;  /**< Most slots probed for a key. */
+
+      /**
+       * @brief Compute the first slot probed for a key.
+       * @param[in] rule Identifier of the rule.
+       * @param[in] input The input the rule is applied to.
+       * @returns Index of the slot.
+       */
+      std::size_t home(std::size_t rule, Input input) const noexcept
+      {
+        auto key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(input.data()));
+        key = (key ^ (static_cast<std::uint64_t>(rule) << 48) ^ input.size()) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>((key >> 32) % capacity);
+      }
+
+      /**
+       * @brief Compute the slot probed after another one.
+       * @param[in] slot Index of a slot.
+       * @returns Index of the following slot.
+       */
+      std::size_t next(std::size_t slot) const noexcept
+      {
+        return slot + 1 == capacity ? 0 : slot + 1;
+      }
+
+      memo_entry* slots;        /**< The arena. */
+      std::size_t capacity;     /**< Number of slots. */
+      std::size_t rules = 0;    /**< Largest identifier reserved. */
+      std::size_t lookups = 0;  /**< Number of lookups. */
+      std::size_t found = 0;    /**< Number of lookups that found an outcome. */
+  };
+
+  /**
+   * @brief A slot of a `Tok::map_log`, holding one deferred call of a Map.
+   */
+  struct map_record {
+    void (*invoke)(const void* map, Token_view token) = nullptr;  /**< Calls the Map on the token. */
+    const void* map = nullptr;                                     /**< The Map. */
+    Token_view token;                                              /**< The token the Map is called on. */
+  };
+
+  /**
+   * @brief A log of deferred Map calls, stored in a caller-supplied arena.
+   * @details Within `Tok::transaction`, Maps wrapped with `Tok::defer` append a record instead
+   * of running. Sequences and repetitions that fail drop the records appended since they started,
+   * and the transaction runs the remaining ones, in order, once the whole tokenizer succeeded.
+   */
+  class map_log {
+    public:
+      /**
+       * @brief Create a log over an array of slots.
+       * @tparam N Number of slots.
+       * @param[in] arena The slots. They must outlive the log.
+       */
+      template<std::size_t N>
+        explicit map_log(map_record (&arena)[N]) noexcept : map_log(arena, N)
+        {}
+
+      /**
+       * @brief Create a log over a range of slots.
+       * @param[in] arena The first slot. The slots must outlive the log.
+       * @param[in] capacity Number of slots.
+       */
+      map_log(map_record* arena, std::size_t capacity) noexcept : slots(arena), capacity(capacity)
+      {}
+
+      /**
+       * @brief Append a deferred call.
+       * @details Calls that do not fit are dropped and the log is marked as overflowed.
+       * @param[in] record The call.
+       */
+      void append(const map_record& record) noexcept
+      {
+        if (count == capacity) {
+          full = true;
+          return;
+        }
+        slots[count++] = record;
+      }
+
+      /**
+       * @brief Count the pending calls.
+       * @returns Number of calls appended and neither run nor dropped.
+       */
+      std::size_t size() const noexcept
+      {
+        return count;
+      }
+
+      /**
+       * @brief Drop the calls appended after a point.
+       * @param[in] mark Number of calls to keep.
+       */
+      void rollback(std::size_t mark) noexcept
+      {
+        count = mark < count ? mark : count;
+      }
+
+      /**
+       * @brief Run the calls appended after a point, in order, and remove them.
+       * @param[in] mark Number of calls to keep pending.
+       */
+      void commit(std::size_t mark = 0) noexcept
+      {
+        for (std::size_t i = mark; i < count; i++)
+          slots[i].invoke(slots[i].map, slots[i].token);
+        rollback(mark);
+      }
+
+      /**
+       * @brief Check if calls were dropped for lack of room.
+       * @retval true Some calls did not fit since the log was last cleared.
+       * @retval false Every call fit.
+       */
+      bool overflowed() const noexcept
+      {
+        return full;
+      }
+
+      /**
+       * @brief Drop every pending call and reset the overflow flag.
+       */
+      void clear() noexcept
+      {
+        count = 0;
+        full = false;
+      }
+
+    private:
+      map_record* slots;      /**< The arena. */
+      std::size_t capacity;   /**< Number of slots. */
+      std::size_t count = 0;  /**< Number of pending calls. */
+      bool full = false;      /**< `true` if calls were dropped. */
+  };
+
+  /**
+   * @brief Counters of a node of a tokenizer, filled in by `Tok::profiled` if `LEXTOK_PROFILE` is defined.
+   * @details Backtracks and branches are counted for the innermost profiled node they happen in.
+   * A profile must not be shared by threads running at the same time.
+   */
+  struct profile {
+    const char* name = "";        /**< Name of the node in reports. */
+    std::size_t invocations = 0;  /**< Number of times the node was applied. */
+    std::size_t matches = 0;      /**< Number of times the node matched. */
+    std::size_t bytes = 0;        /**< Characters consumed by the matches. */
+    std::size_t backtracks = 0;   /**< Sequences inside the node that rewound after their first part matched. */
+    std::size_t branches = 0;     /**< Branches of alternations inside the node that were tried. */
+    std::uint64_t cycles = 0;     /**< CPU cycles spent in the node, if `LEXTOK_PROFILE_CYCLES` is defined. */
+
+    /**
+     * @brief Reset the counters, keeping the name.
+     */
+    constexpr void reset() noexcept
+    {
+      *this = profile{name};
+    }
+  };
+
+  /**
+   * @brief The furthest failure of a tokenizer, filled in by `Tok::diagnose` if
+   * `LEXTOK_TRACK_FAILURES` is defined.
+   * @details Every sequence whose part fails and every alternation whose branches all fail
+   * report the position they stopped at. Only the furthest position is kept, and the expectations
+   * of the tokenizers failing there are joined.
+   */
+  struct failure {
+    bool failed = false;          /**< `true` if the tokenizer did not match. */
+    std::size_t offset = 0;       /**< Offset of the furthest failure from the start of the input. */
+    char_set expected = {};       /**< Characters that could have continued the match there. */
+    const char* name = nullptr;   /**< Name given with `Tok::named` to a tokenizer expected there, if any. */
+
+    /**
+     * @brief Forget the failure.
+     */
+    constexpr void reset() noexcept
+    {
+      *this = failure{};
+    }
+  };
+
+  /**
+   * @brief Hit counters and evaluation order of a `Tok::adaptive_alt`, which may be shared by threads.
+   * @details One match in `sample_rate` is counted for the branch that made it. After every
+   * `reorder_period` counted matches, the branches are sorted by their counts, most frequent
+   * first, and the counts are halved so that older matches weigh less. Counters and order are
+   * atomic, so the threads applying the same adaptive alternation can share its statistics; a
+   * thread always sees a complete order, if not the newest one.
+   */
+  class branch_stats {
+    public:
+      static constexpr std::size_t max_branches = 16;       /**< Most branches of an adaptive alternation. */
+      static constexpr std::uint32_t sample_rate = 8;       /**< One match in this many is counted, a power of 2. */
+      static constexpr std::uint32_t reorder_period = 64;   /**< Counted matches between two reorderings. */
+
+      static_assert((sample_rate & (sample_rate - 1)) == 0, "The sample rate must be a power of 2");
+
+      /**
+       * @brief Create statistics that try the branches in the order they are listed.
+       */
+      branch_stats() noexcept
+      {
+        reset();
+      }
+
+      branch_stats(const branch_stats&) = delete;
+      branch_stats& operator=(const branch_stats&) = delete;
+
+      /**
+       * @brief Forget the counts and go back to trying the branches in the order they are listed.
+       * @details It must not run while the statistics are being used by other threads.
+       */
+      void reset() noexcept
+      {
+        std::uint64_t identity = 0;
+        for (std::size_t i = 0; i < max_branches; i++) {
+          identity |= std::uint64_t{i} << (4 * i);
+          counts[i].store(0, std::memory_order_relaxed);
+        }
+        packed.store(identity, std::memory_order_relaxed);
+        counted.store(0, std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Find the branch tried at a rank.
+       * @param[in] rank 0 for the branch tried first, less than the number of branches.
+       * @returns The index of the branch in the list it was created from.
+       */
+      std::size_t branch(std::size_t rank) const noexcept
+      {
+        return static_cast<std::size_t>((order() >> (4 * rank)) & 0xf);
+      }
+
+      /**
+       * @brief Read the count of a branch.
+       * @param[in] index Index of the branch in the list it was created from.
+       * @returns The sampled matches of the branch since the last reordering, plus half the ones before.
+       */
+      std::uint32_t hits(std::size_t index) const noexcept
+      {
+        return counts[index].load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Read the evaluation order.
+       * @returns The index of the branch tried at rank `r` in bits `4 * r` to `4 * r + 3`.
+       */
+      std::uint64_t order() const noexcept
+      {
+        return packed.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Count a sampled match and reorder the branches once per period.
+       * @param[in] index Index of the branch that matched.
+       * @param[in] branches Number of branches.
+       */
+      void record(std::size_t index, std::size_t branches) noexcept
+      {
+        counts[index].fetch_add(1, std::memory_order_relaxed);
+        if (counted.fetch_add(1, std::memory_order_relaxed) + 1 != reorder_period)
+          return;
+        std::uint32_t snapshot[max_branches];
+        std::size_t ranked[max_branches];
+        for (std::size_t i = 0; i < branches; i++) {
+          snapshot[i] = counts[i].load(std::memory_order_relaxed);
+          std::size_t j = i;
+          for (; j > 0 && snapshot[ranked[j - 1]] < snapshot[i]; j--)
+            ranked[j] = ranked[j - 1];
+          ranked[j] = i;
+        }
+        std::uint64_t sorted = 0;
+        for (std::size_t r = 0; r < branches; r++) {
+          sorted |= std::uint64_t{ranked[r]} << (4 * r);
+          counts[r].store(snapshot[r] / 2, std::memory_order_relaxed);
+        }
+        packed.store(sorted, std::memory_order_relaxed);
+        counted.store(0, std::memory_order_relaxed);
+      }
+
+    private:
+      std::atomic<std::uint64_t> packed{0};                 /**< Index of the branch tried at each rank, 4 bits each. */
+      std::atomic<std::uint32_t> counts[max_branches] = {}; /**< Sampled matches of each branch. */
+      std::atomic<std::uint32_t> counted{0};                /**< Counted matches since the last reordering. */
+  };
+
+#if defined(LEXTOK_PROFILE)
+  /**
+   * @brief Print a table of profiles.
+   * @details Only declared when `LEXTOK_PROFILE` is defined.
+   * @param[in] out The stream written to, e.g. `stderr`.
+   * @param[in] profiles The profiles, one row each.
+   */
+  inline void write_profile(std::FILE* out, std::initializer_list<const profile*> profiles)
+  {
+    std::fprintf(out, "%-24s %12s %12s %14s %12s %12s %16s\n", "node", "invocations", "matches", "bytes",
+        "backtracks", "branches", "cycles");
+    for (const auto* p : profiles)
+      std::fprintf(out, "%-24s %12zu %12zu %14zu %12zu %12zu %16llu\n", p->name, p->invocations, p->matches,
+          p->bytes, p->backtracks, p->branches, static_cast<unsigned long long>(p->cycles));
+  }
+#endif
+
+  /// Private namespace that lists default Maps
+  namespace mapper {
+    /**
+     * @brief Define a no-op callable type that can be invoked on a token.
+     * @details Being a distinct type, it lets combinators detect at compile time that
+     * no Map was supplied and skip the per-token protocol altogether.
+     */
+    struct none_t {
+      /**
+       * @brief Do nothing with the token.
+       * @param[in] token A view into the string representing the token.
+       */
+      constexpr void operator()(Token_view token) const noexcept {}
+
+      /**
+       * @brief Do nothing with the token and the index of the rule that matched it.
+       * @param[in] index Index of the rule that matched the token.
+       * @param[in] token A view into the string representing the token.
+       */
+      constexpr void operator()(std::size_t index, Token_view token) const noexcept {}
+    };
+
+    inline constexpr none_t none{}; /**< A no-op callable object that can be invoked on a token. */
+  }
+
+  /// Private namespace that holds implementation details
+  namespace impl {
+    inline thread_local map_log* active_log = nullptr; /**< Log of the innermost running transaction. */
+    inline thread_local std::uint32_t sample_clock = 0; /**< Matches of adaptive alternations by this thread. */
+
+#if defined(LEXTOK_PROFILE)
+    inline thread_local profile* active_profile = nullptr; /**< Profile of the innermost running profiled node. */
+
+    /**
+     * @brief Count an event in the profile of the innermost running profiled node.
+     * @details Nothing is counted during constant evaluation.
+     * @param[in] counter The counter of the event.
+     */
+    constexpr void count_event(std::size_t profile::* counter) noexcept
+    {
+      if (!LEXTOK_CONSTANT_EVALUATED() && active_profile)
+        ++(active_profile->*counter);
+    }
+#endif
+
+#if defined(LEXTOK_TRACK_FAILURES)
+    inline thread_local failure* active_failure = nullptr; /**< Failure of the innermost running diagnosed tokenizer. */
+    inline thread_local const char* failure_base = nullptr; /**< Start of the input of that tokenizer. */
+#endif
+
+    /**
+     * @brief Check if failures are being recorded.
+     * @details Nothing is recorded during constant evaluation, nor without `LEXTOK_TRACK_FAILURES`.
+     * Shortcuts that would skip a report are not taken while failures are recorded.
+     * @retval true A diagnosed tokenizer is running.
+     * @retval false No failure needs to be recorded.
+     */
+    constexpr bool tracking_failures() noexcept
+    {
+#if defined(LEXTOK_TRACK_FAILURES)
+      return !LEXTOK_CONSTANT_EVALUATED() && active_failure;
+#else
+      return false;
+#endif
+    }
+
+#if defined(LEXTOK_TRACK_FAILURES)
+
+    /**
+     * @brief Record a failure in the innermost running diagnosed tokenizer.
+     * @details Failures before the furthest one are ignored. At the same offset, the expected
+     * characters are joined, and a name replaces the previous one.
+     * @param[in] at The input where the failing tokenizer started.
+     * @param[in] expected Characters that could have continued the match.
+     * @param[in] name Name of the failing tokenizer, or `nullptr`.
+     */
+    inline void report_failure(Input at, const char_set& expected, const char* name = nullptr) noexcept
+    {
+      auto& furthest = *active_failure;
+      const auto offset = static_cast<std::size_t>(at.data() - failure_base);
+      if (!furthest.failed || offset > furthest.offset) {
+        furthest = {true, offset, expected, name};
+      } else if (offset == furthest.offset) {
+        furthest.expected = furthest.expected | expected;
+        if (name)
+          furthest.name = name;
+      }
+    }
+#endif
+
+    /**
+     * @brief A Map whose calls are deferred to the end of the running transaction.
+     * @details Outside of a transaction, the Map is called right away.
+     * @tparam Map A callable type `void (Tok::Token_view)`.
+     */
+    template<typename Map>
+      struct deferred_map {
+        Map func;  /**< The deferred Map. */
+
+        /**
+         * @brief Record a call of the Map, or make it if no transaction is running.
+         * @param[in] token A view into the string representing the token.
+         */
+        void operator()(Token_view token) const
+        {
+          if (!active_log) {
+            func(token);
+            return;
+          }
+          active_log->append({&invoke, &func, token});
+        }
+
+        /**
+         * @brief Call the Map of a record.
+         * @param[in] map The Map.
+         * @param[in] token A view into the string representing the token.
+         */
+        static void invoke(const void* map, Token_view token)
+        {
+          (*static_cast<const Map*>(map))(token);
+        }
+      };
+
+    /**
+     * @brief Check if a tokenizer contains deferred Maps.
+     * @details Only tokenizers that can fail after one of their parts matched need to know, so
+     * that they drop the calls recorded by that part.
+     * @tparam T The type to be checked.
+     */
+    template<typename T>
+      struct has_deferred_map : std::false_type {};
+
+    /**
+     * @brief Specialization for deferred Maps.
+     * @tparam Map The deferred Map.
+     */
+    template<typename Map>
+      struct has_deferred_map<deferred_map<Map>> : std::true_type {};
+
+    /**
+     * @brief Specialization for tokenizers made of other types, e.g. `Tok::impl::sequence`.
+     * @tparam Node The template of the tokenizer.
+     * @tparam Parts The Maps and tokenizers it is made of.
+     */
+    template<template<typename...> class Node, typename... Parts>
+      struct has_deferred_map<Node<Parts...>> : std::bool_constant<(has_deferred_map<Parts>::value || ...)> {};
+
+    /**
+     * @brief Mark the calls recorded so far by the running transaction.
+     * @returns Number of calls recorded, 0 outside of a transaction.
+     */
+    inline std::size_t log_mark() noexcept
+    {
+      return active_log ? active_log->size() : 0;
+    }
+
+    /**
+     * @brief Drop the calls recorded by the running transaction after a mark.
+     * @param[in] mark A mark returned by `Tok::impl::log_mark`.
+     */
+    inline void log_rollback(std::size_t mark) noexcept
+    {
+      if (active_log)
+        active_log->rollback(mark);
+    }
+
+    /**
+     * @brief A tokenizer that extracts a single character token.
+     * @details Unlike a lambda, this named type carries its predicate and Map so that
+     * modifiers can recognize it and run the predicate directly over the input.
+     * @tparam Acceptor_Predicate A callable object that is of the type `bool (char c)`. It returns
+     * `true` if the character `c` satisfies the condition to be classified as a token.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Acceptor_Predicate, typename Map>
+      struct single_char {
+        Acceptor_Predicate pred;  /**< Decides if a character is an acceptable token. */
+        Map func;                 /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to extract a single character token from the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          if (input.size() == 0 || !pred(input[0]))
+            return {};
+          const Token_view token(input.substr(0, 1));
+          func(token);
+          input.remove_prefix(1);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The set of characters accepted by the predicate, if it is a `Tok::char_set`.
+         * Otherwise, every character.
+         */
+        constexpr first_set first() const noexcept
+        {
+          if constexpr (std::is_same_v<Acceptor_Predicate, char_set>)
+            return {pred, false};
+          else
+            return {char_set::all(), false};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns One character.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return fixed_width;
+        }
+
+        static constexpr match_width fixed_width = {1, 1};  /**< Widths of the matches, known from the type. */
+
+        /** No progress needs to be kept for a single character. */
+        struct state {};
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          if (input.empty())
+            return end_of_input ? match_status::mismatched : match_status::incomplete;
+          if (!pred(input[0]))
+            return match_status::mismatched;
+          func(input.substr(0, 1));
+          size = 1;
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief Attempt to extract a single character token.
+     * @details The token is extracted based on a predicate passed to specialize
+     * the function template. On a match, `func` is called on it.
+     * @tparam Acceptor_Predicate A callable object that is of the type `bool (char c)`. It returns
+     * `true` if the character `c` satisfies the condition to be classified as a token.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     * @param[in] pred A predicate that decides if a character is an acceptable token.
+     * @param[in] func A callable object to further process / map the extracted token.
+     * @returns A tokenizer of type `Tok::impl::single_char` that extracts a single character
+     * token based on the predicate.
+     */
+    template<typename Acceptor_Predicate, typename Map>
+      constexpr auto single_char_tokenizer(Acceptor_Predicate&& pred, Map&& func) noexcept
+      {
+        VALIDATE_MAP_TYPE(Map);
+        VALIDATE_ACCEPTOR_TYPE(Acceptor_Predicate);
+        return single_char<std::decay_t<Acceptor_Predicate>, std::decay_t<Map>>{
+          std::forward<Acceptor_Predicate>(pred), std::forward<Map>(func)};
+      }
+
+    /**
+     * @brief Check if a tokenizer is a Map-less single character matcher.
+     * @details Modifiers wrapping such a tokenizer run its predicate directly over the input
+     * instead of going through the per-token protocol.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct is_plain_char_matcher : std::false_type {};
+
+    /**
+     * @brief Specialization for Map-less single character matchers.
+     * @tparam Acceptor_Predicate A callable object that is of the type `bool (char c)`.
+     */
+    template<typename Acceptor_Predicate>
+      struct is_plain_char_matcher<single_char<Acceptor_Predicate, mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief `true` if `Tokenizer` (after decay) is a Map-less single character matcher.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      inline constexpr bool is_plain_char_matcher_v = is_plain_char_matcher<std::decay_t<Tokenizer>>::value;
+
+    /**
+     * @brief Compute the length of the longest prefix of the input accepted by a predicate.
+     * @tparam Acceptor_Predicate A callable object that is of the type `bool (char c)`.
+     */
+    template<typename Acceptor_Predicate>
+      struct predicate_span {
+        Acceptor_Predicate pred;  /**< Decides if a character is part of the span. */
+
+        /**
+         * @brief Compute the length of the span.
+         * @param[in] input The input to be scanned.
+         * @returns Number of leading characters of `input` accepted by the predicate.
+         */
+        constexpr std::size_t operator()(Input input) const noexcept
+        {
+          std::size_t i = 0;
+          while (i < input.size() && pred(input[i]))
+            i++;
+          return i;
+        }
+
+        /**
+         * @brief Describe the characters a span can be made up of.
+         * @returns Every character, since the predicate is opaque.
+         */
+        constexpr char_set members() const noexcept
+        {
+          return char_set::all();
+        }
+      };
+
+    /**
+     * @brief Compute the length of the longest prefix of the input made up of characters in a set.
+     * @details The lookup tables are built once, when the kernel is constructed. Matching uses
+     * the widest instruction set enabled at compile time (AVX2, SSSE3, SSE2 or NEON) and falls
+     * back to a scalar table lookup for the tail, for constant evaluation, or when
+     * `LEXTOK_NO_SIMD` is defined.
+     */
+    class span_kernel {
+      public:
+        /**
+         * @brief Build the lookup tables for a set.
+         * @param[in] members The set of characters that the span is made up of.
+         */
+        constexpr explicit span_kernel(const char_set& members) noexcept : set(members)
+        {
+          std::size_t runs = 0;
+          bool in_run = false;
+          for (unsigned c = 0; c < 256; c++) {
+            if (!members.contains(static_cast<char>(c))) {
+              in_run = false;
+              continue;
+            }
+            const auto lo = c & 0x0f;
+            const auto hi = c >> 4;
+            if (hi < 8)
+              low_rows[lo] = static_cast<unsigned char>(low_rows[lo] | (1u << hi));
+            else
+              high_rows[lo] = static_cast<unsigned char>(high_rows[lo] | (1u << (hi - 8)));
+            if (!in_run) {
+              if (runs < max_ranges)
+                range_first[runs] = static_cast<unsigned char>(c);
+              runs++;
+              in_run = true;
+            }
+            if (runs <= max_ranges)
+              range_width[runs - 1] = static_cast<unsigned char>(c - range_first[runs - 1]);
+          }
+          ranges = runs;
+        }
+
+        /**
+         * @brief Compute the length of the span.
+         * @param[in] input The input to be scanned.
+         * @returns Number of leading characters of `input` that are members of the set.
+         */
+        constexpr std::size_t operator()(Input input) const noexcept
+        {
+          std::size_t i = 0;
+#if defined(LEXTOK_SIMD)
+          if (!LEXTOK_CONSTANT_EVALUATED())
+            i = vector_span(input.data(), input.size());
+#endif
+          while (i < input.size() && set.contains(input[i]))
+            i++;
+          return i;
+        }
+
+        /**
+         * @brief Describe the characters a span can be made up of.
+         * @returns The set the kernel was built for.
+         */
+        constexpr char_set members() const noexcept
+        {
+          return set;
+        }
+
+      private:
+        static constexpr std::size_t max_ranges = 4; /**< Most ranges the SSE2 kernel compares against. */
+
+#if defined(LEXTOK_SIMD)
+        /**
+         * @brief Scan whole vector blocks of the input.
+         * @param[in] p Pointer to the start of the input.
+         * @param[in] n Size of the input.
+         * @returns Index of the first non-member found, or the number of bytes covered by whole
+         * blocks if all of them were members.
+         */
+        std::size_t vector_span(const char* p, std::size_t n) const noexcept
+        {
+          std::size_t i = 0;
+#if defined(LEXTOK_SIMD_AVX2)
+          const auto lo128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_rows));
+          const auto hi128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(high_rows));
+          const auto lows = _mm256_broadcastsi128_si256(lo128);
+          const auto highs = _mm256_broadcastsi128_si256(hi128);
+          const auto bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+              1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+          const auto index_mask = _mm256_set1_epi8(static_cast<char>(0x8f));
+          const auto high_bit = _mm256_set1_epi8(static_cast<char>(0x80));
+          const auto nibble = _mm256_set1_epi8(0x0f);
+          for (; i + 32 <= n; i += 32) {
+            const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const auto index = _mm256_and_si256(x, index_mask);
+            const auto rows = _mm256_or_si256(_mm256_shuffle_epi8(lows, index),
+                _mm256_shuffle_epi8(highs, _mm256_xor_si256(index, high_bit)));
+            const auto bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+            const auto hit = _mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), bit);
+            const auto miss = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(hit));
+            if (miss)
+              return i + static_cast<std::size_t>(__builtin_ctz(miss));
+          }
+#elif defined(LEXTOK_SIMD_SSSE3)
+          const auto lows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_rows));
+          const auto highs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(high_rows));
+          const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+          const auto index_mask = _mm_set1_epi8(static_cast<char>(0x8f));
+          const auto high_bit = _mm_set1_epi8(static_cast<char>(0x80));
+          const auto nibble = _mm_set1_epi8(0x0f);
+          for (; i + 16 <= n; i += 16) {
+            const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const auto index = _mm_and_si128(x, index_mask);
+            const auto rows = _mm_or_si128(_mm_shuffle_epi8(lows, index),
+                _mm_shuffle_epi8(highs, _mm_xor_si128(index, high_bit)));
+            const auto bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+            const auto hit = _mm_cmpeq_epi8(_mm_and_si128(rows, bit), bit);
+            const auto miss = ~static_cast<std::uint32_t>(_mm_movemask_epi8(hit)) & 0xffff;
+            if (miss)
+              return i + static_cast<std::size_t>(__builtin_ctz(miss));
+          }
+#elif defined(LEXTOK_SIMD_SSE2)
+          // Without a byte shuffle, the set is tested as a union of at most 'max_ranges' ranges.
+          if (ranges == 0 || ranges > max_ranges)
+            return 0;
+          __m128i first[max_ranges];
+          __m128i width[max_ranges];
+          for (std::size_t r = 0; r < ranges; r++) {
+            first[r] = _mm_set1_epi8(static_cast<char>(range_first[r]));
+            width[r] = _mm_set1_epi8(static_cast<char>(range_width[r]));
+          }
+          for (; i + 16 <= n; i += 16) {
+            const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            auto hit = _mm_setzero_si128();
+            for (std::size_t r = 0; r < ranges; r++) {
+              const auto d = _mm_sub_epi8(x, first[r]);
+              hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(d, width[r]), d));
+            }
+            const auto miss = ~static_cast<std::uint32_t>(_mm_movemask_epi8(hit)) & 0xffff;
+            if (miss)
+              return i + static_cast<std::size_t>(__builtin_ctz(miss));
+          }
+#elif defined(LEXTOK_SIMD_NEON)
+          const auto lows = vld1q_u8(low_rows);
+          const auto highs = vld1q_u8(high_rows);
+          static constexpr unsigned char bit_table[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+          const auto bits = vld1q_u8(bit_table);
+          const auto index_mask = vdupq_n_u8(0x8f);
+          const auto high_bit = vdupq_n_u8(0x80);
+          for (; i + 16 <= n; i += 16) {
+            const auto x = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p + i));
+            const auto index = vandq_u8(x, index_mask);
+            const auto rows = vorrq_u8(vqtbl1q_u8(lows, index), vqtbl1q_u8(highs, veorq_u8(index, high_bit)));
+            const auto hit = vtstq_u8(rows, vqtbl1q_u8(bits, vshrq_n_u8(x, 4)));
+            const auto nibbles = vshrn_n_u16(vreinterpretq_u16_u8(hit), 4);
+            const auto miss = ~vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+            if (miss)
+              return i + static_cast<std::size_t>(__builtin_ctzll(miss) >> 2);
+          }
+#endif
+          return i;
+        }
+#endif
+
+        char_set set;                               /**< Set used for the scalar path. */
+        unsigned char low_rows[16] = {};            /**< Bit 'h' of entry 'l' is set if 0xhl is a member, for h < 8. */
+        unsigned char high_rows[16] = {};           /**< Bit 'h - 8' of entry 'l' is set if 0xhl is a member, for h >= 8. */
+        unsigned char range_first[max_ranges] = {}; /**< First character of each range of members. */
+        unsigned char range_width[max_ranges] = {}; /**< Last minus first character of each range of members. */
+        std::size_t ranges = 0;                     /**< Number of ranges of members in the set. */
+    };
+
+    /**
+     * @brief Create the fastest span function for a Map-less single character matcher.
+     * @tparam Acceptor_Predicate A callable object that is of the type `bool (char c)`.
+     * @param[in] tokenizer The single character matcher.
+     * @returns A `Tok::impl::span_kernel` for matchers over a `Tok::char_set`, a
+     * `Tok::impl::predicate_span` otherwise.
+     */
+    template<typename Acceptor_Predicate>
+      constexpr auto make_span(const single_char<Acceptor_Predicate, mapper::none_t>& tokenizer) noexcept
+      {
+        if constexpr (std::is_same_v<Acceptor_Predicate, char_set>)
+          return span_kernel(tokenizer.pred);
+        else
+          return predicate_span<Acceptor_Predicate>{tokenizer.pred};
+      }
+
+    /**
+     * @brief Check if a std::string_view starts with the contents of another std::string_view.
+     * @details This routine is in lieu of a C++20 feature where it is a member function
+     * of std::string_view.
+     * @param[in] target The target of the check.
+     * @param[in] value std::string_view that is supposed to be a sub-string.
+     * @retval true `value` is the start of the `target` std::string_view.
+     * @retval false `value` is not the start of the `target` std::string_view.
+     */
+    constexpr bool starts_with(const std::string_view& target, const std::string_view& value)
+    {
+      return target.size() >= value.size() && target.compare(0, value.size(), value) == 0;
+    }
+
+    /**
+     * @brief Check if a std::string_view starts with a given character.
+     * @details This routine is in lieu of a C++20 feature where it is a member function
+     * of std::string_view.
+     * @param[in] target The target of the check.
+     * @param[in] value Character to compare against.
+     * @retval true `value` is the start of the `target` std::string_view.
+     * @retval false `value` is not the start of the `target` std::string_view.
+     */
+    constexpr bool starts_with(const std::string_view& target, char value)
+    {
+      return target.size() >= 1 && target[0] == value;
+    }
+
+    /**
+     * @brief Check if a tokenizer describes its own FIRST set.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer, typename = void>
+      struct has_first : std::false_type {};
+
+    /**
+     * @brief Specialization for tokenizers with a `first()` member function.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct has_first<Tokenizer, std::void_t<decltype(std::declval<const Tokenizer&>().first())>> : std::true_type {};
+
+    /**
+     * @brief Find the index of the lowest set bit.
+     * @param[in] mask A non-zero mask.
+     * @returns Index of the lowest set bit of `mask`.
+     */
+    constexpr std::size_t lowest_bit(std::uint64_t mask) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<std::size_t>(__builtin_ctzll(mask));
+#else
+      std::size_t i = 0;
+      for (; !(mask & 1); mask >>= 1)
+        i++;
+      return i;
+#endif
+    }
+
+    inline constexpr std::size_t unbounded = static_cast<std::size_t>(-1); /**< Repetition with no upper limit. */
+
+    /**
+     * @brief Check if a tokenizer describes a regular language that can be compiled into a DFA.
+     * @details Map-less character classes, literals and keyword sets qualify, and so do
+     * sequences, alternations, repetitions and options made up of them. Having no Maps, they
+     * can also fail without trying their parts, as nothing would be observed.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct is_regular : std::false_type {};
+
+    /**
+     * @brief Check if a tokenizer describes the widths of its matches.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer, typename = void>
+      struct has_width : std::false_type {};
+
+    /**
+     * @brief Specialization for tokenizers with a `width()` member function.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct has_width<Tokenizer, std::void_t<decltype(std::declval<const Tokenizer&>().width())>> : std::true_type {};
+
+    /**
+     * @brief Check if the widths of the matches of a tokenizer follow from its type alone.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer, typename = void>
+      struct constant_width : std::false_type {};
+
+    /**
+     * @brief Specialization for tokenizers with a `fixed_width` static member.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct constant_width<Tokenizer, std::void_t<decltype(Tokenizer::fixed_width)>> : std::true_type {
+        static constexpr match_width width = Tokenizer::fixed_width;  /**< Widths of the matches. */
+      };
+
+    /**
+     * @brief Storage for the shortest match of a node, checked before the node tries its parts.
+     * @details Nodes with Maps never check it, and nodes of constant width know it from their
+     * type, so both derive from the empty specialization instead. It is distinct for every node,
+     * so that it takes no space even where the first member of a node derives from it, too.
+     * @tparam Cached `true` if the node has to store its shortest match.
+     * @tparam Node The type of the node.
+     */
+    template<bool Cached, typename Node>
+      struct shortest_cache {
+        std::size_t shortest = 0;  /**< Fewest characters of a match. */
+      };
+
+    /**
+     * @brief Specialization for nodes that do not store their shortest match.
+     * @tparam Node The type of the node.
+     */
+    template<typename Node>
+      struct shortest_cache<false, Node> {};
+
+    /**
+     * @brief Store the shortest match of a node that has to, once it is built.
+     * @tparam Node The type of the node.
+     * @param[in,out] node The node.
+     */
+    template<typename Node>
+      constexpr void cache_shortest(Node& node) noexcept
+      {
+        if constexpr (std::is_base_of_v<shortest_cache<true, Node>, Node>)
+          node.shortest = node.width().min;
+      }
+
+    /**
+     * @brief Add two widths, saturating at `Tok::impl::unbounded`.
+     * @param[in] l The left operand.
+     * @param[in] r The right operand.
+     * @returns The sum, or `Tok::impl::unbounded` if it does not fit.
+     */
+    constexpr std::size_t saturating_add(std::size_t l, std::size_t r) noexcept
+    {
+      return l > unbounded - r ? unbounded : l + r;
+    }
+
+    /**
+     * @brief Multiply two widths, saturating at `Tok::impl::unbounded`.
+     * @param[in] l The left operand.
+     * @param[in] r The right operand.
+     * @returns The product, or `Tok::impl::unbounded` if it does not fit.
+     */
+    constexpr std::size_t saturating_mul(std::size_t l, std::size_t r) noexcept
+    {
+      return r != 0 && l > unbounded / r ? unbounded : l * r;
+    }
+  }
+
+  /**
+   * @brief Compute the FIRST set of a tokenizer.
+   * @details Tokenizers built by this library describe exactly which characters they can start
+   * with. Any other callable object (e.g. a lambda or `std::function`) is treated conservatively,
+   * as if it could start with any character or match the empty string.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns The FIRST set of `tokenizer`.
+   */
+  template<typename Tokenizer>
+    constexpr first_set first_of(const Tokenizer& tokenizer) noexcept
+    {
+      if constexpr (impl::has_first<Tokenizer>::value)
+        return tokenizer.first();
+      else
+        return {char_set::all(), true};
+    }
+
+  /**
+   * @brief Compute the widths of the matches of a tokenizer.
+   * @details Tokenizers built by this library bound the number of characters they consume. Any
+   * other callable object is treated conservatively, as if it could consume any number of them.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns The fewest and the most characters a match of `tokenizer` consumes.
+   */
+  template<typename Tokenizer>
+    constexpr match_width width_of(const Tokenizer& tokenizer) noexcept
+    {
+      if constexpr (impl::has_width<Tokenizer>::value)
+        return tokenizer.width();
+      else
+        return {};
+    }
+
+  namespace impl {
+    /**
+     * @brief Check if a tokenizer can resume a match over input that arrives in pieces.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer, typename = void>
+      struct has_resume : std::false_type {};
+
+    /**
+     * @brief Specialization for tokenizers with a `state` type and a `resume()` member function.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct has_resume<Tokenizer, std::void_t<typename Tokenizer::state,
+        decltype(std::declval<const Tokenizer&>().resume(std::declval<Input>(), std::declval<std::size_t&>(),
+              std::declval<typename Tokenizer::state&>(), true))>> : std::true_type {};
+
+    /**
+     * @brief Describe the progress kept for tokenizers that cannot resume.
+     */
+    struct opaque {
+      /** Nothing is kept, such tokenizers are re-run from their start. */
+      struct state {};
+    };
+
+    /**
+     * @brief The type holding the progress of a resumable match of a tokenizer.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      using state_of_t = typename std::conditional_t<has_resume<Tokenizer>::value, Tokenizer, opaque>::state;
+
+    /**
+     * @brief Match a tokenizer over input that may be incomplete.
+     * @details Tokenizers built by this library pick up where they ran out of input. Any other
+     * callable object is treated as atomic: it is re-run on all of its input every time, and if
+     * it succeeds its match is taken as final.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] input The input from the start of the match up to the last character received.
+     * @param[out] size Size of the token on a match.
+     * @param[in,out] progress Progress of the match so far.
+     * @param[in] end_of_input `true` if no more input will follow.
+     * @returns The outcome of the match.
+     */
+    template<typename Tokenizer>
+      constexpr match_status resume_tokenizer(const Tokenizer& tokenizer, Input input, std::size_t& size,
+          state_of_t<Tokenizer>& progress, bool end_of_input)
+      {
+        if constexpr (has_resume<Tokenizer>::value) {
+          return tokenizer.resume(input, size, progress, end_of_input);
+        } else {
+          auto rest = input;
+          if (!tokenizer(rest))
+            return end_of_input ? match_status::mismatched : match_status::incomplete;
+          size = input.size() - rest.size();
+          return match_status::matched;
+        }
+      }
+
+    /**
+     * @brief A tokenizer that matches a literal string.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Map>
+      struct literal {
+        Predicate str;  /**< The string to be matched. */
+        Map func;       /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to match the literal at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token, a view into the input, or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          if (!starts_with(input, str))
+            return {};
+          const auto token = input.substr(0, str.size());
+          func(token);
+          input.remove_prefix(str.size());
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The first character of the literal.
+         */
+        constexpr first_set first() const noexcept
+        {
+          if (str.empty())
+            return {char_set{}, true};
+          return {char_set::of(str[0]), false};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The size of the literal.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return {str.size(), str.size()};
+        }
+
+        /** A literal is compared again when more input arrives. */
+        struct state {};
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          if (input.size() < str.size())
+            return !end_of_input && str.compare(0, input.size(), input) == 0 ?
+              match_status::incomplete : match_status::mismatched;
+          if (!starts_with(input, str))
+            return match_status::mismatched;
+          size = str.size();
+          func(input.substr(0, size));
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief Fold an ASCII letter to lower case.
+     * @param[in] c The character.
+     * @returns `c` in lower case if it is an ASCII letter, `c` otherwise.
+     */
+    constexpr char fold_case(char c) noexcept
+    {
+      return c >= 'A' && c <= 'Z' ? static_cast<char>(c | 0x20) : c;
+    }
+
+    /**
+     * @brief Create a set holding both cases of a character.
+     * @param[in] c The character.
+     * @returns A set containing `c`, and its other case if it is an ASCII letter.
+     */
+    constexpr char_set both_cases(char c) noexcept
+    {
+      const auto lower = fold_case(c);
+      if (lower < 'a' || lower > 'z')
+        return char_set::of(c);
+      return char_set::of(lower) | char_set::of(static_cast<char>(lower & ~0x20));
+    }
+
+    /**
+     * @brief Load up to 8 characters into a word, the first one in the lowest byte.
+     * @details Missing characters are zero. Outside of constant evaluation, 8 characters are
+     * loaded at once.
+     * @param[in] str The characters.
+     * @param[in] from Index of the first character to load.
+     * @returns The characters `[from, from + 8)` of `str`, as far as there are any.
+     */
+    constexpr std::uint64_t load_word(Input str, std::size_t from) noexcept
+    {
+      std::uint64_t word = 0;
+#if defined(LEXTOK_CONSTANT_EVALUATED)
+      if (!LEXTOK_CONSTANT_EVALUATED() && from + 8 <= str.size()) {
+        std::memcpy(&word, str.data() + from, sizeof(word));
+#  if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#  endif
+        return word;
+      }
+#endif
+      for (std::size_t i = 0; i < 8 && from + i < str.size(); i++)
+        word |= std::uint64_t{static_cast<unsigned char>(str[from + i])} << (8 * i);
+      return word;
+    }
+
+    /**
+     * @brief Find the ASCII letters among 8 characters, without branching.
+     * @param[in] word The characters, one per byte.
+     * @returns A word with `0x20` in the bytes of `word` holding an ASCII letter, 0 elsewhere.
+     */
+    constexpr std::uint64_t letter_bits(std::uint64_t word) noexcept
+    {
+      constexpr std::uint64_t bytes = 0x0101010101010101u;
+      const auto low = (word | 0x20 * bytes) & (0x7f * bytes);
+      const auto from_a = low + (0x80 - 'a') * bytes;      // Bit 7 set from 'a' on
+      const auto past_z = low + (0x80 - 'z' - 1) * bytes;  // Bit 7 set past 'z'
+      return ((from_a & ~past_z & ~word & 0x80 * bytes) >> 2);
+    }
+
+    /**
+     * @brief Compare two strings of the same size, ignoring the case of ASCII letters.
+     * @details 8 characters are compared at a time: they differ only if some byte of their
+     * exclusive-or has a bit other than the case bit of a letter of `literal`.
+     * @param[in] input The compared characters.
+     * @param[in] literal The characters expected, as long as `input`.
+     * @param[in] from Index of the first character compared.
+     * @retval true The strings are equal, ignoring case.
+     * @retval false The strings differ.
+     */
+    constexpr bool equal_ignoring_case(Input input, Input literal, std::size_t from = 0) noexcept
+    {
+      std::uint64_t differences = 0;
+      for (std::size_t i = from; i < literal.size(); i += 8) {
+        const auto expected = load_word(literal, i);
+        differences |= (load_word(input, i) ^ expected) & ~letter_bits(expected);
+      }
+      return differences == 0;
+    }
+
+    /**
+     * @brief A tokenizer that extracts a literal string token, ignoring the case of ASCII letters.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Map>
+      struct iliteral {
+        Predicate str;  /**< The string to be matched. */
+        Map func;       /**< Further processes / maps the extracted token. */
+        std::uint64_t head = load_word(str, 0);         /**< The first 8 characters of the literal. */
+        std::uint64_t ignored = letter_bits(head) |
+          (str.size() >= 8 ? 0 : ~std::uint64_t{0} << (8 * str.size())); /**< Bits of `head` not compared. */
+
+        /**
+         * @brief Attempt to match the literal at the start of the input.
+         * @details The first 8 characters are compared in one step, the rest 8 at a time.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token, spelled as in the input, or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          if (input.size() < str.size() || ((load_word(input, 0) ^ head) & ~ignored) ||
+              (str.size() > 8 && !equal_ignoring_case(input.substr(0, str.size()), str, 8)))
+            return {};
+          const Token_view token(input.data(), str.size());
+          func(token);
+          input.remove_prefix(str.size());
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns Both cases of the first character of the literal.
+         */
+        constexpr first_set first() const noexcept
+        {
+          if (str.empty())
+            return {char_set{}, true};
+          return {both_cases(str[0]), false};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The size of the literal.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return {str.size(), str.size()};
+        }
+
+        /** A literal is compared again when more input arrives. */
+        struct state {};
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          if (input.size() < str.size())
+            return !end_of_input && equal_ignoring_case(input, str.substr(0, input.size())) ?
+              match_status::incomplete : match_status::mismatched;
+          if (!equal_ignoring_case(input.substr(0, str.size()), str))
+            return match_status::mismatched;
+          func(input.substr(0, str.size()));
+          size = str.size();
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief Find a single delimiting character.
+     * @details The search is `std::string_view::find`, which standard libraries implement with
+     * `memchr` outside of constant evaluation.
+     */
+    struct char_finder {
+      char delimiter; /**< The delimiting character. */
+
+      /**
+       * @brief Find the first delimiter.
+       * @param[in] input The input to be searched.
+       * @param[in] from Index to start searching at.
+       * @returns Index of the first delimiter at or after `from`, `Tok::Input::npos` if there is none.
+       */
+      constexpr std::size_t find(Input input, std::size_t from) const noexcept
+      {
+        return input.find(delimiter, from);
+      }
+
+      /**
+       * @brief Describe the characters the span before a delimiter can be made up of.
+       * @returns Every character but the delimiter.
+       */
+      constexpr char_set members() const noexcept
+      {
+        return ~char_set::of(delimiter);
+      }
+
+      /**
+       * @brief Count the characters at the end of a searched input that can start a delimiter.
+       * @returns Zero, since a delimiter is a single character.
+       */
+      static constexpr std::size_t overlap() noexcept
+      {
+        return 0;
+      }
+    };
+
+    /**
+     * @brief Find any character out of a set of delimiters.
+     * @details The search runs a `Tok::impl::span_kernel` over the complement of the set.
+     */
+    struct set_finder {
+      span_kernel others; /**< Spans the characters that are not delimiters. */
+
+      /**
+       * @brief Find the first delimiter.
+       * @param[in] input The input to be searched.
+       * @param[in] from Index to start searching at.
+       * @returns Index of the first delimiter at or after `from`, `Tok::Input::npos` if there is none.
+       */
+      constexpr std::size_t find(Input input, std::size_t from) const noexcept
+      {
+        const auto i = from + others(input.substr(from));
+        return i < input.size() ? i : Input::npos;
+      }
+
+      /**
+       * @brief Describe the characters the span before a delimiter can be made up of.
+       * @returns Every character but the delimiters.
+       */
+      constexpr char_set members() const noexcept
+      {
+        return others.members();
+      }
+
+      /**
+       * @brief Count the characters at the end of a searched input that can start a delimiter.
+       * @returns Zero, since every delimiter is a single character.
+       */
+      static constexpr std::size_t overlap() noexcept
+      {
+        return 0;
+      }
+    };
+
+    /**
+     * @brief Find a delimiting string.
+     * @details The search is `std::string_view::find`, which standard libraries implement by
+     * jumping between occurrences of the first character with `memchr` and comparing the rest.
+     */
+    struct string_finder {
+      Predicate delimiter; /**< The delimiting string. */
+
+      /**
+       * @brief Find the first delimiter.
+       * @param[in] input The input to be searched.
+       * @param[in] from Index to start searching at.
+       * @returns Index of the first delimiter at or after `from`, `Tok::Input::npos` if there is none.
+       */
+      constexpr std::size_t find(Input input, std::size_t from) const noexcept
+      {
+        return input.find(delimiter, from);
+      }
+
+      /**
+       * @brief Describe the characters the span before a delimiter can be made up of.
+       * @returns Every character, since only the whole string delimits the span.
+       */
+      static constexpr char_set members() noexcept
+      {
+        return char_set::all();
+      }
+
+      /**
+       * @brief Count the characters at the end of a searched input that can start a delimiter.
+       * @returns One less than the size of the delimiter.
+       */
+      constexpr std::size_t overlap() const noexcept
+      {
+        return delimiter.empty() ? 0 : delimiter.size() - 1;
+      }
+    };
+
+    /**
+     * @brief A tokenizer that matches the span of characters before a delimiter.
+     * @details This implements Tok::until. The delimiter is found with a bulk search instead of
+     * testing one character at a time, and is not consumed. If the input holds no delimiter,
+     * nothing matches.
+     * @tparam Finder A finder such as `Tok::impl::char_finder`.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Finder, typename Map>
+      struct delimited {
+        Finder finder;  /**< Finds the delimiter. */
+        Map func;       /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to match the span before the delimiter.
+         * @param[in,out] input The input to the tokenizer. It is consumed up to the delimiter on a match.
+         * @returns The extracted token, which may be empty, or `std::nullopt` if there is no delimiter.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          const auto end = finder.find(input, 0);
+          if (end == Input::npos)
+            return {};
+          const Token_view token(input.substr(0, end));
+          func(token);
+          input.remove_prefix(end);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The characters that can come before the delimiter, nullable since the span may be empty.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return {finder.members(), true};
+        }
+
+        /** Progress of a resumable search. */
+        struct state {
+          std::size_t searched = 0; /**< Size of the input known to hold no delimiter start. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Input that was searched before is not searched again.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          const auto end = finder.find(input, progress.searched < input.size() ? progress.searched : input.size());
+          if (end == Input::npos) {
+            if (end_of_input) {
+              progress = {};
+              return match_status::mismatched;
+            }
+            const auto overlap = finder.overlap();
+            progress.searched = input.size() > overlap ? input.size() - overlap : 0;
+            return match_status::incomplete;
+          }
+          progress = {};
+          func(input.substr(0, end));
+          size = end;
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief A tokenizer that greedily matches between `min` and `max` instances of another tokenizer.
+     * @details This implements Tok::many, Tok::exactly and Tok::at_least_one. The input is only
+     * consumed if at least `min` instances matched.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Tokenizer, typename Map>
+      struct repetition : shortest_cache<is_regular<Tokenizer>::value && std::is_same_v<Map, mapper::none_t> &&
+                          !constant_width<Tokenizer>::value, repetition<Tokenizer, Map>> {
+        Tokenizer tokenizer;  /**< The repeated tokenizer. */
+        Map func;             /**< Further processes / maps the extracted token. */
+        std::size_t min;      /**< Least number of instances for a successful match. */
+        std::size_t max;      /**< Most number of instances matched, `Tok::impl::unbounded` for no limit. */
+
+        /**
+         * @brief Attempt to match the repetition at the start of the input.
+         * @details Without Maps, input shorter than the narrowest match fails before any instance
+         * is tried.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          if constexpr (is_regular<repetition>::value)
+            if (input.size() < shortest_match() && !tracking_failures())
+              return {};
+          auto rest = input;
+          std::size_t count = 0;
+          std::size_t mark = 0;
+          if constexpr (has_deferred_map<Tokenizer>::value)
+            mark = log_mark();
+          while (count < max && !(count >= min && rest.empty())) {
+            const auto token = tokenizer(rest);
+            if (!token)
+              break;
+            count++;
+            // Further instances would match the same empty token, so the minimum is met
+            if ((*token).empty()) {
+              count = count < min ? min : count;
+              break;
+            }
+          }
+          if (count < min) {
+            if constexpr (has_deferred_map<Tokenizer>::value)
+              log_rollback(mark);
+            return {};
+          }
+          const Token_view token(input.substr(0, input.size() - rest.size()));
+          func(token);
+          input = rest;
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the repeated tokenizer, nullable if no instance is required.
+         */
+        constexpr first_set first() const noexcept
+        {
+          const auto inner = first_of(tokenizer);
+          return {max == 0 ? char_set{} : inner.chars, min == 0 || inner.nullable};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the repeated tokenizer, times the bounds of the repetition.
+         */
+        constexpr match_width width() const noexcept
+        {
+          const auto inner = width_of(tokenizer);
+          return {saturating_mul(min, inner.min), max == 0 ? 0 : saturating_mul(max, inner.max)};
+        }
+
+        /**
+         * @brief Compute the fewest characters of a match, for failing on input that is too short.
+         * @returns The bound of the repetition times the constant width of the instances, if there
+         * is one, and the stored shortest match otherwise.
+         */
+        constexpr std::size_t shortest_match() const noexcept
+        {
+          if constexpr (constant_width<Tokenizer>::value)
+            return saturating_mul(min, constant_width<Tokenizer>::width.min);
+          else
+            return this->shortest;
+        }
+
+        /** Progress of a resumable repetition. */
+        struct state {
+          std::size_t count = 0;          /**< Number of instances matched. */
+          std::size_t size = 0;           /**< Size of the instances matched. */
+          state_of_t<Tokenizer> inner{};  /**< Progress of the instance being matched. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          while (progress.count < max) {
+            const auto rest = input.substr(progress.size);
+            if (rest.empty() && progress.count >= min) {
+              if (!end_of_input)
+                return match_status::incomplete;
+              break;
+            }
+            std::size_t instance_size = 0;
+            const auto status = resume_tokenizer(tokenizer, rest, instance_size, progress.inner, end_of_input);
+            if (status == match_status::incomplete)
+              return status;
+            progress.inner = {};
+            if (status == match_status::mismatched)
+              break;
+            progress.count++;
+            progress.size += instance_size;
+            if (instance_size == 0) {
+              progress.count = progress.count < min ? min : progress.count;
+              break;
+            }
+          }
+          const auto result = progress;
+          progress = {};
+          if (result.count < min)
+            return match_status::mismatched;
+          func(input.substr(0, result.size));
+          size = result.size;
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief A repetition of a Map-less single character matcher, fused into a span function.
+     * @details The span function runs the predicate directly over the input and the Map is called
+     * once on the whole span.
+     * @tparam Span A callable type `std::size_t (Tok::Input input)` such as `Tok::impl::span_kernel`.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Span, typename Map>
+      struct span_repetition {
+        Span span;        /**< Computes the length of the run of matching characters. */
+        Map func;         /**< Further processes / maps the extracted token. */
+        std::size_t min;  /**< Least number of characters for a successful match. */
+        std::size_t max;  /**< Most number of characters matched, `Tok::impl::unbounded` for no limit. */
+
+        /**
+         * @brief Attempt to match the run of characters at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          const auto token_size = span(input.substr(0, max));
+          if (token_size < min)
+            return {};
+          const Token_view token(input.substr(0, token_size));
+          func(token);
+          input.remove_prefix(token_size);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The characters the span is made up of, nullable if no instance is required.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return {max == 0 ? char_set{} : span.members(), min == 0};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The bounds of the repetition, since every instance is one character.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return {min, max};
+        }
+
+        /** Progress of a resumable run of characters. */
+        struct state {
+          std::size_t size = 0;  /**< Number of matching characters scanned so far. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Only the characters received since the last call are scanned.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          const auto limited = input.substr(0, max);
+          progress.size += span(limited.substr(progress.size));
+          if (progress.size == limited.size() && progress.size < max && !end_of_input)
+            return match_status::incomplete;
+          const auto token_size = progress.size;
+          progress = {};
+          if (token_size < min)
+            return match_status::mismatched;
+          func(input.substr(0, token_size));
+          size = token_size;
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief Compute the length of a UTF-8 sequence from its leading byte.
+     * @param[in] lead The first byte of the sequence.
+     * @returns Number of bytes of the sequence, 0 if `lead` cannot start one.
+     */
+    constexpr std::size_t utf8_length(char lead) noexcept
+    {
+      const auto u = static_cast<unsigned char>(lead);
+      if (u < 0x80)
+        return 1;
+      if (u < 0xc2)
+        return 0;
+      if (u < 0xe0)
+        return 2;
+      if (u < 0xf0)
+        return 3;
+      return u < 0xf5 ? 4 : 0;
+    }
+
+    /**
+     * @brief Decode the UTF-8 sequence at the start of the input.
+     * @details Overlong encodings, surrogates and code points beyond U+10FFFF are rejected.
+     * @param[in] input The input, starting with a complete sequence.
+     * @param[out] cp The decoded code point.
+     * @returns Number of bytes of the sequence, 0 if it is invalid or truncated.
+     */
+    constexpr std::size_t decode_utf8(Input input, char32_t& cp) noexcept
+    {
+      if (input.empty())
+        return 0;
+      const auto length = utf8_length(input[0]);
+      if (length == 0 || input.size() < length)
+        return 0;
+      if (length == 1) {
+        cp = static_cast<unsigned char>(input[0]);
+        return 1;
+      }
+      char32_t value = static_cast<unsigned char>(input[0]) & (0x7fu >> length);
+      for (std::size_t i = 1; i < length; i++) {
+        const auto u = static_cast<unsigned char>(input[i]);
+        if ((u & 0xc0) != 0x80)
+          return 0;
+        value = (value << 6) | (u & 0x3fu);
+      }
+      constexpr char32_t least[] = {0, 0, 0x80, 0x800, 0x10000};
+      if (value < least[length] || value > 0x10ffff || (value >= 0xd800 && value <= 0xdfff))
+        return 0;
+      cp = value;
+      return length;
+    }
+
+    /**
+     * @brief A tokenizer that extracts a single UTF-8 encoded code point out of a set.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Map>
+      struct utf8_char {
+        utf8::code_point_set set;  /**< The code points matched. */
+        Map func;                  /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to extract a single code point from the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token, holding the whole encoding, or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          char32_t cp = 0;
+          const auto length = decode_utf8(input, cp);
+          if (length == 0 || !set.contains(cp))
+            return {};
+          const Token_view token(input.substr(0, length));
+          func(token);
+          input.remove_prefix(length);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The bytes the encoding of a member can start with.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return {set.leading_bytes(), false};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns One to four characters, the sizes of UTF-8 sequences.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return fixed_width;
+        }
+
+        static constexpr match_width fixed_width = {1, 4};  /**< Widths of the matches, known from the type. */
+
+        /** No progress needs to be kept for a single code point. */
+        struct state {};
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          if (input.empty() || (input.size() < utf8_length(input[0]) && !end_of_input))
+            return end_of_input ? match_status::mismatched : match_status::incomplete;
+          auto rest = input;
+          const auto token = (*this)(rest);
+          if (!token)
+            return match_status::mismatched;
+          size = (*token).size();
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief Check if a tokenizer is a Map-less code point matcher.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct is_plain_utf8_matcher : std::false_type {};
+
+    /**
+     * @brief Specialization for Map-less code point matchers.
+     */
+    template<>
+      struct is_plain_utf8_matcher<utf8_char<mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief `true` if `Tokenizer` (after decay) is a Map-less code point matcher.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      inline constexpr bool is_plain_utf8_matcher_v = is_plain_utf8_matcher<std::decay_t<Tokenizer>>::value;
+
+    /**
+     * @brief A repetition of a Map-less code point matcher.
+     * @details Runs of ASCII members are skipped with a `Tok::impl::span_kernel`. Only the bytes that
+     * stop it are decoded. The bounds count code points, not bytes.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Map>
+      struct utf8_repetition {
+        utf8::code_point_set set;  /**< The code points matched. */
+        span_kernel ascii;         /**< Spans the ASCII members of the set. */
+        Map func;                  /**< Further processes / maps the extracted token. */
+        std::size_t min;           /**< Least number of code points for a successful match. */
+        std::size_t max;           /**< Most number of code points matched, `Tok::impl::unbounded` for no limit. */
+
+        /**
+         * @brief Attempt to match the run of code points at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          std::size_t bytes = 0;
+          std::size_t count = 0;
+          scan(input, bytes, count);
+          if (count < min)
+            return {};
+          const Token_view token(input.substr(0, bytes));
+          func(token);
+          input.remove_prefix(bytes);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The bytes the encoding of a member can start with, nullable if no instance is required.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return {max == 0 ? char_set{} : set.leading_bytes(), min == 0};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The bounds of the repetition, times the sizes of UTF-8 sequences.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return {min, saturating_mul(max, 4)};
+        }
+
+        /** Progress of a resumable run of code points. */
+        struct state {
+          std::size_t bytes = 0;  /**< Number of bytes of the code points scanned so far. */
+          std::size_t count = 0;  /**< Number of code points scanned so far. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Only the bytes received since the last call are scanned. A code point split
+         * across calls is decoded once it is complete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          if (scan(input, progress.bytes, progress.count) && !end_of_input)
+            return match_status::incomplete;
+          const auto token_size = progress.bytes;
+          const auto count = progress.count;
+          progress = {};
+          if (count < min)
+            return match_status::mismatched;
+          func(input.substr(0, token_size));
+          size = token_size;
+          return match_status::matched;
+        }
+
+        /**
+         * @brief Extend the run of code points.
+         * @param[in] input The input from the start of the run.
+         * @param[in,out] bytes Size of the run.
+         * @param[in,out] count Number of code points of the run.
+         * @retval true The input ran out before the run could end.
+         * @retval false The run ended on a code point that is not a member, or on its upper bound.
+         */
+        constexpr bool scan(Input input, std::size_t& bytes, std::size_t& count) const noexcept
+        {
+          while (count < max && bytes < input.size()) {
+            const auto run = ascii(input.substr(bytes, max - count));
+            bytes += run;
+            count += run;
+            if (count == max || bytes == input.size())
+              break;
+            const auto rest = input.substr(bytes);
+            const auto length = utf8_length(rest[0]);
+            if (length > rest.size())
+              return true;
+            char32_t cp = 0;
+            if (decode_utf8(rest, cp) == 0 || !set.contains(cp))
+              return false;
+            bytes += length;
+            count++;
+          }
+          return count < max && bytes == input.size();
+        }
+      };
+
+    /**
+     * @brief Create a repetition of a tokenizer, fusing it if possible.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] func A callable object of type `Map`.
+     * @param[in] min Least number of instances for a successful match.
+     * @param[in] max Most number of instances matched.
+     * @returns A `Tok::impl::span_repetition` for Map-less single character matchers, a
+     * `Tok::impl::utf8_repetition` for Map-less code point matchers, a `Tok::impl::repetition`
+     * otherwise.
+     */
+    template<typename Tokenizer, typename Map>
+      constexpr auto make_repetition(Tokenizer&& tokenizer, Map&& func, std::size_t min, std::size_t max) noexcept
+      {
+        if constexpr (is_plain_char_matcher_v<Tokenizer>) {
+          auto span = make_span(tokenizer);
+          return span_repetition<decltype(span), std::decay_t<Map>>{
+            span, std::forward<Map>(func), min, max};
+        } else if constexpr (is_plain_utf8_matcher_v<Tokenizer>) {
+          return utf8_repetition<std::decay_t<Map>>{
+            tokenizer.set, span_kernel(tokenizer.set.ascii()), std::forward<Map>(func), min, max};
+        } else {
+          repetition<std::decay_t<Tokenizer>, std::decay_t<Map>> result{
+            {}, std::forward<Tokenizer>(tokenizer), std::forward<Map>(func), min, max};
+          cache_shortest(result);
+          return result;
+        }
+      }
+
+    /**
+     * @brief A tokenizer that optionally accepts matches of another tokenizer.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Tokenizer, typename Map>
+      struct option {
+        Tokenizer tokenizer;  /**< The optional tokenizer. */
+        Map func;             /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to match the tokenizer at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or an empty token on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          const auto token = tokenizer(input);
+          if (!token) {
+            func({});
+            return {Token_view{}};
+          }
+          func(*token);
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the optional tokenizer, always nullable.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return {first_of(tokenizer).chars, true};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns Up to the widest match of the optional tokenizer.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return {0, width_of(tokenizer).max};
+        }
+
+        /** Progress of a resumable optional match. */
+        struct state {
+          state_of_t<Tokenizer> inner{};  /**< Progress of the optional tokenizer. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          std::size_t inner_size = 0;
+          const auto status = resume_tokenizer(tokenizer, input, inner_size, progress.inner, end_of_input);
+          if (status == match_status::incomplete)
+            return status;
+          progress = {};
+          size = status == match_status::matched ? inner_size : 0;
+          func(input.substr(0, size));
+          return match_status::matched;
+        }
+      };
+
+    /**
+     * @brief A tokenizer that applies a callable object to the output of another tokenizer.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Tokenizer, typename Map>
+      struct mapped {
+        Tokenizer tokenizer;  /**< The mapped tokenizer. */
+        Map func;             /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to match the tokenizer at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          const auto token = tokenizer(input);
+          if (!token)
+            return {};
+          func(*token);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the mapped tokenizer.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return first_of(tokenizer);
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the mapped tokenizer.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return width_of(tokenizer);
+        }
+
+        /** Progress of a resumable mapped match. */
+        struct state {
+          state_of_t<Tokenizer> inner{};  /**< Progress of the mapped tokenizer. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          const auto status = resume_tokenizer(tokenizer, input, size, progress.inner, end_of_input);
+          if (status == match_status::incomplete)
+            return status;
+          progress = {};
+          if (status == match_status::matched)
+            func(input.substr(0, size));
+          return status;
+        }
+      };
+
+    /**
+     * @brief A tokenizer that accepts matches of several tokenizers in sequence.
+     * @details Chains of `operator&` are flattened into a single sequence. The input is saved once
+     * and restored only if one of the parts fails, and the token spans from the start of the
+     * input to wherever the last part stopped. Without Maps, input shorter than the narrowest
+     * match fails before any part is tried.
+     * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename... Tokenizers>
+      struct sequence : shortest_cache<(is_regular<Tokenizers>::value && ...) &&
+                        !(constant_width<Tokenizers>::value && ...), sequence<Tokenizers...>> {
+        std::tuple<Tokenizers...> parts;  /**< The tokenizers, in the order they are evaluated. */
+
+        /**
+         * @brief Attempt to match all tokenizers in sequence at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed only if all of them match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          if constexpr (is_regular<sequence>::value)
+            if (input.size() < shortest_match() && !tracking_failures())
+              return {};
+          const auto input_tokenize = input;
+          std::size_t mark = 0;
+          if constexpr (has_deferred_map<sequence>::value)
+            mark = log_mark();
+          const auto matched = attempt(input, std::index_sequence_for<Tokenizers...>{});
+          if (matched < count) {
+            if (matched) {
+              if constexpr (has_deferred_map<sequence>::value)
+                log_rollback(mark);
+#if defined(LEXTOK_PROFILE)
+              count_event(&profile::backtracks);
+#endif
+            }
+#if defined(LEXTOK_TRACK_FAILURES)
+            if (tracking_failures())
+              report_failure(input, expected(matched, std::index_sequence_for<Tokenizers...>{}));
+#endif
+            input = input_tokenize;
+            return {};
+          }
+          return {input_tokenize.substr(0, input_tokenize.size() - input.size())};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the first tokenizer, joined by those of the following ones for
+         * as long as the previous ones are nullable.
+         */
+        constexpr first_set first() const noexcept
+        {
+          first_set result = {{}, true};
+          std::apply([&result](const auto&... part) {
+              const auto join = [&result](const first_set& next) {
+                result = {result.chars | next.chars, next.nullable};
+                return next.nullable;
+              };
+              (join(first_of(part)) && ...);
+            }, parts);
+          return result;
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The sums of the widths of the tokenizers.
+         */
+        constexpr match_width width() const noexcept
+        {
+          match_width result = {0, 0};
+          std::apply([&result](const auto&... part) {
+              ((result = {saturating_add(result.min, width_of(part).min), saturating_add(result.max, width_of(part).max)}), ...);
+            }, parts);
+          return result;
+        }
+
+        /**
+         * @brief Compute the fewest characters of a match, for failing on input that is too short.
+         * @returns The constant width of the sequence, if there is one, and the stored shortest
+         * match otherwise.
+         */
+        constexpr std::size_t shortest_match() const noexcept
+        {
+          if constexpr (constant_width<sequence>::value)
+            return constant_width<sequence>::width.min;
+          else
+            return this->shortest;
+        }
+
+        /** Progress of a resumable sequence. */
+        struct state {
+          std::size_t part = 0;                           /**< Index of the tokenizer being matched. */
+          std::size_t matched = 0;                        /**< Size of the matches of the previous tokenizers. */
+          std::tuple<state_of_t<Tokenizers>...> inner{};  /**< Progress of each tokenizer. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Tokenizers that already matched are not run again.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          for (; progress.part < count; progress.part++) {
+            std::size_t part_size = 0;
+            const auto status = resume_part(input.substr(progress.matched), part_size, progress, end_of_input,
+                std::index_sequence_for<Tokenizers...>{});
+            if (status == match_status::incomplete)
+              return status;
+            if (status == match_status::mismatched) {
+              progress = {};
+              return status;
+            }
+            progress.matched += part_size;
+          }
+          size = progress.matched;
+          progress = {};
+          return match_status::matched;
+        }
+
+        static constexpr std::size_t count = sizeof...(Tokenizers); /**< Number of tokenizers. */
+
+        /**
+         * @brief Apply the tokenizers in order, until one of them fails.
+         * @tparam Is Indices of the tokenizers.
+         * @param[in,out] input The input to the tokenizers.
+         * @param[in] indices The indices of all tokenizers.
+         * @returns The number of tokenizers that matched.
+         */
+        template<std::size_t... Is>
+          constexpr std::size_t attempt(Input& input, std::index_sequence<Is...> indices) const
+          {
+            std::size_t matched = 0;
+            ((std::get<Is>(parts)(input) && ++matched) && ...);
+            return matched;
+          }
+
+        /**
+         * @brief Compute the characters a part can start with.
+         * @tparam Is Indices of the tokenizers.
+         * @param[in] part Index of the part.
+         * @param[in] indices The indices of all tokenizers.
+         * @returns The characters of the FIRST set of the part.
+         */
+        template<std::size_t... Is>
+          constexpr char_set expected(std::size_t part, std::index_sequence<Is...> indices) const noexcept
+          {
+            char_set chars;
+            ((part == Is && ((chars = first_of(std::get<Is>(parts)).chars), true)) || ...);
+            return chars;
+          }
+
+        /**
+         * @brief Resume the tokenizer being matched.
+         * @tparam Is Indices of the tokenizers.
+         * @param[in] input The input from the end of the previous matches up to the last character received.
+         * @param[out] size Size of the match of the tokenizer.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @param[in] indices The indices of all tokenizers.
+         * @returns The outcome of the match of the tokenizer.
+         */
+        template<std::size_t... Is>
+          constexpr match_status resume_part(Input input, std::size_t& size, state& progress,
+              bool end_of_input, std::index_sequence<Is...> indices) const
+          {
+            auto status = match_status::mismatched;
+            ((progress.part == Is && ((status = resume_tokenizer(std::get<Is>(parts), input, size,
+                        std::get<Is>(progress.inner), end_of_input)), true)) || ...);
+            return status;
+          }
+      };
+
+    /**
+     * @brief Check if a type is a sequence.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct is_sequence : std::false_type {};
+
+    /**
+     * @brief Specialization for sequences.
+     * @tparam Tokenizers The parts of the sequence.
+     */
+    template<typename... Tokenizers>
+      struct is_sequence<sequence<Tokenizers...>> : std::true_type {};
+
+    /**
+     * @brief Collect the parts a tokenizer contributes to a sequence.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @returns The parts of `tokenizer` if it is a sequence, otherwise `tokenizer` itself.
+     */
+    template<typename Tokenizer>
+      constexpr auto parts_of(Tokenizer&& tokenizer) noexcept
+      {
+        if constexpr (is_sequence<std::decay_t<Tokenizer>>::value)
+          return std::forward<Tokenizer>(tokenizer).parts;
+        else
+          return std::tuple<std::decay_t<Tokenizer>>(std::forward<Tokenizer>(tokenizer));
+      }
+
+    /**
+     * @brief Specialization for sequences whose parts all have constant widths.
+     * @tparam Tokenizers The parts of the sequence.
+     */
+    template<typename... Tokenizers>
+      struct constant_width<sequence<Tokenizers...>, std::enable_if_t<(constant_width<Tokenizers>::value && ...)>> :
+        std::true_type {
+        static constexpr match_width width = {(std::size_t{0} + ... + constant_width<Tokenizers>::width.min),
+          (std::size_t{0} + ... + constant_width<Tokenizers>::width.max)};  /**< Widths of the matches. */
+      };
+
+    /**
+     * @brief Create a sequence out of its parts.
+     * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+     * @param[in] parts The tokenizers, in the order they are evaluated.
+     * @returns A sequence of `parts`.
+     */
+    template<typename... Tokenizers>
+      constexpr auto make_sequence(std::tuple<Tokenizers...>&& parts) noexcept
+      {
+        sequence<Tokenizers...> result{{}, std::move(parts)};
+        cache_shortest(result);
+        return result;
+      }
+
+    /**
+     * @brief A tokenizer that chooses the first successful match out of several tokenizers.
+     * @details Chains of `operator|` are flattened into a single alternation. On construction, a
+     * 256-entry dispatch table is computed from the FIRST sets of the branches. Only the branches
+     * that can match the next character of the input are tried, in the order they were listed.
+     * For more than 64 branches, every branch is tried.
+     * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename... Tokenizers>
+      class alternation {
+        public:
+          /**
+           * @brief Create an alternation and its dispatch table.
+           * @param[in] branches The tokenizers to choose from, in the order they are tried.
+           */
+          constexpr explicit alternation(std::tuple<Tokenizers...> branches) noexcept :
+            branches(std::move(branches))
+          {
+            build(std::index_sequence_for<Tokenizers...>{});
+          }
+
+          /**
+           * @brief Attempt to match one of the branches at the start of the input.
+           * @param[in,out] input The input to the tokenizer. It is consumed by the matching branch.
+           * @returns The token of the first branch that succeeds or `std::nullopt` if all fail.
+           */
+          constexpr Token operator()(Input& input) const
+          {
+#if defined(LEXTOK_TRACK_FAILURES)
+            auto token = select(input);
+            if (!token && tracking_failures())
+              report_failure(input, summary.chars);
+            return token;
+#else
+            return select(input);
+#endif
+          }
+
+          /**
+           * @brief Compute the FIRST set of the tokenizer.
+           * @returns The union of the FIRST sets of the branches.
+           */
+          constexpr first_set first() const noexcept
+          {
+            return summary;
+          }
+
+          /**
+           * @brief Compute the widths of the matches of the tokenizer.
+           * @returns The narrowest and the widest match of the branches.
+           */
+          constexpr match_width width() const noexcept
+          {
+            match_width result = {unbounded, 0};
+            std::apply([&result](const auto&... branch) {
+                const auto join = [&result](const match_width& next) {
+                  result = {next.min < result.min ? next.min : result.min, next.max > result.max ? next.max : result.max};
+                };
+                (join(width_of(branch)), ...);
+              }, branches);
+            return result;
+          }
+
+          /**
+           * @brief Access the branches.
+           * @returns A copy of the branches, in the order they are tried.
+           */
+          constexpr std::tuple<Tokenizers...> options() const &
+          {
+            return branches;
+          }
+
+          /**
+           * @brief Move the branches out of an expiring alternation.
+           * @returns The branches, in the order they are tried.
+           */
+          constexpr std::tuple<Tokenizers...> options() &&
+          {
+            return std::move(branches);
+          }
+
+          /**
+           * @brief Access one branch.
+           * @tparam I Index of the branch.
+           * @returns The branch.
+           */
+          template<std::size_t I>
+            constexpr const auto& branch() const noexcept
+            {
+              return std::get<I>(branches);
+            }
+
+          /**
+           * @brief Find the branches that can match the start of the input.
+           * @param[in] input The input to the tokenizer.
+           * @returns One bit per branch whose FIRST set admits the input, every bit for more than 64 branches.
+           */
+          constexpr std::uint64_t candidates(Input input) const noexcept
+          {
+            if constexpr (count > max_dispatch)
+              return ~std::uint64_t{0};
+            else
+              return input.empty() ? empty_mask : dispatch[static_cast<unsigned char>(input[0])];
+          }
+
+          /** Progress of a resumable alternation. */
+          struct state {
+            std::size_t branch = 0;                         /**< Index of the branch being matched. */
+            std::tuple<state_of_t<Tokenizers>...> inner{};  /**< Progress of each branch. */
+          };
+
+          /**
+           * @brief Match the tokenizer over input that may be incomplete.
+           * @details Branches are tried in order. Since the first successful branch wins, a branch
+           * that runs out of input makes the whole alternation incomplete, even if a later branch
+           * would match. Branches that already failed are not tried again.
+           * @param[in] input The input from the start of the match up to the last character received.
+           * @param[out] size Size of the token on a match.
+           * @param[in,out] progress Progress of the match so far.
+           * @param[in] end_of_input `true` if no more input will follow.
+           * @returns The outcome of the match.
+           */
+          constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+          {
+            for (; progress.branch < count; progress.branch++) {
+              if constexpr (count <= max_dispatch) {
+                if (!input.empty() && !((dispatch[static_cast<unsigned char>(input[0])] >> progress.branch) & 1))
+                  continue;
+                if (input.empty() && end_of_input && !((empty_mask >> progress.branch) & 1))
+                  continue;
+              }
+              const auto status = resume_branch(input, size, progress, end_of_input,
+                  std::index_sequence_for<Tokenizers...>{});
+              if (status == match_status::incomplete)
+                return status;
+              if (status == match_status::matched) {
+                progress = {};
+                return status;
+              }
+            }
+            progress = {};
+            return match_status::mismatched;
+          }
+
+        private:
+          static constexpr std::size_t count = sizeof...(Tokenizers); /**< Number of branches. */
+          static constexpr std::size_t max_dispatch = 64;             /**< Most branches covered by the dispatch table. */
+          static constexpr std::size_t max_unrolled = 8;              /**< Most branches tried by an unrolled sequence of tests. */
+
+          /** One bit per branch, wide enough for all of them. */
+          using mask_type = std::conditional_t<(count <= 8), std::uint8_t,
+                std::conditional_t<(count <= 16), std::uint16_t,
+                std::conditional_t<(count <= 32), std::uint32_t, std::uint64_t>>>;
+
+          /** A function that applies one branch to the input. */
+          using caller = Token (*)(const alternation&, Input&);
+
+          /**
+           * @brief Try the branches that can match the next character, in order.
+           * @param[in,out] input The input to the tokenizer. It is consumed by the matching branch.
+           * @returns The token of the first branch that succeeds or `std::nullopt` if all fail.
+           */
+          constexpr Token select(Input& input) const
+          {
+            if constexpr (count > max_dispatch) {
+              return attempt_all(input, std::index_sequence_for<Tokenizers...>{});
+            } else {
+              auto mask = input.empty() ? empty_mask : dispatch[static_cast<unsigned char>(input[0])];
+              if constexpr (count <= max_unrolled) {
+                return attempt(input, mask, std::index_sequence_for<Tokenizers...>{});
+              } else {
+                for (; mask; mask = static_cast<mask_type>(mask & (mask - 1)))
+                  if (auto token = callers[lowest_bit(mask)](*this, input); token)
+                    return token;
+                return {};
+              }
+            }
+          }
+
+          /**
+           * @brief Apply one branch to the input.
+           * @tparam I Index of the branch.
+           * @param[in] self The alternation.
+           * @param[in,out] input The input to the branch.
+           * @returns The token extracted by the branch.
+           */
+          template<std::size_t I>
+            static constexpr Token call(const alternation& self, Input& input)
+            {
+#if defined(LEXTOK_PROFILE)
+              count_event(&profile::branches);
+#endif
+              return std::get<I>(self.branches)(input);
+            }
+
+          /**
+           * @brief Create the table of functions applying each branch.
+           * @tparam Is Indices of the branches.
+           * @param[in] indices The indices of all branches.
+           * @returns One function per branch.
+           */
+          template<std::size_t... Is>
+            static constexpr std::array<caller, count> make_callers(std::index_sequence<Is...> indices) noexcept
+            {
+              return {&call<Is>...};
+            }
+
+          static constexpr std::array<caller, count> callers =
+            make_callers(std::index_sequence_for<Tokenizers...>{}); /**< One function per branch. */
+
+          /**
+           * @brief Try the branches selected by a mask, in order.
+           * @tparam Is Indices of the branches.
+           * @param[in,out] input The input to the branches.
+           * @param[in] mask One bit per branch that can match.
+           * @param[in] indices The indices of all branches.
+           * @returns The token of the first branch that succeeds or `std::nullopt` if all fail.
+           */
+          template<std::size_t... Is>
+            constexpr Token attempt(Input& input, mask_type mask, std::index_sequence<Is...> indices) const
+            {
+              Token token;
+              ((((mask >> Is) & 1) && (token = call<Is>(*this, input))) || ...);
+              return token;
+            }
+
+          /**
+           * @brief Resume the branch being matched.
+           * @tparam Is Indices of the branches.
+           * @param[in] input The input from the start of the match up to the last character received.
+           * @param[out] size Size of the token on a match.
+           * @param[in,out] progress Progress of the match so far.
+           * @param[in] end_of_input `true` if no more input will follow.
+           * @param[in] indices The indices of all branches.
+           * @returns The outcome of the match of the branch.
+           */
+          template<std::size_t... Is>
+            constexpr match_status resume_branch(Input input, std::size_t& size, state& progress,
+                bool end_of_input, std::index_sequence<Is...> indices) const
+            {
+              auto status = match_status::mismatched;
+              ((progress.branch == Is && ((status = resume_tokenizer(std::get<Is>(branches), input, size,
+                          std::get<Is>(progress.inner), end_of_input)), true)) || ...);
+              return status;
+            }
+
+          /**
+           * @brief Try every branch, in order.
+           * @tparam Is Indices of the branches.
+           * @param[in,out] input The input to the branches.
+           * @param[in] indices The indices of all branches.
+           * @returns The token of the first branch that succeeds or `std::nullopt` if all fail.
+           */
+          template<std::size_t... Is>
+            constexpr Token attempt_all(Input& input, std::index_sequence<Is...> indices) const
+            {
+              Token token;
+              ((token = call<Is>(*this, input)) || ...);
+              return token;
+            }
+
+          /**
+           * @brief Compute the dispatch table from the FIRST sets of the branches.
+           * @tparam Is Indices of the branches.
+           * @param[in] indices The indices of all branches.
+           */
+          template<std::size_t... Is>
+            constexpr void build(std::index_sequence<Is...> indices) noexcept
+            {
+              const first_set firsts[] = {first_of(std::get<Is>(branches))...};
+              for (std::size_t i = 0; i < count; i++) {
+                summary.chars = summary.chars | firsts[i].chars;
+                summary.nullable = summary.nullable || firsts[i].nullable;
+                if constexpr (count <= max_dispatch) {
+                  const auto bit = static_cast<mask_type>(std::uint64_t{1} << i);
+                  if (firsts[i].nullable)
+                    empty_mask = static_cast<mask_type>(empty_mask | bit);
+                  for (unsigned c = 0; c < 256; c++)
+                    if (firsts[i].nullable || firsts[i].chars.contains(static_cast<char>(c)))
+                      dispatch[c] = static_cast<mask_type>(dispatch[c] | bit);
+                }
+              }
+            }
+
+          std::tuple<Tokenizers...> branches;  /**< The tokenizers to choose from. */
+          mask_type dispatch[256] = {};        /**< Branches that can match, by first character. */
+          mask_type empty_mask = 0;            /**< Branches that can match the empty input. */
+          first_set summary = {};              /**< Union of the FIRST sets of the branches. */
+      };
+
+    /**
+     * @brief Check if a type is an alternation.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct is_alternation : std::false_type {};
+
+    /**
+     * @brief Specialization for alternations.
+     * @tparam Tokenizers The branches of the alternation.
+     */
+    template<typename... Tokenizers>
+      struct is_alternation<alternation<Tokenizers...>> : std::true_type {};
+
+    /**
+     * @brief Collect the branches a tokenizer contributes to an alternation.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @returns The branches of `tokenizer` if it is an alternation, otherwise `tokenizer` itself.
+     */
+    template<typename Tokenizer>
+      constexpr auto branches_of(Tokenizer&& tokenizer) noexcept
+      {
+        if constexpr (is_alternation<std::decay_t<Tokenizer>>::value)
+          return std::forward<Tokenizer>(tokenizer).options();
+        else
+          return std::tuple<std::decay_t<Tokenizer>>(std::forward<Tokenizer>(tokenizer));
+      }
+
+    /**
+     * @brief Create an alternation out of its branches.
+     * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+     * @param[in] branches The tokenizers to choose from, in the order they are tried.
+     * @returns An alternation between `branches`.
+     */
+    template<typename... Tokenizers>
+      constexpr auto make_alternation(std::tuple<Tokenizers...>&& branches) noexcept
+      {
+        return alternation<Tokenizers...>(std::move(branches));
+      }
+
+    /**
+     * @brief A tokenizer that chooses a match out of order-independent tokenizers, trying the most
+     * frequent one first.
+     * @details The branches that can match the next character are tried in the order kept by a
+     * `Tok::branch_stats`, which follows the sampled hit rates of the branches. During constant
+     * evaluation, branches are tried in the order they were listed and nothing is counted, and so
+     * are they always by compilers that cannot tell constant evaluation apart.
+     * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename... Tokenizers>
+      class adaptive_alternation {
+        public:
+          static_assert(sizeof...(Tokenizers) <= branch_stats::max_branches,
+              "An adaptive alternation has at most Tok::branch_stats::max_branches branches");
+
+          /**
+           * @brief Create an adaptive alternation.
+           * @param[in] branches The tokenizers to choose from.
+           * @param[in] stats The statistics of the alternation. They must outlive it.
+           */
+          constexpr adaptive_alternation(std::tuple<Tokenizers...> branches, branch_stats* stats) noexcept :
+            ordered(std::move(branches)), stats(stats)
+          {}
+
+          /**
+           * @brief Attempt to match one of the branches at the start of the input.
+           * @param[in,out] input The input to the tokenizer. It is consumed by the matching branch.
+           * @returns The token of the first branch that succeeds or `std::nullopt` if all fail.
+           */
+          constexpr Token operator()(Input& input) const
+          {
+#if defined(LEXTOK_CONSTANT_EVALUATED)
+            if (LEXTOK_CONSTANT_EVALUATED())
+              return ordered(input);
+            const auto mask = ordered.candidates(input);
+            auto order = stats->order();
+            for (std::size_t rank = 0; rank < count; rank++, order >>= 4) {
+              const auto index = static_cast<std::size_t>(order & 0xf);
+              if (!((mask >> index) & 1))
+                continue;
+              if (auto token = attempt(input, index, std::index_sequence_for<Tokenizers...>{}); token) {
+                if ((++sample_clock & (branch_stats::sample_rate - 1)) == 0)
+                  stats->record(index, count);
+                return token;
+              }
+            }
+#if defined(LEXTOK_TRACK_FAILURES)
+            if (tracking_failures())
+              report_failure(input, ordered.first().chars);
+#endif
+            return {};
+#else
+            return ordered(input);
+#endif
+          }
+
+          /**
+           * @brief Compute the FIRST set of the tokenizer.
+           * @returns The union of the FIRST sets of the branches.
+           */
+          constexpr first_set first() const noexcept
+          {
+            return ordered.first();
+          }
+
+          /**
+           * @brief Compute the widths of the matches of the tokenizer.
+           * @returns The narrowest and the widest match of the branches.
+           */
+          constexpr match_width width() const noexcept
+          {
+            return ordered.width();
+          }
+
+          /** Progress of a resumable adaptive alternation. */
+          using state = typename alternation<Tokenizers...>::state;
+
+          /**
+           * @brief Match the tokenizer over input that may be incomplete.
+           * @details Branches are tried in the order they were listed and matches are not counted.
+           * @param[in] input The input from the start of the match up to the last character received.
+           * @param[out] size Size of the token on a match.
+           * @param[in,out] progress Progress of the match so far.
+           * @param[in] end_of_input `true` if no more input will follow.
+           * @returns The outcome of the match.
+           */
+          constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+          {
+            return ordered.resume(input, size, progress, end_of_input);
+          }
+
+          /**
+           * @brief Access the branches.
+           * @returns A copy of the branches, in the order they were listed.
+           */
+          constexpr std::tuple<Tokenizers...> options() const
+          {
+            return ordered.options();
+          }
+
+          /**
+           * @brief Access the statistics of the alternation.
+           * @returns The statistics that order the branches.
+           */
+          constexpr branch_stats* statistics() const noexcept
+          {
+            return stats;
+          }
+
+        private:
+          static constexpr std::size_t count = sizeof...(Tokenizers); /**< Number of branches. */
+
+          /**
+           * @brief Apply one branch, chosen at run time, to the input.
+           * @tparam Is Indices of the branches.
+           * @param[in,out] input The input to the branch.
+           * @param[in] index Index of the branch.
+           * @param[in] indices The indices of all branches.
+           * @returns The token extracted by the branch.
+           */
+          template<std::size_t... Is>
+            Token attempt(Input& input, std::size_t index, std::index_sequence<Is...> indices) const
+            {
+#if defined(LEXTOK_PROFILE)
+              count_event(&profile::branches);
+#endif
+              Token token;
+              ((index == Is && ((token = ordered.template branch<Is>()(input)), true)) || ...);
+              return token;
+            }
+
+          alternation<Tokenizers...> ordered; /**< The branches in the order they were listed, and their dispatch table. */
+          branch_stats* stats;                /**< Counts and order of the branches. */
+      };
+
+    /**
+     * @brief Create an adaptive alternation out of its branches.
+     * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+     * @param[in] branches The tokenizers to choose from.
+     * @param[in] stats The statistics of the alternation.
+     * @returns An adaptive alternation between `branches`.
+     */
+    template<typename... Tokenizers>
+      constexpr auto make_adaptive_alternation(std::tuple<Tokenizers...>&& branches, branch_stats* stats) noexcept
+      {
+        return adaptive_alternation<Tokenizers...>(std::move(branches), stats);
+      }
+
+    /**
+     * @brief A tokenizer that matches the longest out of a set of literal strings.
+     * @details The keywords are sorted on construction, which makes the sorted array an implicit
+     * trie: every character of the input narrows down the range of keywords sharing the prefix
+     * matched so far, by binary search. The input is scanned once, no matter how many keywords
+     * there are, and the longest keyword seen on the way is the match.
+     * @tparam N Number of keywords.
+     * @tparam Indexed_Map A callable type `void (std::size_t index, Tok::Token_view)`. It is called
+     * on the extracted token, along with the index of the keyword in the list it was created from.
+     * @tparam Ignore_case `true` to ignore the case of ASCII letters. Keywords are then sorted and
+     * searched by their lower case spelling.
+     */
+    template<std::size_t N, typename Indexed_Map, bool Ignore_case = false>
+      class keywords {
+        public:
+          /**
+           * @brief Sort the keywords.
+           * @param[in] list The keywords, in the order they are indexed.
+           * @param[in] func A callable object of type `Indexed_Map`.
+           */
+          constexpr keywords(const Predicate (&list)[N], Indexed_Map func) noexcept :
+            func(std::move(func))
+          {
+            for (std::size_t i = 0; i < N; i++) {
+              // Insertion sort keeps duplicates in their original order
+              std::size_t j = i;
+              for (; j > 0 && less(list[i], words[j - 1]); j--) {
+                words[j] = words[j - 1];
+                index[j] = index[j - 1];
+              }
+              words[j] = list[i];
+              index[j] = i;
+              widths.min = list[i].size() < widths.min ? list[i].size() : widths.min;
+              widths.max = list[i].size() > widths.max ? list[i].size() : widths.max;
+              if (list[i].empty())
+                summary.nullable = true;
+              else if constexpr (Ignore_case)
+                summary.chars = summary.chars | both_cases(list[i][0]);
+              else
+                summary.chars.insert(list[i][0]);
+            }
+          }
+
+          /**
+           * @brief Attempt to match the longest keyword at the start of the input.
+           * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+           * @returns The extracted token or `std::nullopt` if no keyword matches.
+           */
+          constexpr Token operator()(Input& input) const
+          {
+            state progress;
+            std::size_t size = 0;
+            if (resume(input, size, progress, true) != match_status::matched)
+              return {};
+            const Token_view token(input.substr(0, size));
+            input.remove_prefix(size);
+            return {token};
+          }
+
+          /** Progress of a resumable keyword match. */
+          struct state {
+            std::size_t lo = 0;         /**< First keyword sharing the prefix matched so far. */
+            std::size_t hi = N;         /**< One past the last keyword sharing the prefix matched so far. */
+            std::size_t depth = 0;      /**< Size of the prefix matched so far. */
+            std::size_t best = N;       /**< Longest keyword matched so far, `N` for none. */
+            std::size_t best_size = 0;  /**< Size of the longest keyword matched so far. */
+          };
+
+          /**
+           * @brief Match the tokenizer over input that may be incomplete.
+           * @details Only the characters received since the last call are scanned.
+           * @param[in] input The input from the start of the match up to the last character received.
+           * @param[out] size Size of the token on a match.
+           * @param[in,out] progress Progress of the match so far.
+           * @param[in] end_of_input `true` if no more input will follow.
+           * @returns The outcome of the match.
+           */
+          constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+          {
+            for (auto& p = progress; p.lo < p.hi; p.depth++) {
+              // Keywords that end here sort before the ones that continue
+              if (words[p.lo].size() == p.depth) {
+                p.best = p.lo;
+                p.best_size = p.depth;
+                while (p.lo < p.hi && words[p.lo].size() == p.depth)
+                  p.lo++;
+              }
+              if (p.lo == p.hi)
+                break;
+              if (p.depth == input.size()) {
+                if (!end_of_input)
+                  return match_status::incomplete;
+                break;
+              }
+              const auto c = key(input[p.depth]);
+              p.lo = bound(p.lo, p.hi, p.depth, c, false);
+              p.hi = bound(p.lo, p.hi, p.depth, c, true);
+            }
+            const auto result = progress;
+            progress = {};
+            if (result.best == N)
+              return match_status::mismatched;
+            size = result.best_size;
+            func(index[result.best], input.substr(0, size));
+            return match_status::matched;
+          }
+
+          /**
+           * @brief Compute the FIRST set of the tokenizer.
+           * @returns The first characters of all keywords, nullable if one of them is empty.
+           */
+          constexpr first_set first() const noexcept
+          {
+            return summary;
+          }
+
+          /**
+           * @brief Compute the widths of the matches of the tokenizer.
+           * @returns The sizes of the shortest and the longest keyword.
+           */
+          constexpr match_width width() const noexcept
+          {
+            return widths;
+          }
+
+          /**
+           * @brief Access a keyword.
+           * @param[in] i Position of the keyword in sorted order.
+           * @returns The keyword.
+           */
+          constexpr Predicate keyword(std::size_t i) const noexcept
+          {
+            return words[i];
+          }
+
+        private:
+          /**
+           * @brief Compute the sort key of a character.
+           * @param[in] c The character.
+           * @returns Its unsigned value, after folding case if it is ignored.
+           */
+          static constexpr unsigned char key(char c) noexcept
+          {
+            if constexpr (Ignore_case)
+              return static_cast<unsigned char>(fold_case(c));
+            else
+              return static_cast<unsigned char>(c);
+          }
+
+          /**
+           * @brief Order keywords by the sort keys of their characters.
+           * @param[in] l The left operand.
+           * @param[in] r The right operand.
+           * @retval true `l` sorts before `r`.
+           * @retval false `l` does not sort before `r`.
+           */
+          static constexpr bool less(Predicate l, Predicate r) noexcept
+          {
+            for (std::size_t i = 0; i < l.size() && i < r.size(); i++)
+              if (key(l[i]) != key(r[i]))
+                return key(l[i]) < key(r[i]);
+            return l.size() < r.size();
+          }
+
+          /**
+           * @brief Binary search a range of keywords longer than `depth` that share a prefix.
+           * @param[in] lo The first keyword of the range.
+           * @param[in] hi One past the last keyword of the range.
+           * @param[in] depth Index of the character to compare.
+           * @param[in] c Character to compare against.
+           * @param[in] upper Find the first keyword whose character is greater than `c` instead of
+           * not less than `c`.
+           * @returns Index of the first keyword of the range satisfying the condition, or `hi`.
+           */
+          constexpr std::size_t bound(std::size_t lo, std::size_t hi, std::size_t depth,
+              unsigned char c, bool upper) const noexcept
+          {
+            while (lo < hi) {
+              const auto mid = lo + (hi - lo) / 2;
+              const auto k = key(words[mid][depth]);
+              if (k < c || (upper && k == c))
+                lo = mid + 1;
+              else
+                hi = mid;
+            }
+            return lo;
+          }
+
+          Predicate words[N] = {};      /**< The keywords, sorted. */
+          std::size_t index[N] = {};    /**< Index of each sorted keyword in the original list. */
+          Indexed_Map func;             /**< Further processes / maps the extracted token. */
+          first_set summary = {};       /**< First characters of the keywords. */
+          match_width widths = {unbounded, 0}; /**< Sizes of the shortest and the longest keyword. */
+      };
+
+    /**
+     * @brief A tokenizer whose outcome at each position is remembered in a packrat cache.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct memoized {
+        Tokenizer tokenizer;  /**< The memoized tokenizer. */
+        memo_cache* cache;    /**< The cache shared by the rules of a parse. */
+        std::size_t rule;     /**< Identifier of the tokenizer in the cache. */
+
+        /**
+         * @brief Attempt to match the tokenizer at the start of the input, or recall the outcome.
+         * @details Maps inside the tokenizer are only called the first time it is applied at a position.
+         * Within a transaction, a recalled match of a tokenizer with deferred Maps is matched again,
+         * since the calls it recorded may have been dropped by a failing sequence in the meantime.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        Token operator()(Input& input) const
+        {
+          if (const auto entry = cache->find(rule, input); entry) {
+            if (!entry->matched)
+              return {};
+            if constexpr (has_deferred_map<Tokenizer>::value)
+              if (active_log)
+                return tokenizer(input);
+            const Token_view token(input.substr(0, entry->size));
+            input.remove_prefix(entry->size);
+            return {token};
+          }
+          const auto start = input;
+          const auto token = tokenizer(input);
+          cache->store(rule, start, token);
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the memoized tokenizer.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return first_of(tokenizer);
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the memoized tokenizer.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return width_of(tokenizer);
+        }
+
+        /** Progress of a resumable match, which bypasses the cache. */
+        struct state {
+          state_of_t<Tokenizer> inner{};  /**< Progress of the memoized tokenizer. */
+        };
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Outcomes over incomplete input are provisional, so the cache is not used.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          const auto status = resume_tokenizer(tokenizer, input, size, progress.inner, end_of_input);
+          if (status != match_status::incomplete)
+            progress = {};
+          return status;
+        }
+      };
+
+    /**
+     * @brief A tokenizer whose deferred Maps only run once it succeeds as a whole.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct transaction {
+        Tokenizer tokenizer;  /**< The tokenizer run in the transaction. */
+        map_log* log;         /**< Records the deferred calls. */
+
+        /**
+         * @brief Attempt to match the tokenizer, then run or drop the deferred calls.
+         * @details Within a transaction over the same log, the calls are left for the outer
+         * transaction to run.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        Token operator()(Input& input) const
+        {
+          const auto outer = active_log;
+          const auto mark = log->size();
+          active_log = log;
+          const auto token = tokenizer(input);
+          active_log = outer;
+          if (!token)
+            log->rollback(mark);
+          else if (outer != log)
+            log->commit(mark);
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the tokenizer run in the transaction.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return first_of(tokenizer);
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the tokenizer run in the transaction.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return width_of(tokenizer);
+        }
+      };
+
+#if defined(LEXTOK_PROFILE)
+    /**
+     * @brief Read the cycle counter of the CPU.
+     * @returns The cycle count, or 0 if `LEXTOK_PROFILE_CYCLES` is not defined or not supported.
+     */
+    inline std::uint64_t cycle_count() noexcept
+    {
+#if defined(LEXTOK_PROFILE_CYCLES) && (defined(__x86_64__) || defined(__i386__))
+      return __rdtsc();
+#elif defined(LEXTOK_PROFILE_CYCLES) && defined(__aarch64__)
+      std::uint64_t count;
+      asm volatile("mrs %0, cntvct_el0" : "=r"(count));
+      return count;
+#else
+      return 0;
+#endif
+    }
+
+    /**
+     * @brief A tokenizer that counts how another one performs.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct profiled {
+        Tokenizer tokenizer;  /**< The profiled tokenizer. */
+        profile* counters;    /**< Receives the counts. */
+
+        /**
+         * @brief Attempt to match the tokenizer and count the outcome.
+         * @details Nothing is counted during constant evaluation.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          if (LEXTOK_CONSTANT_EVALUATED())
+            return tokenizer(input);
+          const auto outer = active_profile;
+          active_profile = counters;
+          const auto start = cycle_count();
+          const auto token = tokenizer(input);
+          counters->cycles += cycle_count() - start;
+          active_profile = outer;
+          counters->invocations++;
+          if (token) {
+            counters->matches++;
+            counters->bytes += (*token).size();
+          }
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the profiled tokenizer.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return first_of(tokenizer);
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the profiled tokenizer.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return width_of(tokenizer);
+        }
+
+        /** Progress of the profiled tokenizer. */
+        using state = state_of_t<Tokenizer>;
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Resumed matches are not counted.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          return resume_tokenizer(tokenizer, input, size, progress, end_of_input);
+        }
+      };
+#endif
+
+#if defined(LEXTOK_TRACK_FAILURES)
+    /**
+     * @brief A tokenizer that records the furthest failure of another one.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct diagnosed {
+        Tokenizer tokenizer;  /**< The diagnosed tokenizer. */
+        failure* context;     /**< Receives the furthest failure. */
+
+        /**
+         * @brief Attempt to match the tokenizer and record where it failed.
+         * @details Nothing is recorded during constant evaluation. A match leaves the context reset.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          if (LEXTOK_CONSTANT_EVALUATED())
+            return tokenizer(input);
+          const auto outer = active_failure;
+          const auto outer_base = failure_base;
+          active_failure = context;
+          failure_base = input.data();
+          context->reset();
+          const auto start = input;
+          const auto token = tokenizer(input);
+          if (token)
+            context->reset();
+          else if (!context->failed)
+            report_failure(start, first_of(tokenizer).chars);
+          active_failure = outer;
+          failure_base = outer_base;
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the diagnosed tokenizer.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return first_of(tokenizer);
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the diagnosed tokenizer.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return width_of(tokenizer);
+        }
+
+        /** Progress of the diagnosed tokenizer. */
+        using state = state_of_t<Tokenizer>;
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Failures of resumed matches are not recorded.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          return resume_tokenizer(tokenizer, input, size, progress, end_of_input);
+        }
+      };
+
+    /**
+     * @brief A tokenizer reported by name when it fails.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct named {
+        Tokenizer tokenizer;  /**< The named tokenizer. */
+        const char* name;     /**< Its name in failures. */
+
+        /**
+         * @brief Attempt to match the tokenizer and report its name if it fails.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          auto token = tokenizer(input);
+          if (!token && tracking_failures())
+            report_failure(input, first_of(tokenizer).chars, name);
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the named tokenizer.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return first_of(tokenizer);
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the named tokenizer.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return width_of(tokenizer);
+        }
+
+        /** Progress of the named tokenizer. */
+        using state = state_of_t<Tokenizer>;
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @details Failures of resumed matches are not reported.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          return resume_tokenizer(tokenizer, input, size, progress, end_of_input);
+        }
+      };
+#endif
+
+    /**
+     * @brief A Map-like sink that stores a parsed value into a variable.
+     * @tparam T Type of the value.
+     */
+    template<typename T>
+      struct store {
+        T* target;  /**< The variable receiving the value. */
+
+        /**
+         * @brief Store the value.
+         * @param[in] value The parsed value.
+         */
+        constexpr void operator()(T value) const noexcept
+        {
+          *target = value;
+        }
+      };
+
+    /**
+     * @brief Compute the value of a digit.
+     * @param[in] c The character.
+     * @returns The value of `c` as a hexadecimal digit, or 16 if it is not one.
+     */
+    constexpr unsigned digit_value(char c) noexcept
+    {
+      if (c >= '0' && c <= '9')
+        return static_cast<unsigned>(c - '0');
+      if (c >= 'a' && c <= 'f')
+        return static_cast<unsigned>(c - 'a' + 10);
+      if (c >= 'A' && c <= 'F')
+        return static_cast<unsigned>(c - 'A' + 10);
+      return 16;
+    }
+
+    /**
+     * @brief A tokenizer that matches an integer and computes its value in the same pass.
+     * @details Signed types accept a leading `-` or `+`. The match fails, without consuming any
+     * input, if the value does not fit in `T`.
+     * @tparam T An integral type.
+     * @tparam Base 10 or 16.
+     * @tparam Sink A callable type `void (T)`. It is called with the value on a match.
+     */
+    template<typename T, unsigned Base, typename Sink>
+      struct integer_parser {
+        Sink sink;  /**< Receives the value. */
+
+        /**
+         * @brief Attempt to match an integer and compute its value.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns The value or `std::nullopt` on a mismatch or an overflow.
+         */
+        constexpr std::optional<T> parse(Input& input) const noexcept
+        {
+          bool at_end = false;
+          std::size_t size = 0;
+          T value{};
+          if (!scan(input, size, value, at_end))
+            return {};
+          input.remove_prefix(size);
+          return value;
+        }
+
+        /**
+         * @brief Attempt to match an integer and pass its value to the sink.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch or an overflow.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          bool at_end = false;
+          std::size_t size = 0;
+          T value{};
+          if (!scan(input, size, value, at_end))
+            return {};
+          if constexpr (!std::is_same_v<Sink, mapper::none_t>)
+            sink(value);
+          const Token_view token(input.substr(0, size));
+          input.remove_prefix(size);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The digits of the base, and the signs for signed types.
+         */
+        constexpr first_set first() const noexcept
+        {
+          auto chars = Base == 16 ? char_class::hex_digit : char_class::digit;
+          if (std::is_signed_v<T> && Base == 10)
+            chars = chars | char_set("+-");
+          return {chars, false};
+        }
+
+        /** Progress is not needed, since integers are short and scanned again. */
+        struct state {};
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          bool at_end = false;
+          std::size_t token_size = 0;
+          T value{};
+          const bool matched = scan(input, token_size, value, at_end);
+          if (at_end && !end_of_input)
+            return match_status::incomplete;
+          if (!matched)
+            return match_status::mismatched;
+          if constexpr (!std::is_same_v<Sink, mapper::none_t>)
+            sink(value);
+          size = token_size;
+          return match_status::matched;
+        }
+
+      private:
+        /**
+         * @brief Scan an integer.
+         * @param[in] input The input to be scanned.
+         * @param[out] size Size of the integer.
+         * @param[out] value Value of the integer.
+         * @param[out] at_end `true` if the scan stopped at the end of the input.
+         * @retval true An integer that fits in `T` was found.
+         * @retval false The input does not start with an integer, or it overflows.
+         */
+        static constexpr bool scan(Input input, std::size_t& size, T& value, bool& at_end) noexcept
+        {
+          using U = std::make_unsigned_t<T>;
+          std::size_t i = 0;
+          bool negative = false;
+          if constexpr (std::is_signed_v<T> && Base == 10) {
+            if (!input.empty() && (input[0] == '-' || input[0] == '+')) {
+              negative = input[0] == '-';
+              i++;
+            }
+          }
+          const U limit = negative ? static_cast<U>(static_cast<U>(std::numeric_limits<T>::max()) + 1) :
+            static_cast<U>(std::numeric_limits<T>::max());
+          U magnitude = 0;
+          const auto digits_start = i;
+          bool overflow = false;
+          for (; i < input.size(); i++) {
+            const auto d = digit_value(input[i]);
+            if (d >= Base)
+              break;
+            if (magnitude > static_cast<U>((limit - d) / Base))
+              overflow = true;
+            magnitude = static_cast<U>(magnitude * Base + d);
+          }
+          at_end = i == input.size();
+          if (i == digits_start || overflow)
+            return false;
+          if (negative)
+            value = magnitude == 0 ? T{0} : static_cast<T>(-static_cast<T>(magnitude - 1) - 1);
+          else
+            value = static_cast<T>(magnitude);
+          size = i;
+          return true;
+        }
+      };
+
+    /**
+     * @brief A tokenizer that matches a decimal number and computes its value in the same pass.
+     * @details The number has an optional sign, digits with an optional fraction, and an optional
+     * exponent, e.g. `-12.5e-3`. At least one digit is needed before or after the point.
+     * @tparam T A floating point type.
+     * @tparam Sink A callable type `void (T)`. It is called with the value on a match.
+     */
+    template<typename T, typename Sink>
+      struct decimal_parser {
+        Sink sink;  /**< Receives the value. */
+
+        /**
+         * @brief Attempt to match a decimal number and compute its value.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns The value or `std::nullopt` on a mismatch.
+         */
+        constexpr std::optional<T> parse(Input& input) const noexcept
+        {
+          bool at_end = false;
+          std::size_t size = 0;
+          T value{};
+          if (!scan(input, size, value, at_end))
+            return {};
+          input.remove_prefix(size);
+          return value;
+        }
+
+        /**
+         * @brief Attempt to match a decimal number and pass its value to the sink.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          bool at_end = false;
+          std::size_t size = 0;
+          T value{};
+          if (!scan(input, size, value, at_end))
+            return {};
+          if constexpr (!std::is_same_v<Sink, mapper::none_t>)
+            sink(value);
+          const Token_view token(input.substr(0, size));
+          input.remove_prefix(size);
+          return {token};
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The digits, the signs and the decimal point.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return {char_class::digit | char_set("+-."), false};
+        }
+
+        /** Progress is not needed, since numbers are short and scanned again. */
+        struct state {};
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          bool at_end = false;
+          std::size_t token_size = 0;
+          T value{};
+          const bool matched = scan(input, token_size, value, at_end);
+          if (at_end && !end_of_input)
+            return match_status::incomplete;
+          if (!matched)
+            return match_status::mismatched;
+          if constexpr (!std::is_same_v<Sink, mapper::none_t>)
+            sink(value);
+          size = token_size;
+          return match_status::matched;
+        }
+
+      private:
+        /**
+         * @brief Count the leading decimal digits of the input and accumulate them.
+         * @param[in] input The input to be scanned.
+         * @param[in,out] i Position of the first digit, moved past the last one.
+         * @param[in,out] mantissa The significant digits accumulated so far.
+         * @param[in,out] dropped Number of digits that did not fit in the mantissa.
+         * @returns Number of digits.
+         */
+        static constexpr std::size_t digits(Input input, std::size_t& i, std::uint64_t& mantissa, std::size_t& dropped) noexcept
+        {
+          const auto start = i;
+          for (; i < input.size() && input[i] >= '0' && input[i] <= '9'; i++) {
+            if (mantissa < (std::numeric_limits<std::uint64_t>::max() - 9) / 10)
+              mantissa = mantissa * 10 + static_cast<std::uint64_t>(input[i] - '0');
+            else
+              dropped++;
+          }
+          return i - start;
+        }
+
+        /**
+         * @brief Scan a decimal number.
+         * @details For `double`, the value is correctly rounded if the number has up to 15
+         * significant digits and a decimal exponent within +/-22. Otherwise it is within a few
+         * units in the last place.
+         * @param[in] input The input to be scanned.
+         * @param[out] size Size of the number.
+         * @param[out] value Value of the number.
+         * @param[out] at_end `true` if the scan stopped at the end of the input.
+         * @retval true A number was found.
+         * @retval false The input does not start with a number.
+         */
+        static constexpr bool scan(Input input, std::size_t& size, T& value, bool& at_end) noexcept
+        {
+          std::size_t i = 0;
+          bool negative = false;
+          if (!input.empty() && (input[0] == '-' || input[0] == '+')) {
+            negative = input[0] == '-';
+            i++;
+          }
+          std::uint64_t mantissa = 0;
+          std::size_t dropped = 0;
+          auto count = digits(input, i, mantissa, dropped);
+          long exponent = static_cast<long>(dropped);
+          if (i < input.size() && input[i] == '.') {
+            i++;
+            const auto before = dropped;
+            const auto fraction = digits(input, i, mantissa, dropped);
+            exponent -= static_cast<long>(fraction - (dropped - before));
+            count += fraction;
+          }
+          at_end = i == input.size();
+          if (count == 0)
+            return false;
+          if (i < input.size() && (input[i] == 'e' || input[i] == 'E')) {
+            auto j = i + 1;
+            bool negative_exponent = false;
+            if (j < input.size() && (input[j] == '-' || input[j] == '+')) {
+              negative_exponent = input[j] == '-';
+              j++;
+            }
+            long e = 0;
+            const auto start = j;
+            for (; j < input.size() && input[j] >= '0' && input[j] <= '9'; j++)
+              e = e < 100000 ? e * 10 + (input[j] - '0') : e;
+            at_end = j == input.size();
+            // An 'e' without digits is not part of the number
+            if (j > start) {
+              exponent += negative_exponent ? -e : e;
+              i = j;
+            }
+          }
+          T result = static_cast<T>(mantissa);
+          T scale = 1;
+          for (auto e = exponent < 0 ? -exponent : exponent; e > 0 && scale < std::numeric_limits<T>::max(); e--)
+            scale *= 10;
+          result = exponent < 0 ? result / scale : result * scale;
+          value = negative ? -result : result;
+          size = i;
+          return true;
+        }
+      };
+
+    /**
+     * @brief Match a tokenizer over input that arrives in pieces, without starting over.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      class resumable_tokenizer {
+        public:
+          /**
+           * @brief Wrap a tokenizer.
+           * @param[in] tokenizer The tokenizer to be resumed.
+           */
+          constexpr explicit resumable_tokenizer(Tokenizer tokenizer) noexcept :
+            tokenizer(std::move(tokenizer))
+          {}
+
+          /**
+           * @brief Continue matching the tokenizer over the input received so far.
+           * @details `input` must start where the match started and hold every character received
+           * since, so that the token can be a contiguous view. Only the characters received since
+           * the last call are examined, except by tokenizers that cannot resume such as lambdas.
+           * After a match or a mismatch, the progress is cleared for the next match.
+           * @param[in,out] input The input received so far. It is consumed on a match.
+           * @param[out] token The extracted token on a match, `std::nullopt` otherwise.
+           * @param[in] end_of_input `true` if no more input will follow.
+           * @returns The outcome of the match.
+           */
+          constexpr match_status operator()(Input& input, Token& token, bool end_of_input = false)
+          {
+            std::size_t size = 0;
+            const auto status = resume_tokenizer(tokenizer, input, size, progress, end_of_input);
+            token = {};
+            if (status == match_status::incomplete)
+              return status;
+            progress = {};
+            if (status == match_status::matched) {
+              token = input.substr(0, size);
+              input.remove_prefix(size);
+            }
+            return status;
+          }
+
+          /**
+           * @brief Discard the progress of the current match.
+           */
+          constexpr void reset() noexcept
+          {
+            progress = {};
+          }
+
+        private:
+          Tokenizer tokenizer;                 /**< The tokenizer to be resumed. */
+          state_of_t<Tokenizer> progress = {}; /**< Progress of the current match. */
+      };
+
+    /**
+     * @brief A lazy range of the tokens obtained by repeatedly applying a tokenizer on an input.
+     * @details Each token is only extracted when the iterator is advanced to it, so a consumer can
+     * stop early without the rest of the input being tokenized. The range ends when the input is
+     * exhausted, the tokenizer fails or it matches an empty token. No memory is allocated.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      class token_range {
+        public:
+          /**
+           * @brief An input iterator over the tokens.
+           */
+          class iterator {
+            public:
+              using iterator_category = std::input_iterator_tag;  /**< Tokens can only be read once. */
+              using value_type = Token_view;                      /**< Type of the tokens. */
+              using difference_type = std::ptrdiff_t;             /**< Distance between iterators. */
+              using pointer = const Token_view*;                  /**< Pointer to a token. */
+              using reference = const Token_view&;                /**< Reference to a token. */
+
+              /**
+               * @brief Create the past-the-end iterator.
+               */
+              constexpr iterator() noexcept = default;
+
+              /**
+               * @brief Create an iterator at the first token of the input.
+               * @param[in] tokenizer The tokenizer extracting the tokens.
+               * @param[in] input The input to be tokenized.
+               */
+              constexpr iterator(const Tokenizer& tokenizer, Input input) :
+                tokenizer(&tokenizer), rest(input)
+              {
+                next();
+              }
+
+              /**
+               * @brief Access the current token.
+               * @returns The current token.
+               */
+              constexpr reference operator*() const noexcept
+              {
+                return current;
+              }
+
+              /**
+               * @brief Access the current token.
+               * @returns Pointer to the current token.
+               */
+              constexpr pointer operator->() const noexcept
+              {
+                return &current;
+              }
+
+              /**
+               * @brief Extract the next token.
+               * @returns This iterator.
+               */
+              constexpr iterator& operator++()
+              {
+                next();
+                return *this;
+              }
+
+              /**
+               * @brief Extract the next token.
+               * @returns A copy of this iterator before it was advanced.
+               */
+              constexpr iterator operator++(int)
+              {
+                auto previous = *this;
+                next();
+                return previous;
+              }
+
+              /**
+               * @brief Access the input that is yet to be tokenized.
+               * @details Once the range has ended, this is the input the tokenizer failed on.
+               * @returns The input following the current token.
+               */
+              constexpr Input remaining() const noexcept
+              {
+                return rest;
+              }
+
+              /**
+               * @brief Compare two iterators.
+               * @param[in] l The left operand.
+               * @param[in] r The right operand.
+               * @retval true Both iterators have ended, or both are at the same token.
+               * @retval false The iterators are at different tokens.
+               */
+              friend constexpr bool operator==(const iterator& l, const iterator& r) noexcept
+              {
+                if (!l.tokenizer || !r.tokenizer)
+                  return !l.tokenizer && !r.tokenizer;
+                return l.current.data() == r.current.data() && l.current.size() == r.current.size();
+              }
+
+              /**
+               * @brief Compare two iterators.
+               * @param[in] l The left operand.
+               * @param[in] r The right operand.
+               * @retval true The iterators are at different tokens.
+               * @retval false Both iterators have ended, or both are at the same token.
+               */
+              friend constexpr bool operator!=(const iterator& l, const iterator& r) noexcept
+              {
+                return !(l == r);
+              }
+
+            private:
+              /**
+               * @brief Extract the next token, or end the range.
+               */
+              constexpr void next()
+              {
+                if (rest.empty()) {
+                  tokenizer = nullptr;
+                  return;
+                }
+                auto input = rest;
+                const auto token = (*tokenizer)(input);
+                if (!token || (*token).empty()) {
+                  tokenizer = nullptr;
+                  return;
+                }
+                current = *token;
+                rest = input;
+              }
+
+              const Tokenizer* tokenizer = nullptr; /**< The tokenizer, `nullptr` once the range has ended. */
+              Input rest;                           /**< The input following the current token. */
+              Token_view current;                   /**< The current token. */
+          };
+
+          /**
+           * @brief Create a range over an input.
+           * @param[in] tokenizer The tokenizer extracting the tokens.
+           * @param[in] input The input to be tokenized.
+           */
+          constexpr token_range(Tokenizer tokenizer, Input input) noexcept :
+            tokenizer(std::move(tokenizer)), input(input)
+          {}
+
+          /**
+           * @brief Start tokenizing the input.
+           * @details Every call starts over from the beginning of the input.
+           * @returns An iterator at the first token.
+           */
+          constexpr iterator begin() const
+          {
+            return iterator(tokenizer, input);
+          }
+
+          /**
+           * @brief Mark the end of the range.
+           * @returns The past-the-end iterator.
+           */
+          constexpr iterator end() const noexcept
+          {
+            return iterator();
+          }
+
+          /**
+           * @brief Tokenize the input into a buffer.
+           * @details Tokenizing stops where the range ends, or at the first token that does not
+           * fit. The offsets are counted from the start of the input of the range.
+           * @param[in,out] buffer Receives the tokens, after the ones it already holds.
+           * @param[in] id Rule identifier given to every token.
+           * @returns The input that was not tokenized, empty if all of it was.
+           */
+          Input collect(token_buffer& buffer, std::size_t id = 0) const
+          {
+            auto it = begin();
+            auto rest = input;
+            for (; it != end(); ++it) {
+              const auto before = buffer.size();
+              buffer.append(id, static_cast<std::size_t>(it->data() - input.data()), it->size());
+              if (buffer.size() == before)
+                return rest;
+              rest = it.remaining();
+            }
+            return it.remaining();
+          }
+
+        private:
+          Tokenizer tokenizer;  /**< The tokenizer extracting the tokens. */
+          Input input;          /**< The input to be tokenized. */
+      };
+
+    /**
+     * @brief Extract a literal that every match of a tokenizer starts with.
+     * @details This overload covers tokenizers without a known literal prefix.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer The tokenizer to be analysed.
+     * @returns An empty view.
+     */
+    template<typename Tokenizer>
+      constexpr Predicate required_prefix(const Tokenizer& tokenizer) noexcept
+      {
+        return {};
+      }
+
+    /**
+     * @brief Extract a literal that every match of a literal starts with.
+     * @tparam Map A callable type `void (Tok::Token_view)`.
+     * @param[in] tokenizer The literal.
+     * @returns The literal itself.
+     */
+    template<typename Map>
+      constexpr Predicate required_prefix(const literal<Map>& tokenizer) noexcept
+      {
+        return tokenizer.str;
+      }
+
+    /**
+     * @brief Extract a literal that every match of a sequence starts with.
+     * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer The sequence.
+     * @returns The prefix of the first tokenizer.
+     */
+    template<typename... Tokenizers>
+      constexpr Predicate required_prefix(const sequence<Tokenizers...>& tokenizer) noexcept
+      {
+        return required_prefix(std::get<0>(tokenizer.parts));
+      }
+
+    /**
+     * @brief Extract a literal that every match of a repetition starts with.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @tparam Map A callable type `void (Tok::Token_view)`.
+     * @param[in] tokenizer The repetition.
+     * @returns The prefix of the repeated tokenizer if at least one instance is required.
+     */
+    template<typename Tokenizer, typename Map>
+      constexpr Predicate required_prefix(const repetition<Tokenizer, Map>& tokenizer) noexcept
+      {
+        return tokenizer.min > 0 && tokenizer.max > 0 ? required_prefix(tokenizer.tokenizer) : Predicate{};
+      }
+
+    /**
+     * @brief Extract a literal that every match of a mapped tokenizer starts with.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @tparam Map A callable type `void (Tok::Token_view)`.
+     * @param[in] tokenizer The mapped tokenizer.
+     * @returns The prefix of the wrapped tokenizer.
+     */
+    template<typename Tokenizer, typename Map>
+      constexpr Predicate required_prefix(const mapped<Tokenizer, Map>& tokenizer) noexcept
+      {
+        return required_prefix(tokenizer.tokenizer);
+      }
+
+    /**
+     * @brief Find the positions a tokenizer may match at, without running it.
+     * @details A literal prefix is searched for with `std::string_view::find`. Otherwise, the
+     * characters outside the FIRST set are skipped with a `Tok::impl::span_kernel`. A tokenizer
+     * that can match the empty string may match anywhere.
+     */
+    class prefilter {
+      public:
+        /**
+         * @brief Analyse a tokenizer.
+         * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+         * @param[in] tokenizer The tokenizer to be searched for.
+         */
+        template<typename Tokenizer>
+          constexpr explicit prefilter(const Tokenizer& tokenizer) noexcept :
+            prefix(required_prefix(tokenizer)), first(first_of(tokenizer)), others(~first.chars)
+          {}
+
+        /**
+         * @brief Find the next position a match may start at.
+         * @param[in] input The input to be searched.
+         * @param[in] from Index to start searching at.
+         * @returns Index of the next candidate at or after `from`, `Tok::Input::npos` if there is none.
+         */
+        constexpr std::size_t next(Input input, std::size_t from) const noexcept
+        {
+          if (from > input.size())
+            return Input::npos;
+          if (first.nullable)
+            return from;
+          if (!prefix.empty())
+            return input.find(prefix, from);
+          const auto i = from + others(input.substr(from));
+          return i < input.size() ? i : Input::npos;
+        }
+
+      private:
+        Predicate prefix;   /**< Literal every match starts with, if known. */
+        first_set first;    /**< FIRST set of the tokenizer. */
+        span_kernel others; /**< Spans the characters no match can start with. */
+    };
+
+    /**
+     * @brief Specialization for Map-less matchers of a `Tok::char_set`.
+     */
+    template<>
+      struct is_regular<single_char<char_set, mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief Specialization for Map-less literals.
+     */
+    template<>
+      struct is_regular<literal<mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief Specialization for Map-less case-insensitive literals.
+     */
+    template<>
+      struct is_regular<iliteral<mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief Specialization for Map-less keyword sets.
+     * @tparam N Number of keywords.
+     * @tparam Ignore_case `true` if the case of ASCII letters is ignored.
+     */
+    template<std::size_t N, bool Ignore_case>
+      struct is_regular<keywords<N, mapper::none_t, Ignore_case>> : std::true_type {};
+
+    /**
+     * @brief Specialization for Map-less fused repetitions of a `Tok::char_set`.
+     */
+    template<>
+      struct is_regular<span_repetition<span_kernel, mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief Specialization for Map-less repetitions.
+     * @tparam Tokenizer The repeated tokenizer.
+     */
+    template<typename Tokenizer>
+      struct is_regular<repetition<Tokenizer, mapper::none_t>> : is_regular<Tokenizer> {};
+
+    /**
+     * @brief Specialization for Map-less options.
+     * @tparam Tokenizer The optional tokenizer.
+     */
+    template<typename Tokenizer>
+      struct is_regular<option<Tokenizer, mapper::none_t>> : is_regular<Tokenizer> {};
+
+    /**
+     * @brief Specialization for sequences.
+     * @tparam Tokenizers The parts of the sequence.
+     */
+    template<typename... Tokenizers>
+      struct is_regular<sequence<Tokenizers...>> : std::bool_constant<(is_regular<Tokenizers>::value && ...)> {};
+
+    /**
+     * @brief Specialization for alternations.
+     * @tparam Tokenizers The branches of the alternation.
+     */
+    template<typename... Tokenizers>
+      struct is_regular<alternation<Tokenizers...>> : std::bool_constant<(is_regular<Tokenizers>::value && ...)> {};
+
+    /**
+     * @brief Report a tokenizer too large for the capacity of its DFA.
+     * @details It is deliberately not `constexpr`, so that reaching it during constant evaluation
+     * fails to compile.
+     */
+    inline void dfa_capacity_exceeded() noexcept {}
+
+    /**
+     * @brief Glushkov construction of the position automaton of a regular tokenizer.
+     * @details Every character class in the expanded tokenizer becomes a position. The automaton
+     * is described by the positions a match can start and end with and the positions that can
+     * follow each position.
+     * @tparam N Most positions.
+     */
+    template<std::size_t N>
+      struct position_automaton {
+        /** One bit per position. */
+        using bits = std::array<std::uint64_t, (N + 63) / 64>;
+
+        /** The automaton of a part of the tokenizer. */
+        struct fragment {
+          bits first{};           /**< Positions a match can start with. */
+          bits last{};            /**< Positions a match can end with. */
+          bool nullable = true;   /**< `true` if the part matches the empty string. */
+        };
+
+        char_set chars[N] = {};   /**< Characters accepted by each position. */
+        bits follow[N] = {};      /**< Positions that can follow each position. */
+        std::size_t count = 0;    /**< Number of positions. */
+        bool overflow = false;    /**< `true` if the tokenizer needs more than `N` positions. */
+
+        /**
+         * @brief Compute the union of two sets of positions.
+         * @param[in] l The left operand.
+         * @param[in] r The right operand.
+         * @returns The union.
+         */
+        static constexpr bits join(const bits& l, const bits& r) noexcept
+        {
+          bits result{};
+          for (std::size_t i = 0; i < result.size(); i++)
+            result[i] = l[i] | r[i];
+          return result;
+        }
+
+        /**
+         * @brief Compare two sets of positions.
+         * @param[in] l The left operand.
+         * @param[in] r The right operand.
+         * @retval true Both sets hold the same positions.
+         * @retval false The sets differ.
+         */
+        static constexpr bool same(const bits& l, const bits& r) noexcept
+        {
+          for (std::size_t i = 0; i < l.size(); i++)
+            if (l[i] != r[i])
+              return false;
+          return true;
+        }
+
+        /**
+         * @brief Check if a position is in a set.
+         * @param[in] set The set of positions.
+         * @param[in] p The position.
+         * @retval true `p` is in `set`.
+         * @retval false `p` is not in `set`.
+         */
+        static constexpr bool has(const bits& set, std::size_t p) noexcept
+        {
+          return (set[p / 64] >> (p % 64)) & 1;
+        }
+
+        /**
+         * @brief Add a position.
+         * @param[in] set The characters accepted by the position.
+         * @returns A fragment matching one character of the set.
+         */
+        constexpr fragment position(const char_set& set) noexcept
+        {
+          if (count == N) {
+            overflow = true;
+            return {};
+          }
+          fragment result;
+          result.first[count / 64] |= std::uint64_t{1} << (count % 64);
+          result.last = result.first;
+          result.nullable = false;
+          chars[count++] = set;
+          return result;
+        }
+
+        /**
+         * @brief Let every end position of a fragment be followed by a set of positions.
+         * @param[in] from The fragment.
+         * @param[in] to The positions that may follow.
+         */
+        constexpr void link(const fragment& from, const bits& to) noexcept
+        {
+          for (std::size_t p = 0; p < count; p++)
+            if (has(from.last, p))
+              follow[p] = join(follow[p], to);
+        }
+
+        /**
+         * @brief Match two fragments in sequence.
+         * @param[in] l The fragment matched first.
+         * @param[in] r The fragment matched second.
+         * @returns The concatenation.
+         */
+        constexpr fragment concat(const fragment& l, const fragment& r) noexcept
+        {
+          link(l, r.first);
+          return {l.nullable ? join(l.first, r.first) : l.first, r.nullable ? join(l.last, r.last) : r.last,
+            l.nullable && r.nullable};
+        }
+
+        /**
+         * @brief Match either of two fragments.
+         * @param[in] l The left operand.
+         * @param[in] r The right operand.
+         * @returns The union.
+         */
+        static constexpr fragment either(const fragment& l, const fragment& r) noexcept
+        {
+          return {join(l.first, r.first), join(l.last, r.last), l.nullable || r.nullable};
+        }
+
+        /**
+         * @brief Match no string at all.
+         * @returns The neutral element of `either`.
+         */
+        static constexpr fragment nothing() noexcept
+        {
+          fragment result;
+          result.nullable = false;
+          return result;
+        }
+
+        /**
+         * @brief Match between `min` and `max` instances of a fragment built on demand.
+         * @tparam Builder A callable type `fragment ()` adding a fresh copy of the fragment.
+         * @param[in] build Adds a fresh copy of the fragment.
+         * @param[in] min Least number of instances.
+         * @param[in] max Most number of instances, `Tok::impl::unbounded` for no limit.
+         * @returns The repetition.
+         */
+        template<typename Builder>
+          constexpr fragment repeat(const Builder& build, std::size_t min, std::size_t max) noexcept
+          {
+            fragment result;
+            if (max == unbounded) {
+              for (std::size_t i = 1; i < min && !overflow; i++)
+                result = concat(result, build());
+              auto tail = build();
+              link(tail, tail.first);
+              tail.nullable = tail.nullable || min == 0;
+              return concat(result, tail);
+            }
+            for (std::size_t i = 0; i < max && !overflow; i++) {
+              auto instance = build();
+              instance.nullable = instance.nullable || i >= min;
+              result = concat(result, instance);
+            }
+            return result;
+          }
+
+        /**
+         * @brief Add a character class.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        constexpr fragment add(const single_char<char_set, mapper::none_t>& t) noexcept
+        {
+          return position(t.pred);
+        }
+
+        /**
+         * @brief Add a literal.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        constexpr fragment add(const literal<mapper::none_t>& t) noexcept
+        {
+          fragment result;
+          for (const auto c : t.str)
+            result = concat(result, position(char_set::of(c)));
+          return result;
+        }
+
+        /**
+         * @brief Add a case-insensitive literal.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        constexpr fragment add(const iliteral<mapper::none_t>& t) noexcept
+        {
+          fragment result;
+          for (const auto c : t.str)
+            result = concat(result, position(both_cases(c)));
+          return result;
+        }
+
+        /**
+         * @brief Add a keyword set.
+         * @tparam K Number of keywords.
+         * @tparam Ignore_case `true` if the case of ASCII letters is ignored.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        template<std::size_t K, bool Ignore_case>
+          constexpr fragment add(const keywords<K, mapper::none_t, Ignore_case>& t) noexcept
+          {
+            using word = std::conditional_t<Ignore_case, iliteral<mapper::none_t>, literal<mapper::none_t>>;
+            auto result = nothing();
+            for (std::size_t i = 0; i < K; i++)
+              result = either(result, add(word{t.keyword(i), {}}));
+            return result;
+          }
+
+        /**
+         * @brief Add a fused repetition.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        constexpr fragment add(const span_repetition<span_kernel, mapper::none_t>& t) noexcept
+        {
+          const auto set = t.span.members();
+          return repeat([this, &set]() { return position(set); }, t.min, t.max);
+        }
+
+        /**
+         * @brief Add a repetition.
+         * @tparam Tokenizer The repeated tokenizer.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        template<typename Tokenizer>
+          constexpr fragment add(const repetition<Tokenizer, mapper::none_t>& t) noexcept
+          {
+            return repeat([this, &t]() { return add(t.tokenizer); }, t.min, t.max);
+          }
+
+        /**
+         * @brief Add an option.
+         * @tparam Tokenizer The optional tokenizer.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        template<typename Tokenizer>
+          constexpr fragment add(const option<Tokenizer, mapper::none_t>& t) noexcept
+          {
+            auto result = add(t.tokenizer);
+            result.nullable = true;
+            return result;
+          }
+
+        /**
+         * @brief Add a sequence.
+         * @tparam Tokenizers The parts of the sequence.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        template<typename... Tokenizers>
+          constexpr fragment add(const sequence<Tokenizers...>& t) noexcept
+          {
+            return std::apply([this](const auto& head, const auto&... rest) {
+                auto result = add(head);
+                ((result = concat(result, add(rest))), ...);
+                return result;
+              }, t.parts);
+          }
+
+        /**
+         * @brief Add an alternation.
+         * @tparam Tokenizers The branches of the alternation.
+         * @param[in] t The tokenizer.
+         * @returns Its fragment.
+         */
+        template<typename... Tokenizers>
+          constexpr fragment add(const alternation<Tokenizers...>& t) noexcept
+          {
+            return std::apply([this](const auto&... branches) {
+                auto result = nothing();
+                ((result = either(result, add(branches))), ...);
+                return result;
+              }, t.options());
+          }
+      };
+
+    /**
+     * @brief A tokenizer that runs a minimized DFA, compiled from a regular tokenizer.
+     * @details The DFA finds the longest prefix of the input in the language of the tokenizer
+     * with one table lookup per character and no backtracking. Characters that no position tells
+     * apart share a column of the transition table.
+     * @tparam N Most positions, states and distinct character classes.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     */
+    template<std::size_t N, typename Map>
+      class dfa {
+        public:
+          /**
+           * @brief Compile a regular tokenizer.
+           * @tparam Tokenizer A type for which `Tok::impl::is_regular` holds.
+           * @param[in] tokenizer The tokenizer to be compiled.
+           * @param[in] func A callable object of type `Map`.
+           */
+          template<typename Tokenizer>
+            constexpr dfa(const Tokenizer& tokenizer, Map func) noexcept : func(std::move(func))
+            {
+              position_automaton<N> positions;
+              const auto root = positions.add(tokenizer);
+              if (!positions.overflow)
+                build(positions, root);
+              if (!valid)
+                dfa_capacity_exceeded();
+            }
+
+          /**
+           * @brief Attempt to match the longest prefix of the input in the language of the tokenizer.
+           * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+           * @returns The extracted token or `std::nullopt` on a mismatch.
+           */
+          constexpr Token operator()(Input& input) const
+          {
+            auto current = start;
+            std::size_t size = accepting[current] ? 0 : unbounded;
+            for (std::size_t i = 0; i < input.size(); i++) {
+              current = next[current][classes[static_cast<unsigned char>(input[i])]];
+              if (current == dead)
+                break;
+              if (accepting[current])
+                size = i + 1;
+            }
+            if (size == unbounded)
+              return {};
+            const Token_view token(input.substr(0, size));
+            func(token);
+            input.remove_prefix(size);
+            return {token};
+          }
+
+          /**
+           * @brief Check if the tokenizer fit in the capacity of the DFA.
+           * @retval true The DFA was built.
+           * @retval false The tokenizer needs more than `N` positions, states or character classes.
+           * The DFA then matches nothing.
+           */
+          constexpr bool is_valid() const noexcept
+          {
+            return valid;
+          }
+
+          /**
+           * @brief Count the states of the minimized DFA.
+           * @returns Number of states, including the dead state.
+           */
+          constexpr std::size_t states() const noexcept
+          {
+            return count;
+          }
+
+          /**
+           * @brief Compute the FIRST set of the tokenizer.
+           * @returns The characters on which the start state does not go to the dead state,
+           * nullable if the start state ends a match.
+           */
+          constexpr first_set first() const noexcept
+          {
+            first_set result{char_set{}, accepting[start]};
+            for (unsigned c = 0; c < 256; c++)
+              if (next[start][classes[c]] != dead)
+                result.chars.insert(static_cast<char>(c));
+            return result;
+          }
+
+          /** Progress of a resumable DFA match. */
+          struct state {
+            bool started = false;           /**< `true` once the match has begun. */
+            std::size_t scanned = 0;        /**< Number of characters scanned. */
+            std::size_t current = 0;        /**< The current state. */
+            std::size_t size = unbounded;   /**< Size of the longest match so far. */
+          };
+
+          /**
+           * @brief Match the tokenizer over input that may be incomplete.
+           * @details Only the characters received since the last call are scanned.
+           * @param[in] input The input from the start of the match up to the last character received.
+           * @param[out] size Size of the token on a match.
+           * @param[in,out] progress Progress of the match so far.
+           * @param[in] end_of_input `true` if no more input will follow.
+           * @returns The outcome of the match.
+           */
+          constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+          {
+            if (!progress.started)
+              progress = {true, 0, start, accepting[start] ? 0 : unbounded};
+            for (; progress.current != dead && progress.scanned < input.size(); progress.scanned++) {
+              progress.current = next[progress.current][classes[static_cast<unsigned char>(input[progress.scanned])]];
+              if (accepting[progress.current])
+                progress.size = progress.scanned + 1;
+            }
+            if (progress.current != dead && !end_of_input)
+              return match_status::incomplete;
+            const auto token_size = progress.size;
+            progress = {};
+            if (token_size == unbounded)
+              return match_status::mismatched;
+            func(input.substr(0, token_size));
+            size = token_size;
+            return match_status::matched;
+          }
+
+        private:
+          /** Index of a state or a character class, wide enough for all of them. */
+          using state_type = std::conditional_t<(N <= 256), std::uint8_t, std::uint16_t>;
+
+          /** One bit per position. */
+          using bits = typename position_automaton<N>::bits;
+
+          /**
+           * @brief Build the DFA by subset construction, then minimize it.
+           * @param[in] positions The position automaton of the tokenizer.
+           * @param[in] root The fragment of the whole tokenizer.
+           */
+          constexpr void build(const position_automaton<N>& positions,
+              const typename position_automaton<N>::fragment& root) noexcept
+          {
+            // Characters accepted by the same positions form one class
+            bits members[256] = {};
+            for (unsigned c = 0; c < 256; c++)
+              for (std::size_t p = 0; p < positions.count; p++)
+                if (positions.chars[p].contains(static_cast<char>(c)))
+                  members[c][p / 64] |= std::uint64_t{1} << (p % 64);
+            unsigned char representative[N] = {};
+            for (unsigned c = 0; c < 256; c++) {
+              std::size_t k = 0;
+              while (k < alphabet && !position_automaton<N>::same(members[representative[k]], members[c]))
+                k++;
+              if (k == alphabet) {
+                if (alphabet == N)
+                  return;
+                representative[alphabet++] = static_cast<unsigned char>(c);
+              }
+              classes[c] = static_cast<state_type>(k);
+            }
+
+            // State 0 is the dead state, the empty set of positions, and state 1 is the start state
+            bits sets[N] = {};
+            bool accepts[N] = {};
+            state_type table[N][N] = {};
+            std::size_t total = 2;
+            for (std::size_t s = 1; s < total; s++) {
+              auto follows = s == 1 ? root.first : bits{};
+              accepts[s] = s == 1 && root.nullable;
+              for (std::size_t p = 0; s != 1 && p < positions.count; p++)
+                if (position_automaton<N>::has(sets[s], p)) {
+                  follows = position_automaton<N>::join(follows, positions.follow[p]);
+                  accepts[s] = accepts[s] || position_automaton<N>::has(root.last, p);
+                }
+              for (std::size_t k = 0; k < alphabet; k++) {
+                bits target{};
+                for (std::size_t w = 0; w < target.size(); w++)
+                  target[w] = follows[w] & members[representative[k]][w];
+                std::size_t t = 0;
+                while (t < total && (t == 1 || !position_automaton<N>::same(sets[t], target)))
+                  t++;
+                if (t == total) {
+                  if (total == N)
+                    return;
+                  sets[total++] = target;
+                }
+                table[s][k] = static_cast<state_type>(t);
+              }
+            }
+
+            // Moore's algorithm: split groups of states until all states of a group are equivalent
+            std::size_t group[N] = {};
+            for (std::size_t s = 0; s < total; s++)
+              group[s] = accepts[s] ? 1 : 0;
+            for (std::size_t previous = 0; ; previous = count) {
+              std::size_t refined[N] = {};
+              std::size_t leader[N] = {};
+              count = 0;
+              for (std::size_t s = 0; s < total; s++) {
+                std::size_t g = 0;
+                for (; g < count; g++) {
+                  const auto l = leader[g];
+                  bool same = group[l] == group[s];
+                  for (std::size_t k = 0; same && k < alphabet; k++)
+                    same = group[table[l][k]] == group[table[s][k]];
+                  if (same)
+                    break;
+                }
+                if (g == count)
+                  leader[count++] = s;
+                refined[s] = g;
+              }
+              for (std::size_t s = 0; s < total; s++)
+                group[s] = refined[s];
+              if (count == previous)
+                break;
+            }
+
+            for (std::size_t s = 0; s < total; s++) {
+              accepting[group[s]] = accepts[s];
+              for (std::size_t k = 0; k < alphabet; k++)
+                next[group[s]][k] = static_cast<state_type>(group[table[s][k]]);
+            }
+            dead = static_cast<state_type>(group[0]);
+            start = static_cast<state_type>(group[1]);
+            valid = true;
+          }
+
+          Map func;                       /**< Further processes / maps the extracted token. */
+          state_type classes[256] = {};   /**< Column of the transition table, by character. */
+          state_type next[N][N] = {};     /**< Transitions, by state and character class. */
+          bool accepting[N] = {};         /**< `true` for states that end a match. */
+          std::size_t alphabet = 0;       /**< Number of character classes. */
+          std::size_t count = 0;          /**< Number of states. */
+          state_type dead = 0;            /**< The state no match can leave. */
+          state_type start = 0;           /**< The state every match starts in. */
+          bool valid = false;             /**< `true` if the tokenizer fit in the capacity. */
+      };
+
+    /**
+     * @brief Specialization for compiled DFAs, whose Map is called on success only.
+     * @tparam N Most positions, states and distinct character classes.
+     * @tparam Map A callable type `void (Tok::Token_view)`.
+     */
+    template<std::size_t N, typename Map>
+      struct has_deferred_map<dfa<N, Map>> : has_deferred_map<Map> {};
+
+    /**
+     * @brief A lexer that picks the longest match among several rules.
+     * @details At each position only the rules whose FIRST set contains the next character are
+     * tried. The longest non-empty match wins and ties go to the rule declared first.
+     * @tparam Tokenizers The tokenizers of the rules, in order of priority.
+     */
+    template<typename... Tokenizers>
+      class lexer {
+        public:
+          /**
+           * @brief Create a lexer and its dispatch table.
+           * @param[in] ids The identifiers of the rules.
+           * @param[in] rules The tokenizers of the rules, in order of priority.
+           */
+          constexpr lexer(const std::array<std::size_t, sizeof...(Tokenizers)>& ids,
+              std::tuple<Tokenizers...> rules) noexcept :
+            ids(ids), rules(std::move(rules))
+          {
+            build(std::index_sequence_for<Tokenizers...>{});
+          }
+
+          /**
+           * @brief Extract the longest token at the start of the input.
+           * @param[in,out] input The input to the lexer. It is consumed by the winning rule.
+           * @param[out] id Identifier of the winning rule on a match.
+           * @returns The token of the winning rule or `std::nullopt` if no rule matches a non-empty token.
+           */
+          constexpr Token match(Input& input, std::size_t& id) const
+          {
+            if (input.empty())
+              return {};
+            std::size_t best = 0;
+            std::size_t winner = count;
+            mask_type mask = 0;
+            if constexpr (count <= max_dispatch)
+              mask = dispatch[static_cast<unsigned char>(input[0])];
+            attempt(input, mask, best, winner, std::index_sequence_for<Tokenizers...>{});
+            if (winner == count)
+              return {};
+            id = ids[winner];
+            const auto token = input.substr(0, best);
+            input.remove_prefix(best);
+            return token;
+          }
+
+          /**
+           * @brief Split the input into tokens.
+           * @details Lexing stops at the end of the input or at the first position where no rule
+           * matches a non-empty token.
+           * @tparam Sink A callable type `void (Tok::token_record)`.
+           * @param[in] input The input to the lexer.
+           * @param[in] emit Called with every token, in order.
+           * @returns The input that could not be lexed, empty if all of it was.
+           */
+          template<typename Sink>
+            constexpr Input operator()(Input input, Sink&& emit) const
+            {
+              const auto base = input.data();
+              std::size_t id = 0;
+              while (const auto token = match(input, id))
+                emit(token_record{id, static_cast<std::size_t>((*token).data() - base), (*token).size()});
+              return input;
+            }
+
+        private:
+          static constexpr std::size_t count = sizeof...(Tokenizers); /**< Number of rules. */
+          static constexpr std::size_t max_dispatch = 64;             /**< Most rules covered by the dispatch table. */
+
+          /** One bit per rule, wide enough for all of them. */
+          using mask_type = std::conditional_t<(count <= 8), std::uint8_t,
+                std::conditional_t<(count <= 16), std::uint16_t,
+                std::conditional_t<(count <= 32), std::uint32_t, std::uint64_t>>>;
+
+          /**
+           * @brief Check if a rule can match at the current position.
+           * @tparam I Index of the rule.
+           * @param[in] mask One bit per rule that can match.
+           * @retval true The rule has to be tried.
+           * @retval false The rule cannot match.
+           */
+          template<std::size_t I>
+            static constexpr bool selected(mask_type mask) noexcept
+            {
+              if constexpr (count > max_dispatch)
+                return true;
+              else
+                return (mask >> I) & 1;
+            }
+
+          /**
+           * @brief Apply one rule and keep its match if it is the longest so far.
+           * @tparam I Index of the rule.
+           * @param[in] input The input to the rule.
+           * @param[in,out] best Size of the longest match so far.
+           * @param[in,out] winner Index of the rule with the longest match so far.
+           */
+          template<std::size_t I>
+            constexpr void probe(Input input, std::size_t& best, std::size_t& winner) const
+            {
+              if (const auto token = std::get<I>(rules)(input); token && (*token).size() > best) {
+                best = (*token).size();
+                winner = I;
+              }
+            }
+
+          /**
+           * @brief Apply the rules selected by a mask, in order.
+           * @tparam Is Indices of the rules.
+           * @param[in] input The input to the rules.
+           * @param[in] mask One bit per rule that can match.
+           * @param[in,out] best Size of the longest match so far.
+           * @param[in,out] winner Index of the rule with the longest match so far.
+           * @param[in] indices The indices of all rules.
+           */
+          template<std::size_t... Is>
+            constexpr void attempt(Input input, mask_type mask, std::size_t& best, std::size_t& winner,
+                std::index_sequence<Is...> indices) const
+            {
+              ((selected<Is>(mask) && (probe<Is>(input, best, winner), true)), ...);
+            }
+
+          /**
+           * @brief Compute the dispatch table from the FIRST sets of the rules.
+           * @tparam Is Indices of the rules.
+           * @param[in] indices The indices of all rules.
+           */
+          template<std::size_t... Is>
+            constexpr void build(std::index_sequence<Is...> indices) noexcept
+            {
+              if constexpr (count <= max_dispatch) {
+                const first_set firsts[] = {first_of(std::get<Is>(rules))...};
+                for (std::size_t i = 0; i < count; i++) {
+                  const auto bit = static_cast<mask_type>(std::uint64_t{1} << i);
+                  for (unsigned c = 0; c < 256; c++)
+                    if (firsts[i].chars.contains(static_cast<char>(c)))
+                      dispatch[c] = static_cast<mask_type>(dispatch[c] | bit);
+                }
+              }
+            }
+
+          std::array<std::size_t, count> ids;  /**< Identifiers of the rules. */
+          std::tuple<Tokenizers...> rules;     /**< The tokenizers of the rules. */
+          mask_type dispatch[256] = {};        /**< Rules that can match, by first character. */
+      };
+
+    /**
+     * @brief The absence of a tokenizer, for skippers that only skip runs of characters.
+     */
+    struct nothing_else {};
+
+    /**
+     * @brief Skips what a grammar allows between its elements, such as whitespace and comments.
+     * @details Runs of characters out of a set are skipped with a `Tok::impl::span_kernel`. The
+     * other matches it skips, e.g. comments, are tried after every run, until nothing is left to skip.
+     * @tparam Rest A callable type `Tok::Token (Tok::Input& input)` matching what is skipped
+     * besides the runs of characters, or `Tok::impl::nothing_else`.
+     */
+    template<typename Rest>
+      struct skipper {
+        span_kernel blanks;   /**< Spans the characters that are skipped. */
+        Rest rest;            /**< Matches the other skipped text. */
+
+        /**
+         * @brief Skip everything that can be skipped at the start of the input.
+         * @param[in,out] input The input. It is consumed up to the first character that cannot be skipped.
+         */
+        constexpr void operator()(Input& input) const
+        {
+          while (true) {
+            if (!input.empty() && blanks.members().contains(input[0]))
+              input.remove_prefix(blanks(input));
+            if constexpr (!std::is_same_v<Rest, nothing_else>) {
+              auto after = input;
+              if (rest(after) && after.size() < input.size()) {
+                input = after;
+                continue;
+              }
+            }
+            return;
+          }
+        }
+
+        /**
+         * @brief Describe the characters skipped text can start with.
+         * @returns The characters of the runs and the FIRST set of the other skipped text.
+         */
+        constexpr char_set starts() const noexcept
+        {
+          if constexpr (std::is_same_v<Rest, nothing_else>)
+            return blanks.members();
+          else
+            return blanks.members() | first_of(rest).chars;
+        }
+      };
+
+    /**
+     * @brief Check if a skipper tokenizer skips a run of characters out of a set.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct is_blank : std::false_type {};
+
+    /**
+     * @brief Specialization for Map-less character set matchers.
+     */
+    template<>
+      struct is_blank<single_char<char_set, mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief Specialization for Map-less repetitions of character set matchers.
+     */
+    template<>
+      struct is_blank<span_repetition<span_kernel, mapper::none_t>> : std::true_type {};
+
+    /**
+     * @brief Extract the set of characters a skipper tokenizer skips runs of.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @returns The set if `Tokenizer` skips runs of characters, an empty set otherwise.
+     */
+    template<typename Tokenizer>
+      constexpr char_set blank_set(const Tokenizer& tokenizer) noexcept
+      {
+        if constexpr (std::is_same_v<Tokenizer, single_char<char_set, mapper::none_t>>)
+          return tokenizer.pred;
+        else if constexpr (std::is_same_v<Tokenizer, span_repetition<span_kernel, mapper::none_t>>)
+          return tokenizer.span.members();
+        else
+          return {};
+      }
+
+    /**
+     * @brief Keep a branch of a skipper tokenizer unless it skips runs of characters.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @returns An empty tuple for runs of characters, a tuple of `tokenizer` otherwise.
+     */
+    template<typename Tokenizer>
+      constexpr auto unless_blank(const Tokenizer& tokenizer) noexcept
+      {
+        if constexpr (is_blank<Tokenizer>::value)
+          return std::tuple<>{};
+        else
+          return std::tuple<Tokenizer>(tokenizer);
+      }
+
+    /**
+     * @brief Create the skipper for a tokenizer describing what a grammar allows between its elements.
+     * @details The branches of an alternation that skip runs of characters out of a set are fused
+     * into a single span kernel over the union of their sets. The other branches are kept as an
+     * alternation.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @returns A `Tok::impl::skipper`.
+     */
+    template<typename Tokenizer>
+      constexpr auto make_skipper(const Tokenizer& tokenizer) noexcept
+      {
+        if constexpr (is_blank<Tokenizer>::value) {
+          return skipper<nothing_else>{span_kernel(blank_set(tokenizer)), {}};
+        } else if constexpr (is_alternation<Tokenizer>::value) {
+          const auto branches = tokenizer.options();
+          const auto blanks = std::apply([](const auto&... branch) {
+              return (blank_set(branch) | ...);
+            }, branches);
+          auto others = std::apply([](const auto&... branch) {
+              return std::tuple_cat(unless_blank(branch)...);
+            }, branches);
+          if constexpr (std::tuple_size_v<decltype(others)> == 0)
+            return skipper<nothing_else>{span_kernel(blanks), {}};
+          else
+            return skipper<decltype(make_alternation(std::move(others)))>{span_kernel(blanks),
+              make_alternation(std::move(others))};
+        } else {
+          return skipper<Tokenizer>{span_kernel(char_set{}), tokenizer};
+        }
+      }
+
+    /**
+     * @brief A tokenizer that skips what can be skipped before matching another one.
+     * @details It is put between the elements of a grammar by `Tok::skip`. The skipped text is not
+     * part of the token, but it is part of the match of an enclosing sequence or repetition.
+     * @tparam Skipper A `Tok::impl::skipper`.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Skipper, typename Tokenizer>
+      struct gap {
+        Skipper skip;         /**< Skips the text before the tokenizer. */
+        Tokenizer tokenizer;  /**< The tokenizer. */
+
+        /**
+         * @brief Skip, then attempt to match the tokenizer.
+         * @param[in,out] input The input to the tokenizer. It is left untouched on a mismatch.
+         * @returns The token of the tokenizer or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          auto rest = input;
+          skip(rest);
+          const auto token = tokenizer(rest);
+          if (token)
+            input = rest;
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the tokenizer, along with the characters skipped text starts with.
+         */
+        constexpr first_set first() const noexcept
+        {
+          const auto inner = first_of(tokenizer);
+          return {inner.chars | skip.starts(), inner.nullable};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns At least the narrowest match of the tokenizer, with no upper bound.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return {width_of(tokenizer).min, unbounded};
+        }
+      };
+
+    /**
+     * @brief A tokenizer within which nothing is skipped.
+     * @details Outside of `Tok::skip`, it is the same as the tokenizer it wraps.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct lexeme {
+        Tokenizer tokenizer;  /**< The tokenizer. */
+
+        /**
+         * @brief Attempt to match the tokenizer at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          return tokenizer(input);
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the wrapped tokenizer.
+         */
+        constexpr first_set first() const noexcept
+        {
+          return first_of(tokenizer);
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns The widths of the wrapped tokenizer.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return width_of(tokenizer);
+        }
+
+        /** Progress of the wrapped tokenizer. */
+        using state = state_of_t<Tokenizer>;
+
+        /**
+         * @brief Match the tokenizer over input that may be incomplete.
+         * @param[in] input The input from the start of the match up to the last character received.
+         * @param[out] size Size of the token on a match.
+         * @param[in,out] progress Progress of the match so far.
+         * @param[in] end_of_input `true` if no more input will follow.
+         * @returns The outcome of the match.
+         */
+        constexpr match_status resume(Input input, std::size_t& size, state& progress, bool end_of_input) const
+        {
+          return resume_tokenizer(tokenizer, input, size, progress, end_of_input);
+        }
+      };
+
+    /**
+     * @brief Check if a type is a node that `Tok::skip` rewrites by its kind.
+     * @tparam Tokenizer The type to be checked.
+     * @tparam Node The kind of node.
+     */
+    template<typename Tokenizer, template<typename...> class Node>
+      struct is_node : std::false_type {};
+
+    /**
+     * @brief Specialization for nodes of the kind.
+     * @tparam Node The kind of node.
+     * @tparam Parts The types the node is made of.
+     */
+    template<template<typename...> class Node, typename... Parts>
+      struct is_node<Node<Parts...>, Node> : std::true_type {};
+
+    /**
+     * @brief Put a skipper between the elements of a tokenizer.
+     * @details The skipper runs before every part of a sequence but the first and before every
+     * instance of a repetition, inside alternations, options and Maps too. Transactions, memoized,
+     * profiled and diagnosed tokenizers are rebuilt around their rewritten tokenizer, so that they
+     * match what they would without them. Lexemes are unwrapped and left as they are, and so are
+     * the other tokenizers, e.g. runs of characters, literals and rules.
+     * @tparam Skipper A `Tok::impl::skipper`.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] skip The skipper.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @returns The rewritten tokenizer.
+     */
+    template<typename Skipper, typename Tokenizer>
+      constexpr auto with_skipper(const Skipper& skip, const Tokenizer& tokenizer) noexcept
+      {
+        if constexpr (is_sequence<Tokenizer>::value) {
+          return std::apply([&skip](const auto& head, const auto&... tail) {
+              return make_sequence(std::tuple_cat(std::tuple(with_skipper(skip, head)),
+                    std::tuple(gap<Skipper, decltype(with_skipper(skip, tail))>{skip, with_skipper(skip, tail)})...));
+            }, tokenizer.parts);
+        } else if constexpr (is_alternation<Tokenizer>::value) {
+          return std::apply([&skip](const auto&... branch) {
+              return make_alternation(std::tuple(with_skipper(skip, branch)...));
+            }, tokenizer.options());
+        } else if constexpr (is_node<Tokenizer, repetition>::value) {
+          using instance = gap<Skipper, decltype(with_skipper(skip, tokenizer.tokenizer))>;
+          repetition<instance, decltype(tokenizer.func)> result{
+            {}, instance{skip, with_skipper(skip, tokenizer.tokenizer)}, tokenizer.func, tokenizer.min, tokenizer.max};
+          cache_shortest(result);
+          return result;
+        } else if constexpr (is_node<Tokenizer, option>::value) {
+          using inner = decltype(with_skipper(skip, tokenizer.tokenizer));
+          return option<inner, decltype(tokenizer.func)>{with_skipper(skip, tokenizer.tokenizer), tokenizer.func};
+        } else if constexpr (is_node<Tokenizer, adaptive_alternation>::value) {
+          return std::apply([&skip, &tokenizer](const auto&... branch) {
+              return make_adaptive_alternation(std::tuple(with_skipper(skip, branch)...), tokenizer.statistics());
+            }, tokenizer.options());
+        } else if constexpr (is_node<Tokenizer, mapped>::value) {
+          using inner = decltype(with_skipper(skip, tokenizer.tokenizer));
+          return mapped<inner, decltype(tokenizer.func)>{with_skipper(skip, tokenizer.tokenizer), tokenizer.func};
+        } else if constexpr (is_node<Tokenizer, transaction>::value) {
+          using inner = decltype(with_skipper(skip, tokenizer.tokenizer));
+          return transaction<inner>{with_skipper(skip, tokenizer.tokenizer), tokenizer.log};
+        } else if constexpr (is_node<Tokenizer, memoized>::value) {
+          using inner = decltype(with_skipper(skip, tokenizer.tokenizer));
+          return memoized<inner>{with_skipper(skip, tokenizer.tokenizer), tokenizer.cache,
+            memo_cache::skipped_rule(tokenizer.rule)};
+#if defined(LEXTOK_PROFILE)
+        } else if constexpr (is_node<Tokenizer, profiled>::value) {
+          using inner = decltype(with_skipper(skip, tokenizer.tokenizer));
+          return profiled<inner>{with_skipper(skip, tokenizer.tokenizer), tokenizer.counters};
+#endif
+#if defined(LEXTOK_TRACK_FAILURES)
+        } else if constexpr (is_node<Tokenizer, diagnosed>::value) {
+          using inner = decltype(with_skipper(skip, tokenizer.tokenizer));
+          return diagnosed<inner>{with_skipper(skip, tokenizer.tokenizer), tokenizer.context};
+        } else if constexpr (is_node<Tokenizer, named>::value) {
+          using inner = decltype(with_skipper(skip, tokenizer.tokenizer));
+          return named<inner>{with_skipper(skip, tokenizer.tokenizer), tokenizer.name};
+#endif
+        } else if constexpr (is_node<Tokenizer, lexeme>::value) {
+          return tokenizer.tokenizer;
+        } else {
+          return tokenizer;
+        }
+      }
+
+    /**
+     * @brief A tokenizer whose elements may be separated by skipped text.
+     * @tparam Skipper A `Tok::impl::skipper`.
+     * @tparam Tokenizer The tokenizer, with the skipper put between its elements.
+     */
+    template<typename Skipper, typename Tokenizer>
+      struct skipping {
+        Skipper skip;         /**< Skips the text around and between the elements. */
+        Tokenizer tokenizer;  /**< The rewritten tokenizer. */
+
+        /**
+         * @brief Skip, match the tokenizer, then skip again.
+         * @param[in,out] input The input to the tokenizer. It is consumed up to the first character
+         * after the match that cannot be skipped, or left untouched on a mismatch.
+         * @returns The token, without the skipped text before and after it, or `std::nullopt` on a mismatch.
+         */
+        constexpr Token operator()(Input& input) const
+        {
+          auto rest = input;
+          skip(rest);
+          const auto token = tokenizer(rest);
+          if (!token)
+            return {};
+          skip(rest);
+          input = rest;
+          return token;
+        }
+
+        /**
+         * @brief Compute the FIRST set of the tokenizer.
+         * @returns The FIRST set of the tokenizer, along with the characters skipped text starts with.
+         */
+        constexpr first_set first() const noexcept
+        {
+          const auto inner = first_of(tokenizer);
+          return {inner.chars | skip.starts(), inner.nullable};
+        }
+
+        /**
+         * @brief Compute the widths of the matches of the tokenizer.
+         * @returns At least the narrowest match of the tokenizer, with no upper bound.
+         */
+        constexpr match_width width() const noexcept
+        {
+          return {width_of(tokenizer).min, unbounded};
+        }
+      };
+  }
+
+  /**
+   * @brief Create a tokenizer that matches lower and upper case alphabets.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches an alphabet [a-zA-Z] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto alphabet(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::alphabet, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches only lower case alphabets.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a lower case alphabet [a-z] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto lower_alphabet(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::lower_alphabet, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches only upper case alphabets.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches an upper case alphabet [A-Z] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto upper_alphabet(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::upper_alphabet, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches only decimal digits.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a decimal digit [0-9] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto digit(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::digit, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches only hexadecimal digits.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a hexadecimal digit [a-fA-F0-9] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto hex_digit(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::hex_digit, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches whitespace.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a whitespace [ \\t\\r\\n] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto whitespace(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::whitespace, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches any 8-bit character.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches an 8-bit character [.] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto any(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::any, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a newline character.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a newline characters [\\r\\n] as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto newline(Map&& func = mapper::none_t{}) noexcept
+    {
+      return impl::single_char_tokenizer(char_class::newline, func);
+    }
+
+  /**
+   * @brief Create a tokenizer to match a character.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] c Character to be matched.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches the character specified, as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto char_token(char c, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::single_char_tokenizer(char_set::of(c), func);
+    }
+
+  /**
+   * @brief Create a tokenizer to match a literal string pointed to by 'str'.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] str A view into the string that needs to be extracted into a token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches the given string as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto str_token(Predicate str, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::literal<std::decay_t<Map>>{str, std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Create a tokenizer to match a literal string, ignoring the case of ASCII letters.
+   * @details Characters are compared 8 at a time with a mask of the case bit of the letters of
+   * the literal, so that folding case costs about as much as an exact comparison. The token
+   * keeps the spelling of the input.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] str A view into the string that needs to be extracted into a token, e.g. `"AT+CSQ"`.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches the given string in any case as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto istr_token(Predicate str, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::iliteral<std::decay_t<Map>>{str, std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches the longest out of a set of literal strings.
+   * @details This replaces a chain of Tok::str_token alternatives. The input is scanned once,
+   * rather than once per keyword, and the longest keyword wins instead of the first one listed.
+   * The index of the matched keyword is passed to `func`, so that it can be switched upon
+   * without comparing strings again. If a keyword appears more than once, the lowest index
+   * is reported.
+   * @tparam N Number of keywords.
+   * @tparam Indexed_Map A callable type `void (std::size_t index, Tok::Token_view)`. It is called
+   * on the extracted token.
+   * @param[in] list The keywords to be matched, e.g. `{"AT+CGPADDR", "AT+CSQ"}`.
+   * @param[in] func A callable object of type `Indexed_Map`.
+   * @returns A tokenizer that matches the longest keyword as a token.
+   */
+  template<std::size_t N, typename Indexed_Map = mapper::none_t>
+    constexpr auto keyword_set(const Predicate (&list)[N], Indexed_Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_INDEXED_MAP_TYPE(Indexed_Map);
+      return impl::keywords<N, std::decay_t<Indexed_Map>>(list, std::forward<Indexed_Map>(func));
+    }
+
+  /**
+   * @brief Create a tokenizer that matches the longest out of a set of literal strings, ignoring
+   * the case of ASCII letters.
+   * @details It works like `Tok::keyword_set`, with keywords sorted and searched by their lower
+   * case spelling. Keywords that only differ in case are duplicates.
+   * @tparam N Number of keywords.
+   * @tparam Indexed_Map A callable type `void (std::size_t index, Tok::Token_view)`. It is called
+   * on the extracted token.
+   * @param[in] list The keywords to be matched, e.g. `{"OK", "ERROR"}`.
+   * @param[in] func A callable object of type `Indexed_Map`.
+   * @returns A tokenizer that matches the longest keyword in any case as a token.
+   */
+  template<std::size_t N, typename Indexed_Map = mapper::none_t>
+    constexpr auto ikeyword_set(const Predicate (&list)[N], Indexed_Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_INDEXED_MAP_TYPE(Indexed_Map);
+      return impl::keywords<N, std::decay_t<Indexed_Map>, true>(list, std::forward<Indexed_Map>(func));
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a single character out of the group of characters provided.
+   * @details The group is converted into a `Tok::char_set`, so every character is tested with a
+   * single table lookup.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] char_group A view into the group of characters that could be matched.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches any of the characters (only one) in the group as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto any_of(Predicate char_group, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::single_char_tokenizer(char_set(char_group), func);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a single character out of a character set.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] set The set of characters that could be matched.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches any of the characters (only one) in the set as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto any_of(const char_set& set, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::single_char_tokenizer(set, func);
+    }
+
+  /**
+   * @brief Create a tokenizer that will match a character **not** in the group of characters provided.
+   * @details The group is converted into a complemented `Tok::char_set`, so every character is
+   * tested with a single table lookup.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] char_group A view into the group of characters that will not be matched.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a character **not** in the group of characters, as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto none_of(Predicate char_group, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::single_char_tokenizer(~char_set(char_group), func);
+    }
+
+  /**
+   * @brief Create a tokenizer that will match a character **not** in a character set.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] set The set of characters that will not be matched.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a character **not** in the set, as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto none_of(const char_set& set, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::single_char_tokenizer(~set, func);
+    }
+
+  namespace utf8 {
+    /**
+     * @brief Create a tokenizer that matches a single UTF-8 encoded code point out of a set.
+     * @details The input is matched in place, without transcoding. Invalid, overlong and truncated
+     * encodings never match. Repetitions of a Map-less code point matcher skip runs of ASCII
+     * members with the same vectorized kernel as character sets, and only decode the other bytes.
+     * Their bounds count code points.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     * @param[in] set The code points that could be matched.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of one member of the set as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto any_of(const code_point_set& set, Map&& func = mapper::none_t{}) noexcept
+      {
+        VALIDATE_MAP_TYPE(Map);
+        return impl::utf8_char<std::decay_t<Map>>{set, std::forward<Map>(func)};
+      }
+
+    /**
+     * @brief Create a tokenizer that matches a single UTF-8 encoded code point in a range.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     * @param[in] first The first code point of the range.
+     * @param[in] last The last code point of the range.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of a code point in [first, last] as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto range(char32_t first, char32_t last, Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf8::any_of(code_point_set::range(first, last), std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches a letter, encoded in UTF-8.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of a member of `Tok::utf8::letters` as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto letter(Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf8::any_of(letters, std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches any valid UTF-8 encoded code point.
+     * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of a code point as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto code_point(Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf8::any_of(any, std::forward<Map>(func));
+      }
+  }
+
+  namespace impl {
+    /**
+     * @brief Call a Map on a token, unless it is the default no-op Map.
+     * @details Tokenizers over characters other than `char` use it, as `Tok::mapper::none_t`
+     * only accepts `Tok::Token_view`.
+     * @tparam Map A callable type `void (Tok::basic_input<CharT>)`.
+     * @tparam CharT The character type.
+     * @param[in] func The Map.
+     * @param[in] token The extracted token.
+     */
+    template<typename Map, typename CharT>
+      constexpr void apply_map(const Map& func, basic_input<CharT> token)
+      {
+        if constexpr (!std::is_same_v<Map, mapper::none_t>)
+          func(token);
+      }
+
+    /**
+     * @brief A predicate accepting a single character.
+     * @tparam CharT The character type.
+     */
+    template<typename CharT>
+      struct same_char {
+        CharT c;  /**< The accepted character. */
+
+        /**
+         * @brief Check a character.
+         * @param[in] other The character to be checked.
+         * @retval true `other` is the accepted character.
+         * @retval false `other` is another character.
+         */
+        constexpr bool operator()(CharT other) const noexcept
+        {
+          return other == c;
+        }
+      };
+
+    /**
+     * @brief A tokenizer that extracts a single character satisfying a predicate, out of input
+     * made of characters of any type.
+     * @tparam CharT The character type.
+     * @tparam Acceptor_Predicate A callable type `bool (CharT c)`.
+     * @tparam Map A callable type `void (Tok::basic_input<CharT>)`. It is called on the extracted token.
+     */
+    template<typename CharT, typename Acceptor_Predicate, typename Map>
+      struct basic_char {
+        using char_type = CharT;  /**< The character type of the input. */
+
+        Acceptor_Predicate pred;  /**< Decides if a character is an acceptable token. */
+        Map func;                 /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to extract a single character token from the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr basic_token<CharT> operator()(basic_input<CharT>& input) const
+        {
+          if (input.empty() || !pred(input[0]))
+            return {};
+          const auto token = input.substr(0, 1);
+          apply_map(func, token);
+          input.remove_prefix(1);
+          return {token};
+        }
+      };
+
+    /**
+     * @brief A tokenizer that extracts a literal string, out of input made of characters of any type.
+     * @tparam CharT The character type.
+     * @tparam Map A callable type `void (Tok::basic_input<CharT>)`. It is called on the extracted token.
+     */
+    template<typename CharT, typename Map>
+      struct basic_literal {
+        using char_type = CharT;  /**< The character type of the input. */
+
+        basic_input<CharT> str;   /**< The string to be matched. */
+        Map func;                 /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to match the literal at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr basic_token<CharT> operator()(basic_input<CharT>& input) const
+        {
+          if (input.size() < str.size() || input.compare(0, str.size(), str) != 0)
+            return {};
+          const auto token = input.substr(0, str.size());
+          apply_map(func, token);
+          input.remove_prefix(str.size());
+          return {token};
+        }
+      };
+
+    /**
+     * @brief Decode the UTF-16 encoded code point at the start of the input.
+     * @param[in] input The code units.
+     * @param[out] cp The code point, if one was decoded.
+     * @returns The number of code units of the code point, or 0 for a lone surrogate or an
+     * empty input.
+     */
+    constexpr std::size_t decode_utf16(basic_input<char16_t> input, char32_t& cp) noexcept
+    {
+      if (input.empty())
+        return 0;
+      const char32_t lead = input[0];
+      if (lead < 0xd800 || lead > 0xdfff) {
+        cp = lead;
+        return 1;
+      }
+      if (lead > 0xdbff || input.size() < 2 || input[1] < 0xdc00 || input[1] > 0xdfff)
+        return 0;
+      cp = 0x10000 + ((lead - 0xd800) << 10) + (char32_t{input[1]} - 0xdc00);
+      return 2;
+    }
+
+    /**
+     * @brief A tokenizer that extracts a single UTF-16 encoded code point out of a set.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     */
+    template<typename Map>
+      struct utf16_char {
+        using char_type = char16_t;  /**< The character type of the input. */
+
+        utf8::code_point_set set;    /**< The code points matched. */
+        Map func;                    /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to extract a single code point from the input.
+         * @details Code units below U+0080 are looked up in the ASCII bitmap of the set without
+         * decoding.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted token, holding one or two code units, or `std::nullopt` on a mismatch.
+         */
+        constexpr basic_token<char16_t> operator()(basic_input<char16_t>& input) const
+        {
+          char32_t cp = 0;
+          const auto length = !input.empty() && input[0] < 0x80 ? (cp = input[0], 1) : decode_utf16(input, cp);
+          if (length == 0 || !set.contains(cp))
+            return {};
+          const auto token = input.substr(0, length);
+          apply_map(func, token);
+          input.remove_prefix(length);
+          return {token};
+        }
+      };
+
+    /**
+     * @brief A tokenizer that accepts matches of several tokenizers in sequence, out of input
+     * made of characters of any type.
+     * @tparam CharT The character type.
+     * @tparam Tokenizers Callable types `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+     */
+    template<typename CharT, typename... Tokenizers>
+      struct basic_sequence {
+        using char_type = CharT;          /**< The character type of the input. */
+
+        std::tuple<Tokenizers...> parts;  /**< The tokenizers, in the order they are evaluated. */
+
+        /**
+         * @brief Attempt to match all tokenizers in sequence at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed only if all of them match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr basic_token<CharT> operator()(basic_input<CharT>& input) const
+        {
+          const auto start = input;
+          const bool matched = std::apply([&input](const auto&... part) {
+              return (part(input).has_value() && ...);
+            }, parts);
+          if (!matched) {
+            input = start;
+            return {};
+          }
+          return {start.substr(0, start.size() - input.size())};
+        }
+      };
+
+    /**
+     * @brief A tokenizer that tries several tokenizers in order, out of input made of characters
+     * of any type.
+     * @tparam CharT The character type.
+     * @tparam Tokenizers Callable types `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+     */
+    template<typename CharT, typename... Tokenizers>
+      struct basic_alternation {
+        using char_type = CharT;             /**< The character type of the input. */
+
+        std::tuple<Tokenizers...> branches;  /**< The tokenizers to choose from. */
+
+        /**
+         * @brief Attempt to match one of the branches at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed by the matching branch.
+         * @returns The token of the first branch that succeeds or `std::nullopt` if all fail.
+         */
+        constexpr basic_token<CharT> operator()(basic_input<CharT>& input) const
+        {
+          basic_token<CharT> token;
+          std::apply([&input, &token](const auto&... branch) {
+              ((token = branch(input)) || ...);
+            }, branches);
+          return token;
+        }
+      };
+
+    /**
+     * @brief A tokenizer that greedily matches between `min` and `max` instances of another
+     * tokenizer, out of input made of characters of any type.
+     * @tparam CharT The character type.
+     * @tparam Tokenizer A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+     * @tparam Map A callable type `void (Tok::basic_input<CharT>)`. It is called on the extracted token.
+     */
+    template<typename CharT, typename Tokenizer, typename Map>
+      struct basic_repetition {
+        using char_type = CharT;  /**< The character type of the input. */
+
+        Tokenizer tokenizer;      /**< The repeated tokenizer. */
+        Map func;                 /**< Further processes / maps the extracted token. */
+        std::size_t min;          /**< Least number of instances for a successful match. */
+        std::size_t max;          /**< Most number of instances matched, `Tok::impl::unbounded` for no limit. */
+
+        /**
+         * @brief Attempt to match the repetition at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed if at least `min` instances matched.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        constexpr basic_token<CharT> operator()(basic_input<CharT>& input) const
+        {
+          auto rest = input;
+          std::size_t count = 0;
+          while (count < max && !(count >= min && rest.empty())) {
+            const auto token = tokenizer(rest);
+            if (!token)
+              break;
+            count++;
+            // Further instances would match the same empty token, so the minimum is met
+            if ((*token).empty()) {
+              count = count < min ? min : count;
+              break;
+            }
+          }
+          if (count < min)
+            return {};
+          const auto token = input.substr(0, input.size() - rest.size());
+          apply_map(func, token);
+          input = rest;
+          return {token};
+        }
+      };
+
+    /**
+     * @brief A tokenizer that optionally accepts matches of another tokenizer, out of input made
+     * of characters of any type.
+     * @tparam CharT The character type.
+     * @tparam Tokenizer A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+     * @tparam Map A callable type `void (Tok::basic_input<CharT>)`. It is called on the extracted token.
+     */
+    template<typename CharT, typename Tokenizer, typename Map>
+      struct basic_option {
+        using char_type = CharT;  /**< The character type of the input. */
+
+        Tokenizer tokenizer;      /**< The optional tokenizer. */
+        Map func;                 /**< Further processes / maps the extracted token. */
+
+        /**
+         * @brief Attempt to match the tokenizer, succeeding with an empty token if it does not.
+         * @param[in,out] input The input to the tokenizer. It is consumed on a match.
+         * @returns The extracted, possibly empty, token.
+         */
+        constexpr basic_token<CharT> operator()(basic_input<CharT>& input) const
+        {
+          auto token = tokenizer(input);
+          if (!token)
+            token = input.substr(0, 0);
+          apply_map(func, *token);
+          return token;
+        }
+      };
+
+    /**
+     * @brief Find the character type of the tokenizers built by `Tok::utf16` and the like.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer, typename = void>
+      struct char_type_of {
+        using type = void;  /**< No character type, e.g. for lambdas or tokenizers over `char`. */
+      };
+
+    /**
+     * @brief Specialization for tokenizers declaring their character type.
+     * @tparam Tokenizer The type to be checked.
+     */
+    template<typename Tokenizer>
+      struct char_type_of<Tokenizer, std::void_t<typename Tokenizer::char_type>> {
+        using type = typename Tokenizer::char_type;  /**< The character type of the input. */
+      };
+
+    /**
+     * @brief Find the character type shared by the operands of `operator&` or `operator|`.
+     * @details At least one of them has to be a tokenizer declaring it, and both have to accept
+     * input of that type. Tokenizers over `char` are left to the operators building the
+     * optimized nodes.
+     * @tparam L The type of the left operand.
+     * @tparam R The type of the right operand.
+     */
+    template<typename L, typename R>
+      struct common_char_type {
+        using candidate = std::conditional_t<std::is_void_v<typename char_type_of<std::decay_t<L>>::type>,
+              typename char_type_of<std::decay_t<R>>::type,
+              typename char_type_of<std::decay_t<L>>::type>;  /**< Declared character type. */
+
+        /**
+         * @brief Check if both operands are tokenizers over characters of a type.
+         * @tparam CharT The character type.
+         * @returns `true` if both accept `Tok::basic_input<CharT>&`.
+         */
+        template<typename CharT>
+          static constexpr bool accepts() noexcept
+          {
+            if constexpr (std::is_void_v<CharT> || std::is_same_v<CharT, char>)
+              return false;
+            else
+              return std::is_invocable_r_v<basic_token<CharT>, L, basic_input<CharT>&> &&
+                std::is_invocable_r_v<basic_token<CharT>, R, basic_input<CharT>&>;
+          }
+
+        static constexpr bool value = accepts<candidate>();  /**< `true` if the operands can be combined. */
+      };
+
+    /**
+     * @brief Get the parts of a tokenizer that becomes part of a sequence.
+     * @tparam CharT The character type.
+     * @tparam Tokenizer A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+     * @param[in] tokenizer The tokenizer.
+     * @returns The parts of `tokenizer` if it is a sequence, `tokenizer` itself otherwise.
+     */
+    template<typename CharT, typename Tokenizer>
+      constexpr auto basic_parts_of(Tokenizer&& tokenizer) noexcept
+      {
+        if constexpr (is_node<std::decay_t<Tokenizer>, basic_sequence>::value)
+          return std::forward<Tokenizer>(tokenizer).parts;
+        else
+          return std::tuple<std::decay_t<Tokenizer>>(std::forward<Tokenizer>(tokenizer));
+      }
+
+    /**
+     * @brief Get the branches of a tokenizer that becomes a branch of an alternation.
+     * @tparam CharT The character type.
+     * @tparam Tokenizer A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+     * @param[in] tokenizer The tokenizer.
+     * @returns The branches of `tokenizer` if it is an alternation, `tokenizer` itself otherwise.
+     */
+    template<typename CharT, typename Tokenizer>
+      constexpr auto basic_branches_of(Tokenizer&& tokenizer) noexcept
+      {
+        if constexpr (is_node<std::decay_t<Tokenizer>, basic_alternation>::value)
+          return std::forward<Tokenizer>(tokenizer).branches;
+        else
+          return std::tuple<std::decay_t<Tokenizer>>(std::forward<Tokenizer>(tokenizer));
+      }
+  }
+
+  /// Namespace that holds the tokenizers of UTF-16 encoded input
+  namespace utf16 {
+    using Input = basic_input<char16_t>;       /**< Define an input type of UTF-16 code units. */
+
+    using Token = basic_token<char16_t>;       /**< Define a type to optionally hold a token of UTF-16 code units. */
+
+    using Token_view = basic_input<char16_t>;  /**< Define a type that provides a view of the extracted token. */
+
+    /**
+     * @brief Create a tokenizer that matches a single UTF-16 code unit.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] c The code unit to be matched.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches `c` as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto char_token(char16_t c, Map&& func = mapper::none_t{}) noexcept
+      {
+        VALIDATE_BASIC_MAP_TYPE(char16_t, Map);
+        return impl::basic_char<char16_t, impl::same_char<char16_t>, std::decay_t<Map>>{{c}, std::forward<Map>(func)};
+      }
+
+    /**
+     * @brief Create a tokenizer that matches a literal string of UTF-16 code units.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] str The string to be matched. It must outlive the tokenizer.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches `str` as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto str_token(Input str, Map&& func = mapper::none_t{}) noexcept
+      {
+        VALIDATE_BASIC_MAP_TYPE(char16_t, Map);
+        return impl::basic_literal<char16_t, std::decay_t<Map>>{str, std::forward<Map>(func)};
+      }
+
+    /**
+     * @brief Create a tokenizer that matches a single UTF-16 encoded code point out of a set.
+     * @details The input is matched in place, without transcoding. Surrogate pairs are decoded
+     * and lone surrogates never match.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] set The code points that could be matched.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of one member of the set as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto any_of(const utf8::code_point_set& set, Map&& func = mapper::none_t{}) noexcept
+      {
+        VALIDATE_BASIC_MAP_TYPE(char16_t, Map);
+        return impl::utf16_char<std::decay_t<Map>>{set, std::forward<Map>(func)};
+      }
+
+    /**
+     * @brief Create a tokenizer that matches a single UTF-16 encoded code point in a range.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] first The first code point of the range.
+     * @param[in] last The last code point of the range.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of a code point in [first, last] as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto range(char32_t first, char32_t last, Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf16::any_of(utf8::code_point_set::range(first, last), std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches a letter, encoded in UTF-16.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of a member of `Tok::utf8::letters` as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto letter(Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf16::any_of(utf8::letters, std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches an ASCII digit, encoded in UTF-16.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches a code unit in ['0', '9'] as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto digit(Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf16::range('0', '9', std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches any valid UTF-16 encoded code point.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the encoding of a code point as a token.
+     */
+    template<typename Map = mapper::none_t>
+      constexpr auto code_point(Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf16::any_of(utf8::any, std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches between `min` and `max` instances of a tokenizer
+     * over UTF-16 input.
+     * @tparam Tokenizer A callable type `Tok::utf16::Token (Tok::utf16::Input& input)`.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] min Least number of instances.
+     * @param[in] max Most number of instances, `Tok::impl::unbounded` for no limit.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the instances as one token.
+     */
+    template<typename Tokenizer, typename Map = mapper::none_t>
+      constexpr auto between(Tokenizer&& tokenizer, std::size_t min, std::size_t max,
+          Map&& func = mapper::none_t{}) noexcept
+      {
+        VALIDATE_BASIC_TOKENIZER_TYPE(char16_t, Tokenizer);
+        VALIDATE_BASIC_MAP_TYPE(char16_t, Map);
+        return impl::basic_repetition<char16_t, std::decay_t<Tokenizer>, std::decay_t<Map>>{
+          std::forward<Tokenizer>(tokenizer), std::forward<Map>(func), min, max};
+      }
+
+    /**
+     * @brief Create a tokenizer that matches any number of instances of a tokenizer over UTF-16 input.
+     * @tparam Tokenizer A callable type `Tok::utf16::Token (Tok::utf16::Input& input)`.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the, possibly empty, instances as one token.
+     */
+    template<typename Tokenizer, typename Map = mapper::none_t>
+      constexpr auto many(Tokenizer&& tokenizer, Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf16::between(std::forward<Tokenizer>(tokenizer), 0, impl::unbounded, std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches one or more instances of a tokenizer over UTF-16 input.
+     * @tparam Tokenizer A callable type `Tok::utf16::Token (Tok::utf16::Input& input)`.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the instances as one token.
+     */
+    template<typename Tokenizer, typename Map = mapper::none_t>
+      constexpr auto at_least_one(Tokenizer&& tokenizer, Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf16::between(std::forward<Tokenizer>(tokenizer), 1, impl::unbounded, std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that matches exactly `count` instances of a tokenizer over UTF-16 input.
+     * @tparam Tokenizer A callable type `Tok::utf16::Token (Tok::utf16::Input& input)`.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] count Number of instances.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches the instances as one token.
+     */
+    template<typename Tokenizer, typename Map = mapper::none_t>
+      constexpr auto exactly(Tokenizer&& tokenizer, std::size_t count, Map&& func = mapper::none_t{}) noexcept
+      {
+        return utf16::between(std::forward<Tokenizer>(tokenizer), count, count, std::forward<Map>(func));
+      }
+
+    /**
+     * @brief Create a tokenizer that optionally matches a tokenizer over UTF-16 input.
+     * @tparam Tokenizer A callable type `Tok::utf16::Token (Tok::utf16::Input& input)`.
+     * @tparam Map A callable type `void (Tok::utf16::Token_view)`. It is called on the extracted token.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] func A callable object of type `Map`.
+     * @returns A tokenizer that matches `tokenizer`, or the empty token if it does not match.
+     */
+    template<typename Tokenizer, typename Map = mapper::none_t>
+      constexpr auto maybe(Tokenizer&& tokenizer, Map&& func = mapper::none_t{}) noexcept
+      {
+        VALIDATE_BASIC_TOKENIZER_TYPE(char16_t, Tokenizer);
+        VALIDATE_BASIC_MAP_TYPE(char16_t, Map);
+        return impl::basic_option<char16_t, std::decay_t<Tokenizer>, std::decay_t<Map>>{
+          std::forward<Tokenizer>(tokenizer), std::forward<Map>(func)};
+      }
+  }
+
+  /**
+   * @brief Create a tokenizer that matches everything up to a delimiting character.
+   * @details The delimiter is found with `memchr` rather than one character at a time, and is
+   * not consumed. Unlike `Tok::many(Tok::none_of(...))`, there is no match if the input holds no
+   * delimiter.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] delimiter Character that ends the token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches the, possibly empty, span before the delimiter as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto until(char delimiter, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::delimited<impl::char_finder, std::decay_t<Map>>{{delimiter}, std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches everything up to any character out of a set.
+   * @details The delimiter is found with the vector kernel used by Tok::many, and is not consumed.
+   * There is no match if the input holds no delimiter.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] delimiters The characters that end the token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches the, possibly empty, span before the first delimiter as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto until(const char_set& delimiters, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::delimited<impl::set_finder, std::decay_t<Map>>{{impl::span_kernel(~delimiters)},
+        std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches everything up to any character out of a group.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] char_group A view into the group of characters that end the token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches the, possibly empty, span before the first delimiter as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto until(Predicate char_group, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return until(char_set(char_group), std::forward<Map>(func));
+    }
+
+  /**
+   * @brief Create a tokenizer that matches everything up to a delimiting string.
+   * @details The delimiter is found by jumping between occurrences of its first character with
+   * `memchr`, and is not consumed. There is no match if the input holds no delimiter.
+   * ~~~.cpp
+   * const auto line = Tok::until(Tok::str_token("\r\n")) & Tok::str_token("\r\n");
+   * ~~~
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] delimiter A Map-less `Tok::str_token` holding the string that ends the token.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches the, possibly empty, span before the delimiter as a token.
+   */
+  template<typename Map = mapper::none_t>
+    constexpr auto until(const impl::literal<mapper::none_t>& delimiter, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_MAP_TYPE(Map);
+      return impl::delimited<impl::string_finder, std::decay_t<Map>>{{delimiter.str}, std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches multiple instances (zero or many) of another tokenizer.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that accepts zero or more number of tokens matched by `tokenizer`.
+   */
+  template<typename Tokenizer, typename Map = mapper::none_t>
+    constexpr auto many(Tokenizer&& tokenizer, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      VALIDATE_MAP_TYPE(Map);
+      return impl::make_repetition(std::forward<Tokenizer>(tokenizer), std::forward<Map>(func), 0, impl::unbounded);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches an exact number number of instances of another tokenizer.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] n The number of times the token needs to be matched.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a target tokenizer an exact number of times.
+   */
+  template<typename Tokenizer, typename Map = mapper::none_t>
+    constexpr auto exactly(Tokenizer&& tokenizer, std::size_t n, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      VALIDATE_MAP_TYPE(Map);
+      return impl::make_repetition(std::forward<Tokenizer>(tokenizer), std::forward<Map>(func), n, n);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a bounded number of instances of another tokenizer.
+   * @details As many instances as possible are matched, up to `max`. Without Maps, input shorter
+   * than `min` instances of the narrowest match of the tokenizer fails at once, e.g. fewer than 2
+   * characters for `Tok::between(Tok::str_token("\r\n"), 1, 3)`.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] min The least number of instances for a successful match.
+   * @param[in] max The most number of instances matched.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that matches a target tokenizer between `min` and `max` times.
+   */
+  template<typename Tokenizer, typename Map = mapper::none_t>
+    constexpr auto between(Tokenizer&& tokenizer, std::size_t min, std::size_t max,
+        Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      VALIDATE_MAP_TYPE(Map);
+      return impl::make_repetition(std::forward<Tokenizer>(tokenizer), std::forward<Map>(func), min, max);
+    }
+
+  /**
+   * @brief Create a tokenizer that matches at least one instance of another tokenizer.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that accepts at least one instance of the tokens matched by `tokenizer`.
+   */
+  template<typename Tokenizer, typename Map = mapper::none_t>
+    constexpr auto at_least_one(Tokenizer&& tokenizer, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      VALIDATE_MAP_TYPE(Map);
+      return impl::make_repetition(std::forward<Tokenizer>(tokenizer), std::forward<Map>(func), 1, impl::unbounded);
+    }
+
+  /**
+   * @brief Create a tokenizer that optionally accepts matches of another tokenizer.
+   * @details In case of an empty match, `func` is still called.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that optionally accepts one instance of the tokens matched by `tokenizer`.
+   */
+  template<typename Tokenizer, typename Map = mapper::none_t>
+    constexpr auto maybe(Tokenizer&& tokenizer, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      VALIDATE_MAP_TYPE(Map);
+      return impl::option<std::decay_t<Tokenizer>, std::decay_t<Map>>{
+        std::forward<Tokenizer>(tokenizer), std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Apply a callable object to the output of a sequence tokenizer.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] seq A sequence tokenizer (returned by Tok::sequence).
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer that accepts an ordered sequence of matches by two tokenizers and
+   * applies a callable object to the result.
+   */
+  template<typename Tokenizer, typename Map>
+    constexpr auto map(Tokenizer&& seq, Map&& func) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      VALIDATE_MAP_TYPE(Map);
+      return impl::mapped<std::decay_t<Tokenizer>, std::decay_t<Map>>{
+        std::forward<Tokenizer>(seq), std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Create a tokenizer that accepts matches of several tokenizers in sequence.
+   * @details It is equivalent to joining the tokenizers with `operator&`, which builds the same
+   * flat `Tok::impl::sequence`.
+   * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizers The tokenizers, in the order they are evaluated.
+   * @returns A tokenizer that accepts an ordered sequence of matches by all tokenizers.
+   */
+  template<typename... Tokenizers>
+    constexpr auto seq(Tokenizers&&... tokenizers) noexcept
+    {
+      static_assert(sizeof...(Tokenizers) > 0, "A sequence needs at least one tokenizer");
+      static_assert((std::is_invocable_r_v<Token, Tokenizers, Input&> && ...),
+          "Tokenizer must be a callable type 'Tok::Token (Tok::Input&)'");
+      return impl::make_sequence(std::tuple_cat(impl::parts_of(std::forward<Tokenizers>(tokenizers))...));
+    }
+
+  /**
+   * @brief Create a tokenizer that chooses the first successful match out of several tokenizers.
+   * @details It is equivalent to joining the tokenizers with `operator|`, which builds the same
+   * flat `Tok::impl::alternation`.
+   * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizers The tokenizers, in the order they are tried.
+   * @returns A tokenizer that chooses the first tokenizer that succeeds.
+   */
+  template<typename... Tokenizers>
+    constexpr auto alt(Tokenizers&&... tokenizers) noexcept
+    {
+      static_assert(sizeof...(Tokenizers) > 0, "An alternation needs at least one tokenizer");
+      static_assert((std::is_invocable_r_v<Token, Tokenizers, Input&> && ...),
+          "Tokenizer must be a callable type 'Tok::Token (Tok::Input&)'");
+      return impl::make_alternation(std::tuple_cat(impl::branches_of(std::forward<Tokenizers>(tokenizers))...));
+    }
+
+  /**
+   * @brief Create a tokenizer that chooses a match out of order-independent tokenizers, trying the
+   * most frequent one first.
+   * @details The tokenizers must not depend on the order they are tried in, e.g. because at most
+   * one of them can match any input. Alternations among them are flattened, as for `Tok::alt`.
+   * Copies of the tokenizer share `stats`, and so may threads applying it at the same time.
+   * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+   * @param[in,out] stats The hit counters and evaluation order of the branches. They must outlive the tokenizer.
+   * @param[in] tokenizers The tokenizers to choose from, tried in the order they are listed at first.
+   * @returns A tokenizer that chooses a tokenizer that succeeds.
+   */
+  template<typename... Tokenizers>
+    constexpr auto adaptive_alt(branch_stats& stats, Tokenizers&&... tokenizers) noexcept
+    {
+      static_assert(sizeof...(Tokenizers) > 0, "An alternation needs at least one tokenizer");
+      static_assert((std::is_invocable_r_v<Token, Tokenizers, Input&> && ...),
+          "Tokenizer must be a callable type 'Tok::Token (Tok::Input&)'");
+      return impl::make_adaptive_alternation(
+          std::tuple_cat(impl::branches_of(std::forward<Tokenizers>(tokenizers))...), &stats);
+    }
+
+  /**
+   * @brief Create a tokenizer whose elements may be separated by text matched by a skipper.
+   * @details The skipper, e.g. `Tok::whitespace()` or `Tok::whitespace() | comment`, is run before
+   * the match, after it, and between the parts of every sequence and the instances of every
+   * repetition within the tokenizer, as with a phrase parser. Branches of the skipper that match
+   * a character out of a set, or a run of them, are fused into a single vectorized scan. Nothing is
+   * skipped within `Tok::lexeme`, nor within runs of characters such as `Tok::at_least_one(Tok::digit())`,
+   * literals, keyword sets, rules and other opaque tokenizers.
+   * ~~~.cpp
+   * const auto comment = Tok::char_token('#') & Tok::until('\n');
+   * const auto call = Tok::skip(Tok::whitespace() | comment,
+   *     name & Tok::char_token('(') & Tok::maybe(arg & Tok::many(Tok::char_token(',') & arg)) & Tok::char_token(')'));
+   * ~~~
+   * @tparam Skipper A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] skipper Matches the text to be skipped.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns A tokenizer whose token does not include the skipped text before and after the match.
+   */
+  template<typename Skipper, typename Tokenizer>
+    constexpr auto skip(Skipper&& skipper, Tokenizer&& tokenizer) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Skipper);
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      const auto gaps = impl::make_skipper(skipper);
+      auto rewritten = impl::with_skipper(gaps, tokenizer);
+      return impl::skipping<decltype(gaps), decltype(rewritten)>{gaps, std::move(rewritten)};
+    }
+
+  /**
+   * @brief Create a tokenizer within which `Tok::skip` skips nothing.
+   * @details Outside of `Tok::skip`, it matches the same as `tokenizer`.
+   * ~~~.cpp
+   * const auto identifier = Tok::lexeme(Tok::alphabet() & Tok::many(Tok::alphabet() | Tok::digit()));
+   * ~~~
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns A tokenizer that matches `tokenizer` as a single element.
+   */
+  template<typename Tokenizer>
+    constexpr auto lexeme(Tokenizer&& tokenizer) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      return impl::lexeme<std::decay_t<Tokenizer>>{std::forward<Tokenizer>(tokenizer)};
+    }
+
+  /**
+   * @brief Create a tokenizer that remembers its outcome at every position it is applied to.
+   * @details Alternatives sharing a prefix, e.g. `(header & body_a) | (header & body_b)`, match
+   * the prefix again for every branch they try. Wrapping the shared part as
+   * `const auto header_m = Tok::memo(header, cache);` evaluates it once per position; later
+   * attempts recall the outcome from the cache. All rules of a parse share one cache, which has
+   * to be cleared before parsing another input. Maps inside the memoized tokenizer are called
+   * only once per position, except deferred Maps within a transaction, whose matches are
+   * matched again so that their calls are recorded.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] cache The cache storing the outcomes. It must outlive the returned tokenizer.
+   * @returns A tokenizer of type `Tok::impl::memoized`.
+   */
+  template<typename Tokenizer>
+    auto memo(Tokenizer&& tokenizer, memo_cache& cache) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      return impl::memoized<std::decay_t<Tokenizer>>{std::forward<Tokenizer>(tokenizer), &cache, cache.new_rule()};
+    }
+
+  /**
+   * @brief Defer the calls of a Map to the end of the running transaction.
+   * @details Within `Tok::transaction`, the Map is only called once the whole tokenizer
+   * succeeded, and not at all for parts of the input that were matched and then given up by a
+   * failing sequence or repetition. Outside of a transaction it is called right away.
+   * @tparam Map A callable type `void (Tok::Token_view)`.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A Map of type `Tok::impl::deferred_map`.
+   */
+  template<typename Map>
+    constexpr auto defer(Map&& func) noexcept
+    {
       VALIDATE_MAP_TYPE(Map);
-      return [=, func = std::forward<Map>(func)](Input& input) -> Token {
-        if (input.size() == 0)
-          return {};
-        for (const auto& c : char_group)
-          if (impl::starts_with(input, c))
+      return impl::deferred_map<std::decay_t<Map>>{std::forward<Map>(func)};
+    }
+
+  /**
+   * @brief Create a tokenizer that runs the deferred Maps of another one only if it succeeds.
+   * @details While the tokenizer runs, Maps wrapped with `Tok::defer` are recorded in `log`.
+   * Records of a sequence or a repetition that fails are dropped as it rewinds the input. On
+   * success the remaining records are run in order, on failure they are dropped. The Maps are
+   * called after the tokenizer returned, so the tokenizer must outlive the transaction's call.
+   * ~~~.cpp
+   * Tok::map_record records[32];
+   * Tok::map_log log(records);
+   * const auto number = Tok::at_least_one(Tok::digit(), Tok::defer([&](Tok::Token_view t) { value = convert(t); }));
+   * const auto reading = Tok::transaction(number & Tok::char_token(';'), log);
+   * ~~~
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] log Records the deferred calls. It must outlive the returned tokenizer.
+   * @returns A tokenizer of type `Tok::impl::transaction`.
+   */
+  template<typename Tokenizer>
+    auto transaction(Tokenizer&& tokenizer, map_log& log) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      return impl::transaction<std::decay_t<Tokenizer>>{std::forward<Tokenizer>(tokenizer), &log};
+    }
+
+  /**
+   * @brief Count how a node of a tokenizer performs.
+   * @details If `LEXTOK_PROFILE` is defined, every application of the tokenizer updates `counters`.
+   * The backtracks of sequences and the branches tried by alternations inside it are counted too,
+   * unless they are inside another profiled node. Otherwise, the tokenizer is returned unchanged
+   * and nothing is counted, so the generated code is the same as without the wrapper.
+   * ~~~.cpp
+   * Tok::profile header_profile{"header"};
+   * const auto message = Tok::profiled(header_profile, header) & body;
+   * ...
+   * Tok::write_profile(stderr, {&header_profile});
+   * ~~~
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] counters Receives the counts. It must outlive the returned tokenizer.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns A tokenizer of type `Tok::impl::profiled`, or `tokenizer` if profiling is disabled.
+   */
+  template<typename Tokenizer>
+    constexpr auto profiled(profile& counters, Tokenizer&& tokenizer) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+#if defined(LEXTOK_PROFILE)
+      return impl::profiled<std::decay_t<Tokenizer>>{std::forward<Tokenizer>(tokenizer), &counters};
+#else
+      static_cast<void>(counters);
+      return std::decay_t<Tokenizer>(std::forward<Tokenizer>(tokenizer));
+#endif
+    }
+
+  /**
+   * @brief Record where a tokenizer failed, in the same pass that failed.
+   * @details If `LEXTOK_TRACK_FAILURES` is defined, every mismatch of the tokenizer fills
+   * `context` with the furthest offset, from the start of its input, at which a sequence or an
+   * alternation inside it rewound, and with the characters expected there. Otherwise, the
+   * tokenizer is returned unchanged and `context` is left untouched.
+   * ~~~.cpp
+   * Tok::failure error;
+   * const auto reply = Tok::diagnose(error, Tok::str_token("+CSQ: ") & rssi & Tok::char_token(',') & ber);
+   * if (!reply(input))
+   *   std::fprintf(stderr, "Malformed response at %zu\n", error.offset);
+   * ~~~
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] context Receives the furthest failure. It must outlive the returned tokenizer.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns A tokenizer of type `Tok::impl::diagnosed`, or `tokenizer` if tracking is disabled.
+   */
+  template<typename Tokenizer>
+    constexpr auto diagnose(failure& context, Tokenizer&& tokenizer) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+#if defined(LEXTOK_TRACK_FAILURES)
+      return impl::diagnosed<std::decay_t<Tokenizer>>{std::forward<Tokenizer>(tokenizer), &context};
+#else
+      static_cast<void>(context);
+      return std::decay_t<Tokenizer>(std::forward<Tokenizer>(tokenizer));
+#endif
+    }
+
+  /**
+   * @brief Name a tokenizer in the failures recorded by `Tok::diagnose`.
+   * @details If the tokenizer fails and nothing failed further into the input, the failure
+   * names it. Without `LEXTOK_TRACK_FAILURES`, the tokenizer is returned unchanged.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] name The name of the tokenizer. It must outlive the returned tokenizer.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns A tokenizer of type `Tok::impl::named`, or `tokenizer` if tracking is disabled.
+   */
+  template<typename Tokenizer>
+    constexpr auto named(const char* name, Tokenizer&& tokenizer) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+#if defined(LEXTOK_TRACK_FAILURES)
+      return impl::named<std::decay_t<Tokenizer>>{std::forward<Tokenizer>(tokenizer), name};
+#else
+      static_cast<void>(name);
+      return std::decay_t<Tokenizer>(std::forward<Tokenizer>(tokenizer));
+#endif
+    }
+
+  namespace impl {
+    inline thread_local std::size_t rule_depth = 0; /**< Number of rules being matched by this thread. */
+  }
+
+  /**
+   * @brief A tokenizer that can be declared before it is defined, for recursive grammars.
+   * @details The definition is assigned later and stored in place, in a buffer of `Capacity`
+   * bytes, so matching a rule costs a single indirect call and never allocates. Other tokenizers
+   * refer to a rule through `Tok::ref`, since a rule can be neither copied nor moved. An undefined
+   * rule does not match. With a depth limit, a rule does not match while that many rules are
+   * already being matched by the same thread, which bounds the stack used by deeply nested input.
+   * Alternations carry their dispatch table, so the default `Capacity` leaves room for a few of
+   * them. Rules cannot be used in constant expressions.
+   * ~~~.cpp
+   * Tok::rule list;
+   * const auto item = Tok::at_least_one(Tok::digit()) | Tok::ref(list);
+   * list = Tok::char_token('(') & item & Tok::many(Tok::char_token(',') & item) & Tok::char_token(')');
+   * ~~~
+   * @tparam Capacity Size of the buffer storing the definition.
+   */
+  template<std::size_t Capacity = 1024>
+    class rule {
+      public:
+        /**
+         * @brief Declare a rule.
+         * @param[in] max_depth Most rules being matched by the thread for the rule to be tried.
+         */
+        explicit rule(std::size_t max_depth = std::numeric_limits<std::size_t>::max()) noexcept :
+          max_depth(max_depth) {}
+
+        rule(const rule&) = delete;
+        rule& operator=(const rule&) = delete;
+
+        /**
+         * @brief Destroy the definition of the rule.
+         */
+        ~rule()
+        {
+          clear();
+        }
+
+        /**
+         * @brief Define the rule, replacing its previous definition.
+         * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+         * @param[in] tokenizer The definition of the rule.
+         * @returns The rule.
+         */
+        template<typename Tokenizer,
+          typename std::enable_if<!std::is_same_v<std::decay_t<Tokenizer>, rule>>::type* = nullptr>
+        rule& operator=(Tokenizer&& tokenizer) noexcept
+        {
+          using definition = std::decay_t<Tokenizer>;
+          VALIDATE_TOKENIZER_TYPE(definition);
+          static_assert(sizeof(definition) <= Capacity, "The definition does not fit in the rule, raise its Capacity");
+          static_assert(alignof(definition) <= alignof(std::max_align_t), "The definition is over-aligned");
+          clear();
+          ::new (static_cast<void*>(storage)) definition(std::forward<Tokenizer>(tokenizer));
+          match = [](const void* body, Input& input) -> Token {
+            return (*static_cast<const definition*>(body))(input);
+          };
+          destroy = [](void* body) { static_cast<definition*>(body)->~definition(); };
+          return *this;
+        }
+
+        /**
+         * @brief Attempt to match the definition at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed only on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch, if the rule is undefined or
+         * if the depth limit is reached.
+         */
+        Token operator()(Input& input) const
+        {
+          if (!match || impl::rule_depth >= max_depth)
+            return {};
+          impl::rule_depth++;
+          auto token = match(storage, input);
+          impl::rule_depth--;
+          return token;
+        }
+
+        /**
+         * @brief Check if the rule has a definition.
+         * @retval true The rule is defined.
+         * @retval false The rule is only declared.
+         */
+        bool is_defined() const noexcept
+        {
+          return match != nullptr;
+        }
+
+      private:
+        /**
+         * @brief Destroy the current definition, if any.
+         */
+        void clear() noexcept
+        {
+          if (destroy)
+            destroy(storage);
+          match = nullptr;
+          destroy = nullptr;
+        }
+
+        alignas(std::max_align_t) unsigned char storage[Capacity] = {};  /**< The definition of the rule. */
+        Token (*match)(const void*, Input&) = nullptr;                   /**< Applies the definition to the input. */
+        void (*destroy)(void*) = nullptr;                                /**< Destroys the definition. */
+        std::size_t max_depth;                                           /**< Depth limit of the rule. */
+    };
+
+  namespace impl {
+    /**
+     * @brief A tokenizer that refers to a rule.
+     * @details Its FIRST set is unknown, since the rule may not be defined yet.
+     * @tparam Capacity Size of the buffer storing the definition of the rule.
+     */
+    template<std::size_t Capacity>
+      struct rule_ref {
+        const rule<Capacity>* target;  /**< The rule. */
+
+        /**
+         * @brief Attempt to match the rule at the start of the input.
+         * @param[in,out] input The input to the tokenizer. It is consumed only on a match.
+         * @returns The extracted token or `std::nullopt` on a mismatch.
+         */
+        Token operator()(Input& input) const
+        {
+          return (*target)(input);
+        }
+      };
+
+    /**
+     * @brief Specialization for references to rules, whose definition may contain deferred Maps.
+     * @tparam Capacity Size of the buffer storing the definition of the rule.
+     */
+    template<std::size_t Capacity>
+      struct has_deferred_map<rule_ref<Capacity>> : std::true_type {};
+  }
+
+  /**
+   * @brief Refer to a rule from another tokenizer.
+   * @details The rule must outlive the tokenizer, and may still be undefined when it is referred to.
+   * @tparam Capacity Size of the buffer storing the definition of the rule.
+   * @param[in] target The rule.
+   * @returns A tokenizer of type `Tok::impl::rule_ref`.
+   */
+  template<std::size_t Capacity>
+    constexpr auto ref(const rule<Capacity>& target) noexcept
+    {
+      return impl::rule_ref<Capacity>{&target};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a decimal integer and stores its value.
+   * @details The digits are converted as they are matched, without allocating. Signed types
+   * accept a leading `-` or `+`. Values that do not fit in `T` do not match.
+   * ~~~.cpp
+   * int rssi = 0;
+   * const auto csq = Tok::str_token("+CSQ: ") & Tok::integer(rssi);
+   * ~~~
+   * @tparam T An integral type.
+   * @param[out] value The variable receiving the value on a match.
+   * @returns A tokenizer of type `Tok::impl::integer_parser`.
+   */
+  template<typename T>
+    constexpr auto integer(T& value) noexcept
+    {
+      static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Tok::integer needs an integral type");
+      return impl::integer_parser<T, 10, impl::store<T>>{{&value}};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a decimal integer and passes its value on.
+   * @details Called without a Sink, the tokenizer can still return the value through its
+   * `parse()` member function, e.g. `Tok::integer<int>().parse(input)`.
+   * @tparam T An integral type.
+   * @tparam Sink A callable type `void (T)`.
+   * @param[in] sink Called with the value on a match.
+   * @returns A tokenizer of type `Tok::impl::integer_parser`.
+   */
+  template<typename T, typename Sink = mapper::none_t>
+    constexpr auto integer(Sink&& sink = mapper::none_t{}) noexcept
+    {
+      static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Tok::integer needs an integral type");
+      if constexpr (!std::is_same_v<std::decay_t<Sink>, mapper::none_t>)
+        static_assert(std::is_invocable_v<Sink, T>, "Sink must be a callable type 'void (T)'");
+      return impl::integer_parser<T, 10, std::decay_t<Sink>>{std::forward<Sink>(sink)};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches hexadecimal digits and stores their value.
+   * @details Upper and lower case digits are accepted. A prefix such as `0x` is not part of
+   * the match and can be added with `Tok::str_token`. Values that do not fit in `T` do not match.
+   * @tparam T An integral type.
+   * @param[out] value The variable receiving the value on a match.
+   * @returns A tokenizer of type `Tok::impl::integer_parser`.
+   */
+  template<typename T>
+    constexpr auto hex_integer(T& value) noexcept
+    {
+      static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Tok::hex_integer needs an integral type");
+      return impl::integer_parser<T, 16, impl::store<T>>{{&value}};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches hexadecimal digits and passes their value on.
+   * @tparam T An integral type.
+   * @tparam Sink A callable type `void (T)`.
+   * @param[in] sink Called with the value on a match.
+   * @returns A tokenizer of type `Tok::impl::integer_parser`.
+   */
+  template<typename T, typename Sink = mapper::none_t>
+    constexpr auto hex_integer(Sink&& sink = mapper::none_t{}) noexcept
+    {
+      static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Tok::hex_integer needs an integral type");
+      if constexpr (!std::is_same_v<std::decay_t<Sink>, mapper::none_t>)
+        static_assert(std::is_invocable_v<Sink, T>, "Sink must be a callable type 'void (T)'");
+      return impl::integer_parser<T, 16, std::decay_t<Sink>>{std::forward<Sink>(sink)};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a decimal number and stores its value.
+   * @details The number has an optional sign, digits with an optional fraction, and an optional
+   * exponent, e.g. `-12.5e-3`. It is converted as it is matched, without allocating.
+   * @tparam T A floating point type.
+   * @param[out] value The variable receiving the value on a match.
+   * @returns A tokenizer of type `Tok::impl::decimal_parser`.
+   */
+  template<typename T>
+    constexpr auto decimal(T& value) noexcept
+    {
+      static_assert(std::is_floating_point_v<T>, "Tok::decimal needs a floating point type");
+      return impl::decimal_parser<T, impl::store<T>>{{&value}};
+    }
+
+  /**
+   * @brief Create a tokenizer that matches a decimal number and passes its value on.
+   * @tparam T A floating point type.
+   * @tparam Sink A callable type `void (T)`.
+   * @param[in] sink Called with the value on a match.
+   * @returns A tokenizer of type `Tok::impl::decimal_parser`.
+   */
+  template<typename T = double, typename Sink = mapper::none_t>
+    constexpr auto decimal(Sink&& sink = mapper::none_t{}) noexcept
+    {
+      static_assert(std::is_floating_point_v<T>, "Tok::decimal needs a floating point type");
+      if constexpr (!std::is_same_v<std::decay_t<Sink>, mapper::none_t>)
+        static_assert(std::is_invocable_v<Sink, T>, "Sink must be a callable type 'void (T)'");
+      return impl::decimal_parser<T, std::decay_t<Sink>>{std::forward<Sink>(sink)};
+    }
+
+  /**
+   * @brief Create a matcher that resumes a tokenizer over input that arrives in pieces.
+   * @details A regular tokenizer cannot tell running out of input from a mismatch. The returned
+   * object reports `Tok::match_status::incomplete` instead, and keeps a compact record of how far
+   * each part of the tokenizer got. Calling it again with more input picks up from there instead
+   * of reparsing, so matching a response received in chunks is linear in its length. Maps are
+   * called once, as each part of the tokenizer completes.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @returns A callable object of type `Tok::match_status (Tok::Input& input, Tok::Token& token,
+   * bool end_of_input)`.
+   */
+  template<typename Tokenizer>
+    constexpr auto resumable(Tokenizer&& tokenizer) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      return impl::resumable_tokenizer<std::decay_t<Tokenizer>>(std::forward<Tokenizer>(tokenizer));
+    }
+
+  /**
+   * @brief Create a lazy range of the tokens obtained by repeatedly applying a tokenizer on an input.
+   * @details Tokens are extracted one at a time as the range is iterated, so lexing can be
+   * pipelined with the processing of the tokens and stopped early. The range ends when the input
+   * is exhausted, or at the first failed or empty match. The input left at that point is available
+   * through `remaining()` on the iterator.
+   * ~~~.cpp
+   * for (const auto token : Tok::tokens(field & Tok::maybe(Tok::char_token(',')), input))
+   *   process(token);
+   * ~~~
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] input The input to be tokenized.
+   * @returns A range of `Tok::Token_view`.
+   */
+  template<typename Tokenizer>
+    constexpr auto tokens(Tokenizer&& tokenizer, Input input) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      return impl::token_range<std::decay_t<Tokenizer>>(std::forward<Tokenizer>(tokenizer), input);
+    }
+
+  /**
+   * @brief Find the first match of a tokenizer anywhere in the input.
+   * @details Running the tokenizer at every position is avoided by a prefilter derived from it.
+   * If every match starts with a known literal, e.g. the `Tok::str_token` at the head of a
+   * sequence, candidates are found by searching for the literal. Otherwise, characters outside
+   * the FIRST set of the tokenizer are skipped in bulk. The tokenizer only runs at the candidates.
+   * ~~~.cpp
+   * const auto token = Tok::search(Tok::str_token("+CGPADDR: ") & address, buffer);
+   * ~~~
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in,out] input The input to be searched. On a match, it is consumed up to the end of the
+   * match. Otherwise, it is left untouched.
+   * @returns The first match, or `std::nullopt` if the tokenizer matches nowhere.
+   */
+  template<typename Tokenizer>
+    constexpr Token search(const Tokenizer& tokenizer, Input& input)
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      const impl::prefilter filter(tokenizer);
+      for (auto i = filter.next(input, 0); i != Input::npos; i = filter.next(input, i + 1)) {
+        auto rest = input.substr(i);
+        if (const auto token = tokenizer(rest)) {
+          input = rest;
+          return token;
+        }
+      }
+      return {};
+    }
+
+  /**
+   * @brief A position in the source text, counted from 1.
+   */
+  struct source_position {
+    std::size_t line;    /**< Number of the line. */
+    std::size_t column;  /**< Number of the character in the line. */
+  };
+
+  /**
+   * @brief An index of the starts of the lines of an input, mapping offsets to lines and columns.
+   * @details The characters of `Tok::char_class::newline` end a line, and `"\r\n"` ends it once.
+   * Nothing is scanned until a position is asked for, and then only up to that position: the
+   * newlines are found with the vectorized kernel of character sets and the start of each line
+   * is stored in a caller-supplied arena. Positions in the indexed part are found by binary
+   * search. Once the arena is full, positions past the last stored line are found by counting
+   * the newlines from there.
+   */
+  class line_index {
+    public:
+      /**
+       * @brief Create an index over an array of line starts.
+       * @tparam N Number of line starts.
+       * @param[in] text The input to be indexed. It must outlive the index.
+       * @param[in] arena The line starts. They must outlive the index.
+       */
+      template<std::size_t N>
+        line_index(Input text, std::size_t (&arena)[N]) noexcept : line_index(text, arena, N)
+        {}
+
+      /**
+       * @brief Create an index over a range of line starts.
+       * @param[in] text The input to be indexed. It must outlive the index.
+       * @param[in] arena The first line start. The line starts must outlive the index.
+       * @param[in] capacity Number of line starts, at least 1.
+       */
+      line_index(Input text, std::size_t* arena, std::size_t capacity) noexcept :
+        text(text), starts(arena), capacity(capacity)
+      {}
+
+      /**
+       * @brief Find the line and column of an offset.
+       * @details The index is extended up to the offset if needed.
+       * @param[in] offset Offset from the start of the input. Offsets past its end stand for its end.
+       * @returns The position of the character at the offset.
+       */
+      source_position position(std::size_t offset) noexcept
+      {
+        offset = offset < text.size() ? offset : text.size();
+        extend(offset);
+        std::size_t lo = 1;
+        std::size_t hi = count;
+        while (lo < hi) {
+          const auto mid = lo + (hi - lo) / 2;
+          if (starts[mid] <= offset)
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+        auto line = lo;
+        auto start = starts[lo - 1];
+        if (lo == count && !complete)
+          for (auto next = next_line(start); next <= offset; next = next_line(next)) {
+            line++;
+            start = next;
+          }
+        return {line, offset - start + 1};
+      }
+
+      /**
+       * @brief Find the line and column of a token.
+       * @param[in] token A view into the input.
+       * @returns The position of the first character of the token.
+       */
+      source_position position(Token_view token) noexcept
+      {
+        return position(static_cast<std::size_t>(token.data() - text.data()));
+      }
+
+      /**
+       * @brief Count the line starts stored so far.
+       * @returns Number of lines found by the queries so far, within the capacity of the arena.
+       */
+      std::size_t size() const noexcept
+      {
+        return count;
+      }
+
+    private:
+      /**
+       * @brief Find the start of the line following another one.
+       * @param[in] start Start of a line.
+       * @returns Start of the next line, or past the end of the input if there is none.
+       */
+      std::size_t next_line(std::size_t start) const noexcept
+      {
+        const auto i = breaks.find(text, start);
+        if (i == Input::npos)
+          return text.size() + 1;
+        return i + 1 + (text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n');
+      }
+
+      /**
+       * @brief Store the starts of the lines up to the one after an offset, as far as the arena allows.
+       * @param[in] offset Offset from the start of the input.
+       */
+      void extend(std::size_t offset) noexcept
+      {
+        if (count == 0)
+          starts[count++] = 0;
+        while (!complete && starts[count - 1] <= offset && count < capacity) {
+          const auto next = next_line(starts[count - 1]);
+          if (next > text.size())
+            complete = true;
+          else
+            starts[count++] = next;
+        }
+      }
+
+      Input text;                /**< The indexed input. */
+      std::size_t* starts;       /**< Offsets of the starts of the lines, in increasing order. */
+      std::size_t capacity;      /**< Number of line starts the arena can hold. */
+      std::size_t count = 0;     /**< Number of line starts stored. */
+      bool complete = false;     /**< `true` once the start of the last line is stored. */
+      impl::set_finder breaks{impl::span_kernel(~char_class::newline)}; /**< Finds the next newline. */
+  };
+
+  /**
+   * @brief Create a longest-match lexer from a list of rules.
+   * @details Each rule pairs an identifier with a tokenizer. At each position the lexer tries the
+   * rules that can start with the next character, keeps the longest non-empty match and breaks ties
+   * in favour of the rule listed first, as flex does. Maps attached to the rules run for every rule
+   * tried, including the ones that lose.
+   * ~~~.cpp
+   * const auto lex = Tok::lexer(std::pair{KEYWORD, Tok::str_token("if")},
+   *                             std::pair{IDENTIFIER, Tok::at_least_one(Tok::alphabet())},
+   *                             std::pair{BLANK, Tok::at_least_one(Tok::whitespace())});
+   * const auto rest = lex(input, [](Tok::token_record token) { ... });
+   * ~~~
+   * @tparam Ids Types of the rule identifiers, integers or enumerations.
+   * @tparam Tokenizers Callable types `Tok::Token (Tok::Input& input)`.
+   * @param[in] rules Pairs of an identifier and a tokenizer, in order of priority.
+   * @returns A lexer.
+   */
+  template<typename... Ids, typename... Tokenizers>
+    constexpr auto lexer(std::pair<Ids, Tokenizers>... rules) noexcept
+    {
+      static_assert(sizeof...(Tokenizers) > 0, "A lexer needs at least one rule");
+      static_assert((std::is_invocable_r_v<Tok::Token, Tokenizers, Tok::Input&> && ...),
+          "Tokenizer must be a callable type 'Tok::Token (Tok::Input&)'");
+      return impl::lexer<Tokenizers...>({static_cast<std::size_t>(rules.first)...},
+          std::tuple<Tokenizers...>(std::move(rules.second)...));
+    }
+
+  /**
+   * @brief Compile a regular tokenizer into a minimized DFA.
+   * @details Tokenizers built only from Map-less character classes, literals, keyword sets,
+   * sequences, alternations, repetitions and options describe regular languages. The compiled
+   * tokenizer matches the longest prefix of the input in that language in linear time, with one
+   * table lookup per character, and calls `func` on the whole token. Where the original tokenizer
+   * is ambiguous, e.g. `Tok::str_token("a") | Tok::str_token("ab")` or
+   * `Tok::many(Tok::digit()) & Tok::digit()`, the compiled one takes the longest match instead of
+   * the first branch or the greedy repetition.
+   * ~~~.cpp
+   * constexpr auto number = Tok::compile(Tok::at_least_one(Tok::digit()) &
+   *     Tok::maybe(Tok::char_token('.') & Tok::at_least_one(Tok::digit())));
+   * ~~~
+   * The table is built at compile time when the result is `constexpr`, which then fails to compile
+   * if the tokenizer needs more than `N` positions, states or character classes.
+   * @tparam N Most positions, states and distinct character classes.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`, regular as described above.
+   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
+   * @param[in] tokenizer A callable object of type `Tokenizer`.
+   * @param[in] func A callable object of type `Map`.
+   * @returns A tokenizer of type `Tok::impl::dfa`.
+   */
+  template<std::size_t N = 64, typename Tokenizer, typename Map = mapper::none_t>
+    constexpr auto compile(const Tokenizer& tokenizer, Map&& func = mapper::none_t{}) noexcept
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      VALIDATE_MAP_TYPE(Map);
+      static_assert(impl::is_regular<Tokenizer>::value, "Tok::compile needs a tokenizer made up of Map-less "
+          "character classes, literals, keyword sets, sequences, alternations, repetitions and options");
+      static_assert(N > 1 && N <= 65536, "A DFA needs room for at least a start and a dead state");
+      return impl::dfa<N, std::decay_t<Map>>(tokenizer, std::forward<Map>(func));
+    }
+
+  /**
+   * @brief Parsers that synthesize values instead of calling Maps.
+   * @details A parser has a member function `std::optional<A> parse(Tok::Input& input) const`,
+   * where `A` is its attribute. It consumes the input and returns its attribute on a match, and
+   * leaves the input untouched on a mismatch. Parsers are combined with `operator&` and
+   * `operator|` like tokenizers. In a sequence, plain tokenizers such as `Tok::char_token(',')`
+   * are matched but contribute nothing to the attribute.
+   * ~~~.cpp
+   * struct reading { int rssi; int ber; };
+   * constexpr auto csq = Tok::attr::as<reading>(Tok::str_token("+CSQ: ") & Tok::attr::integer<int>() &
+   *     Tok::char_token(',') & Tok::attr::integer<int>());
+   * const std::optional<reading> r = csq.parse(input);
+   * ~~~
+   */
+  namespace attr {
+    /** The attribute of parts of a sequence that synthesize nothing. */
+    struct unused {};
+
+    /**
+     * @brief Check if a type is a parser of this namespace.
+     * @tparam T The type to be checked.
+     */
+    template<typename T>
+      struct is_parser : std::false_type {};
+
+    /**
+     * @brief The attribute of a parser.
+     * @tparam Parser A parser.
+     */
+    template<typename Parser>
+      using attribute_t = typename decltype(std::declval<const Parser&>().parse(std::declval<Input&>()))::value_type;
+
+    /**
+     * @brief A parser lifted from a value parser such as `Tok::impl::integer_parser`.
+     * @tparam Value_Parser A type with a member function `std::optional<A> parse(Tok::Input&) const`.
+     */
+    template<typename Value_Parser>
+      struct value {
+        Value_Parser parser;  /**< The lifted value parser. */
+
+        /**
+         * @brief Attempt to parse a value.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns The value or `std::nullopt` on a mismatch.
+         */
+        constexpr auto parse(Input& input) const
+        {
+          return parser.parse(input);
+        }
+      };
+
+    /**
+     * @brief A parser whose attribute is the token matched by a tokenizer.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct token_parser {
+        Tokenizer tokenizer;  /**< The tokenizer. */
+
+        /**
+         * @brief Attempt to match the tokenizer.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns The token or `std::nullopt` on a mismatch.
+         */
+        constexpr std::optional<Token_view> parse(Input& input) const
+        {
+          return tokenizer(input);
+        }
+      };
+
+    /**
+     * @brief A parser that matches a tokenizer and synthesizes nothing.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     */
+    template<typename Tokenizer>
+      struct skipped {
+        Tokenizer tokenizer;  /**< The tokenizer. */
+
+        /**
+         * @brief Attempt to match the tokenizer.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns An empty attribute or `std::nullopt` on a mismatch.
+         */
+        constexpr std::optional<unused> parse(Input& input) const
+        {
+          if (!tokenizer(input))
+            return {};
+          return unused{};
+        }
+      };
+
+    /**
+     * @brief A parser that matches parsers in sequence and collects their attributes in a tuple.
+     * @details Parts whose attribute is `Tok::attr::unused` are left out of the tuple, and a
+     * tuple of a single attribute collapses into that attribute.
+     * @tparam Parsers The parts, in order.
+     */
+    template<typename... Parsers>
+      struct sequence {
+        std::tuple<Parsers...> parts;  /**< The parts, in order. */
+
+        /**
+         * @brief Attempt to match all parts in sequence.
+         * @param[in,out] input The input to the parser. It is consumed only if all parts match.
+         * @returns The attributes of the parts or `std::nullopt` on a mismatch.
+         */
+        constexpr auto parse(Input& input) const
+        {
+          return parse(input, std::index_sequence_for<Parsers...>{});
+        }
+
+      private:
+        /**
+         * @brief Wrap an attribute in a tuple, unless it is empty.
+         * @tparam A The attribute type.
+         * @param[in] attribute The attribute.
+         * @returns A tuple of zero or one attribute.
+         */
+        template<typename A>
+          static constexpr auto keep(std::optional<A>&& attribute)
+          {
+            if constexpr (std::is_same_v<A, unused>)
+              return std::tuple<>{};
+            else
+              return std::tuple<A>{std::move(*attribute)};
+          }
+
+        /**
+         * @brief Collapse a tuple of a single attribute into the attribute.
+         * @tparam Tuple The tuple type.
+         * @param[in] attributes The tuple.
+         * @returns The single attribute, or the tuple itself.
+         */
+        template<typename Tuple>
+          static constexpr auto collapse(Tuple&& attributes)
+          {
+            if constexpr (std::tuple_size_v<std::decay_t<Tuple>> == 1)
+              return std::get<0>(std::forward<Tuple>(attributes));
+            else
+              return std::forward<Tuple>(attributes);
+          }
+
+        /**
+         * @brief Attempt to match all parts in sequence.
+         * @tparam Is Indices of the parts.
+         * @param[in,out] input The input to the parser. It is consumed only if all parts match.
+         * @param[in] indices The indices of all parts.
+         * @returns The attributes of the parts or `std::nullopt` on a mismatch.
+         */
+        template<std::size_t... Is>
+          constexpr auto parse(Input& input, std::index_sequence<Is...> indices) const
+          {
+            using result = decltype(collapse(std::tuple_cat(keep(std::declval<std::optional<attribute_t<Parsers>>>())...)));
+            const auto start = input;
+            std::tuple<std::optional<attribute_t<Parsers>>...> attributes;
+            if (!(((std::get<Is>(attributes) = std::get<Is>(parts).parse(input)).has_value()) && ...)) {
+              input = start;
+              return std::optional<result>{};
+            }
+            return std::optional<result>{collapse(std::tuple_cat(keep(std::move(std::get<Is>(attributes)))...))};
+          }
+      };
+
+    /**
+     * @brief A parser that tries parsers in order and yields the attribute of the first match.
+     * @tparam Parsers The branches, which all have the same attribute.
+     */
+    template<typename... Parsers>
+      struct alternation {
+        std::tuple<Parsers...> branches;  /**< The branches, in order. */
+
+        static_assert(sizeof...(Parsers) > 0, "An alternation needs at least one branch");
+
+        /** The attribute shared by the branches. */
+        using attribute = attribute_t<std::tuple_element_t<0, std::tuple<Parsers...>>>;
+
+        static_assert((std::is_same_v<attribute_t<Parsers>, attribute> && ...),
+            "All branches of an alternation must have the same attribute");
+
+        /**
+         * @brief Attempt to match one of the branches.
+         * @param[in,out] input The input to the parser. It is consumed by the matching branch.
+         * @returns The attribute of the first branch that matches or `std::nullopt` if all fail.
+         */
+        constexpr std::optional<attribute> parse(Input& input) const
+        {
+          std::optional<attribute> result;
+          std::apply([&](const auto&... branch) { ((result = branch.parse(input)) || ...); }, branches);
+          return result;
+        }
+      };
+
+    /**
+     * @brief A parser that optionally matches another one.
+     * @tparam Parser The optional parser.
+     */
+    template<typename Parser>
+      struct option {
+        Parser parser;  /**< The optional parser. */
+
+        /**
+         * @brief Attempt to match the parser.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns The attribute of the parser if it matched, `std::nullopt` inside otherwise.
+         */
+        constexpr std::optional<std::optional<attribute_t<Parser>>> parse(Input& input) const
+        {
+          return std::optional<std::optional<attribute_t<Parser>>>{std::in_place, parser.parse(input)};
+        }
+      };
+
+    /**
+     * @brief A parser that matches another one repeatedly and writes the attributes to an output iterator.
+     * @tparam Parser The repeated parser.
+     * @tparam Output_Iterator An output iterator accepting the attribute of `Parser`.
+     */
+    template<typename Parser, typename Output_Iterator>
+      struct repetition {
+        Parser parser;          /**< The repeated parser. */
+        Output_Iterator out;    /**< Receives the attributes, in order. */
+        std::size_t min;        /**< Least number of instances for a successful match. */
+
+        /**
+         * @brief Attempt to match the parser at least `min` times.
+         * @details The attributes are written as they are parsed, so the output can hold some of
+         * them even if the repetition as a whole fails.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns An empty attribute or `std::nullopt` on a mismatch.
+         */
+        constexpr std::optional<unused> parse(Input& input) const
+        {
+          const auto start = input;
+          auto it = out;
+          std::size_t count = 0;
+          while (!input.empty()) {
+            const auto before = input.size();
+            auto attribute = parser.parse(input);
+            if (!attribute)
+              break;
+            *it = std::move(*attribute);
+            ++it;
+            count++;
+            if (input.size() == before)
+              break;
+          }
+          if (count < min) {
+            input = start;
             return {};
-        const Token_view token(input.substr(0, 1));
-        func(token);
-        input.remove_prefix(1);
-        return {token};
+          }
+          return unused{};
+        }
       };
-    }
 
-  /**
-   * @brief Create a tokenizer that matches multiple instances (zero or many) of another tokenizer.
-   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] tokenizer A callable object of type `Tokenizer`.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that accepts zero or more number of tokens matched by `tokenizer`.
-   */
-  template<typename Tokenizer, typename Map = decltype(mapper::none)>
-    constexpr auto many(Tokenizer&& tokenizer, Map&& func = mapper::none) noexcept
-    {
-      VALIDATE_TOKENIZER_TYPE(Tokenizer);
-      VALIDATE_MAP_TYPE(Map);
-      return [tokenizer = std::forward<Tokenizer>(tokenizer),
-             func = std::forward<Map>(func)](Input& input) -> Token {
-               const auto token_size = impl::accumulation_size(tokenizer, input);
-               const Token_view token(input.substr(0, token_size));
-               func(token);
-               input.remove_prefix(token_size);
-               return {token};
-             };
-    }
+    /**
+     * @brief Check if a type is a tuple.
+     * @tparam T The type to be checked.
+     */
+    template<typename T>
+      struct is_tuple : std::false_type {};
 
-  /**
-   * @brief Create a tokenizer that matches an exact number number of instances of another tokenizer.
-   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] tokenizer A callable object of type `Tokenizer`.
-   * @param[in] n The number of times the token needs to be matched.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that matches a target tokenizer an exact number of times.
-   */
-  template<typename Tokenizer, typename Map = decltype(mapper::none)>
-    constexpr auto exactly(Tokenizer&& tokenizer, std::size_t n, Map&& func = mapper::none) noexcept
-    {
-      VALIDATE_TOKENIZER_TYPE(Tokenizer);
-      VALIDATE_MAP_TYPE(Map);
-      return [=, tokenizer = std::forward<Tokenizer>(tokenizer),
-             func = std::forward<Map>(func)](Input& input) -> Token {
-               const auto input_tokenize = input;
-               std::size_t token_size = 0;
-               for (std::size_t i = 0; i < n; i++) {
-                 auto token = tokenizer(input);
-                 if (!token)
-                   return {};
-                 token_size += (*token).size();
-               }
-               const Token_view token(input_tokenize.substr(0, token_size));
-               func(token);
-               return {token};
-             };
-    }
+    /**
+     * @brief Specialization for tuples.
+     * @tparam Ts The types of the elements.
+     */
+    template<typename... Ts>
+      struct is_tuple<std::tuple<Ts...>> : std::true_type {};
 
-  /**
-   * @brief Create a tokenizer that matches at least one instance of another tokenizer.
-   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] tokenizer A callable object of type `Tokenizer`.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that accepts at least one instance of the tokens matched by `tokenizer`.
-   */
-  template<typename Tokenizer, typename Map = decltype(mapper::none)>
-    constexpr auto at_least_one(Tokenizer&& tokenizer, Map&& func = mapper::none) noexcept
-    {
-      VALIDATE_TOKENIZER_TYPE(Tokenizer);
-      VALIDATE_MAP_TYPE(Map);
-      return [tokenizer = std::forward<Tokenizer>(tokenizer),
-             func = std::forward<Map>(func)](Input& input) -> Token {
-               const auto input_tokenize = input;
-               const auto first_token = tokenizer(input);
-               if (!first_token)
-                 return {};
-               std::size_t token_size_trailing = impl::accumulation_size(tokenizer, input);
-               const Token_view token(input_tokenize.substr(0, token_size_trailing + (*first_token).size()));
-               func(token);
-               input.remove_prefix(token_size_trailing);
-               return {token};
-             };
-    }
+    /**
+     * @brief A parser that builds a type out of the attribute of another one.
+     * @tparam T The type built, e.g. a struct with one member per attribute.
+     * @tparam Parser The parser.
+     */
+    template<typename T, typename Parser>
+      struct construct {
+        Parser parser;  /**< The parser. */
+
+        /**
+         * @brief Attempt to match the parser and build its attribute into a `T`.
+         * @details A tuple attribute is spread over the members of `T`.
+         * @param[in,out] input The input to the parser. It is consumed on a match.
+         * @returns The built object or `std::nullopt` on a mismatch.
+         */
+        constexpr std::optional<T> parse(Input& input) const
+        {
+          auto attribute = parser.parse(input);
+          if (!attribute)
+            return {};
+          if constexpr (is_tuple<attribute_t<Parser>>::value)
+            return std::apply([](auto&&... members) { return T{std::move(members)...}; }, std::move(*attribute));
+          else
+            return T{std::move(*attribute)};
+        }
+      };
+
+    /**
+     * @brief Specialization for lifted value parsers.
+     * @tparam Value_Parser The lifted value parser.
+     */
+    template<typename Value_Parser>
+      struct is_parser<value<Value_Parser>> : std::true_type {};
+
+    /**
+     * @brief Specialization for token parsers.
+     * @tparam Tokenizer The tokenizer.
+     */
+    template<typename Tokenizer>
+      struct is_parser<token_parser<Tokenizer>> : std::true_type {};
+
+    /**
+     * @brief Specialization for skipped tokenizers.
+     * @tparam Tokenizer The tokenizer.
+     */
+    template<typename Tokenizer>
+      struct is_parser<skipped<Tokenizer>> : std::true_type {};
+
+    /**
+     * @brief Specialization for sequences.
+     * @tparam Parsers The parts.
+     */
+    template<typename... Parsers>
+      struct is_parser<sequence<Parsers...>> : std::true_type {};
+
+    /**
+     * @brief Specialization for alternations.
+     * @tparam Parsers The branches.
+     */
+    template<typename... Parsers>
+      struct is_parser<alternation<Parsers...>> : std::true_type {};
+
+    /**
+     * @brief Specialization for options.
+     * @tparam Parser The optional parser.
+     */
+    template<typename Parser>
+      struct is_parser<option<Parser>> : std::true_type {};
+
+    /**
+     * @brief Specialization for repetitions.
+     * @tparam Parser The repeated parser.
+     * @tparam Output_Iterator The output iterator.
+     */
+    template<typename Parser, typename Output_Iterator>
+      struct is_parser<repetition<Parser, Output_Iterator>> : std::true_type {};
+
+    /**
+     * @brief Specialization for constructed types.
+     * @tparam T The type built.
+     * @tparam Parser The parser.
+     */
+    template<typename T, typename Parser>
+      struct is_parser<construct<T, Parser>> : std::true_type {};
+
+    /**
+     * @brief `true` if `T` (after decay) is a parser of this namespace.
+     * @tparam T The type to be checked.
+     */
+    template<typename T>
+      inline constexpr bool is_parser_v = is_parser<std::decay_t<T>>::value;
+
+    /**
+     * @brief Turn a part of a sequence into a parser.
+     * @tparam T A parser, or a tokenizer whose match is skipped.
+     * @param[in] part The part.
+     * @returns The part itself if it is a parser, a `Tok::attr::skipped` otherwise.
+     */
+    template<typename T>
+      constexpr auto as_parser(T&& part)
+      {
+        if constexpr (is_parser_v<T>) {
+          return std::decay_t<T>(std::forward<T>(part));
+        } else {
+          VALIDATE_TOKENIZER_TYPE(T);
+          return skipped<std::decay_t<T>>{std::forward<T>(part)};
+        }
+      }
+
+    /**
+     * @brief Check if a type is a sequence.
+     * @tparam T The type to be checked.
+     */
+    template<typename T>
+      struct is_sequence : std::false_type {};
+
+    /**
+     * @brief Specialization for sequences.
+     * @tparam Parsers The parts.
+     */
+    template<typename... Parsers>
+      struct is_sequence<sequence<Parsers...>> : std::true_type {};
+
+    /**
+     * @brief Check if a type is an alternation.
+     * @tparam T The type to be checked.
+     */
+    template<typename T>
+      struct is_alternation : std::false_type {};
+
+    /**
+     * @brief Specialization for alternations.
+     * @tparam Parsers The branches.
+     */
+    template<typename... Parsers>
+      struct is_alternation<alternation<Parsers...>> : std::true_type {};
+
+    /**
+     * @brief Collect the parts a parser or tokenizer contributes to a sequence.
+     * @tparam T A parser or a tokenizer.
+     * @param[in] part The part.
+     * @returns The parts of a sequence, or a tuple holding the part as a parser.
+     */
+    template<typename T>
+      constexpr auto parts_of(T&& part)
+      {
+        if constexpr (is_sequence<std::decay_t<T>>::value)
+          return std::forward<T>(part).parts;
+        else
+          return std::make_tuple(attr::as_parser(std::forward<T>(part)));
+      }
+
+    /**
+     * @brief Collect the branches a parser contributes to an alternation.
+     * @tparam T A parser.
+     * @param[in] branch The branch.
+     * @returns The branches of an alternation, or a tuple holding the parser.
+     */
+    template<typename T>
+      constexpr auto branches_of(T&& branch)
+      {
+        if constexpr (is_alternation<std::decay_t<T>>::value)
+          return std::forward<T>(branch).branches;
+        else
+          return std::make_tuple(std::decay_t<T>(std::forward<T>(branch)));
+      }
+
+    /**
+     * @brief Create a parser for an integer, whose attribute is its value.
+     * @tparam T An integral type.
+     * @returns A parser with the attribute `T`.
+     */
+    template<typename T>
+      constexpr auto integer() noexcept
+      {
+        return value<decltype(Tok::integer<T>())>{Tok::integer<T>()};
+      }
+
+    /**
+     * @brief Create a parser for hexadecimal digits, whose attribute is their value.
+     * @tparam T An integral type.
+     * @returns A parser with the attribute `T`.
+     */
+    template<typename T>
+      constexpr auto hex_integer() noexcept
+      {
+        return value<decltype(Tok::hex_integer<T>())>{Tok::hex_integer<T>()};
+      }
+
+    /**
+     * @brief Create a parser for a decimal number, whose attribute is its value.
+     * @tparam T A floating point type.
+     * @returns A parser with the attribute `T`.
+     */
+    template<typename T = double>
+      constexpr auto decimal() noexcept
+      {
+        return value<decltype(Tok::decimal<T>())>{Tok::decimal<T>()};
+      }
+
+    /**
+     * @brief Create a parser whose attribute is the token matched by a tokenizer.
+     * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @returns A parser with the attribute `Tok::Token_view`.
+     */
+    template<typename Tokenizer>
+      constexpr auto token(Tokenizer&& tokenizer) noexcept
+      {
+        VALIDATE_TOKENIZER_TYPE(Tokenizer);
+        return token_parser<std::decay_t<Tokenizer>>{std::forward<Tokenizer>(tokenizer)};
+      }
+
+    /**
+     * @brief Create a parser that optionally matches another one.
+     * @tparam Parser A parser.
+     * @param[in] parser The optional parser.
+     * @returns A parser with the attribute `std::optional<A>`, `A` being the attribute of `parser`.
+     */
+    template<typename Parser>
+      constexpr auto maybe(Parser&& parser) noexcept
+      {
+        static_assert(is_parser_v<Parser>, "Tok::attr::maybe needs a parser");
+        return option<std::decay_t<Parser>>{std::forward<Parser>(parser)};
+      }
+
+    /**
+     * @brief Create a parser that matches another one zero or more times.
+     * @tparam Parser A parser.
+     * @tparam Output_Iterator An output iterator accepting the attribute of `Parser`.
+     * @param[in] parser The repeated parser.
+     * @param[in] out Receives the attributes, in order, e.g. a `std::back_insert_iterator`.
+     * @returns A parser that adds nothing to the attribute of a sequence.
+     */
+    template<typename Parser, typename Output_Iterator>
+      constexpr auto many(Parser&& parser, Output_Iterator out) noexcept
+      {
+        static_assert(is_parser_v<Parser>, "Tok::attr::many needs a parser");
+        return repetition<std::decay_t<Parser>, Output_Iterator>{std::forward<Parser>(parser), out, 0};
+      }
+
+    /**
+     * @brief Create a parser that matches another one one or more times.
+     * @tparam Parser A parser.
+     * @tparam Output_Iterator An output iterator accepting the attribute of `Parser`.
+     * @param[in] parser The repeated parser.
+     * @param[in] out Receives the attributes, in order, e.g. a `std::back_insert_iterator`.
+     * @returns A parser that adds nothing to the attribute of a sequence.
+     */
+    template<typename Parser, typename Output_Iterator>
+      constexpr auto at_least_one(Parser&& parser, Output_Iterator out) noexcept
+      {
+        static_assert(is_parser_v<Parser>, "Tok::attr::at_least_one needs a parser");
+        return repetition<std::decay_t<Parser>, Output_Iterator>{std::forward<Parser>(parser), out, 1};
+      }
+
+    /**
+     * @brief Create a parser that builds a type out of the attribute of another one.
+     * @details The members of `T` are initialized, in order, from the attributes of a sequence.
+     * @tparam T The type built.
+     * @tparam Parser A parser.
+     * @param[in] parser The parser.
+     * @returns A parser with the attribute `T`.
+     */
+    template<typename T, typename Parser>
+      constexpr auto as(Parser&& parser) noexcept
+      {
+        static_assert(is_parser_v<Parser>, "Tok::attr::as needs a parser");
+        return construct<T, std::decay_t<Parser>>{std::forward<Parser>(parser)};
+      }
+
+    /**
+     * @brief Create a parser that matches two parts in sequence.
+     * @details Nested sequences are flattened, so `a & b & c` has the attribute
+     * `std::tuple<A, B, C>`. Tokenizers are matched but add nothing to the attribute.
+     * @tparam L A parser or a tokenizer.
+     * @tparam R A parser or a tokenizer.
+     * @param[in] l The part matched first.
+     * @param[in] r The part matched second.
+     * @returns A parser of type `Tok::attr::sequence`.
+     */
+    template<typename L, typename R,
+      typename std::enable_if<is_parser_v<L> || is_parser_v<R>>::type* = nullptr>
+      constexpr auto operator&(L&& l, R&& r) noexcept
+      {
+        auto parts = std::tuple_cat(attr::parts_of(std::forward<L>(l)), attr::parts_of(std::forward<R>(r)));
+        return std::apply([](auto&&... all) {
+            return sequence<std::decay_t<decltype(all)>...>{{std::move(all)...}};
+          }, std::move(parts));
+      }
+
+    /**
+     * @brief Create a parser that tries two parsers in order.
+     * @details Nested alternations are flattened. Both parsers must have the same attribute.
+     * @tparam L A parser.
+     * @tparam R A parser.
+     * @param[in] l The parser tried first.
+     * @param[in] r The parser tried second.
+     * @returns A parser of type `Tok::attr::alternation`.
+     */
+    template<typename L, typename R,
+      typename std::enable_if<is_parser_v<L> && is_parser_v<R>>::type* = nullptr>
+      constexpr auto operator|(L&& l, R&& r) noexcept
+      {
+        auto branches = std::tuple_cat(attr::branches_of(std::forward<L>(l)), attr::branches_of(std::forward<R>(r)));
+        return std::apply([](auto&&... all) {
+            return alternation<std::decay_t<decltype(all)>...>{{std::move(all)...}};
+          }, std::move(branches));
+      }
+  }
 
   /**
-   * @brief Create a tokenizer that optionally accepts matches of another tokenizer.
-   * @details In case of an empty match, `func` is still called.
-   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] tokenizer A callable object of type `Tokenizer`.
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that optionally accepts one instance of the tokens matched by `tokenizer`.
+   * @brief A table of the tokens found in a literal at compile time by `Tok::static_parse`.
+   * @tparam N Most tokens the table can hold.
    */
-  template<typename Tokenizer, typename Map = decltype(mapper::none)>
-    constexpr auto maybe(Tokenizer&& tokenizer, Map&& func = mapper::none) noexcept
-    {
-      VALIDATE_TOKENIZER_TYPE(Tokenizer);
-      VALIDATE_MAP_TYPE(Map);
-      return [tokenizer = std::forward<Tokenizer>(tokenizer),
-             func = std::forward<Map>(func)](Input& input) -> Token {
-               const auto token = tokenizer(input);
-               if (!token) {
-                 func({});
-                 return {Token_view{}};
-               }
-               func(*token);
-               return token;
-             };
-    }
+  template<std::size_t N>
+    struct static_tokens {
+      token_record records[N] = {}; /**< The tokens, in order. Only the first `count` are used. */
+      std::size_t count = 0;        /**< Number of tokens found. */
+      std::size_t consumed = 0;     /**< Number of characters covered by the tokens. */
+      bool complete = false;        /**< `true` if the tokens cover the whole literal. */
+
+      /**
+       * @brief Count the tokens.
+       * @returns Number of tokens found.
+       */
+      constexpr std::size_t size() const noexcept
+      {
+        return count;
+      }
+
+      /**
+       * @brief Access a token.
+       * @param[in] i Index of the token, less than `size()`.
+       * @returns The token.
+       */
+      constexpr const token_record& operator[](std::size_t i) const noexcept
+      {
+        return records[i];
+      }
+
+      /**
+       * @brief Iterate over the tokens.
+       * @returns A pointer to the first token.
+       */
+      constexpr const token_record* begin() const noexcept
+      {
+        return records;
+      }
+
+      /**
+       * @brief Mark the end of the tokens.
+       * @returns A pointer past the last token.
+       */
+      constexpr const token_record* end() const noexcept
+      {
+        return records + count;
+      }
+    };
+
+  namespace impl {
+    /**
+     * @brief Report that a `Tok::static_tokens` table is too small.
+     * @details It is deliberately not `constexpr`, so that reaching it during constant evaluation
+     * fails the build.
+     */
+    inline void static_capacity_exceeded() noexcept {}
+
+    /**
+     * @brief Check if a tokenizer is a longest-match lexer.
+     * @tparam T The type to be checked.
+     */
+    template<typename T>
+      struct is_lexer : std::false_type {};
+
+    /**
+     * @brief Specialization for lexers.
+     * @tparam Tokenizers The tokenizers of the rules.
+     */
+    template<typename... Tokenizers>
+      struct is_lexer<lexer<Tokenizers...>> : std::true_type {};
+
+    /**
+     * @brief View a literal as an input.
+     * @tparam Text A character array or a type convertible to `Tok::Input`.
+     * @param[in] text The literal.
+     * @returns The characters of the literal, without the terminating NUL of an array.
+     */
+    template<typename Text>
+      constexpr Input literal_input(const Text& text) noexcept
+      {
+        if constexpr (std::is_array_v<Text>)
+          return Input(text, std::extent_v<Text> - 1);
+        else
+          return Input(text);
+      }
+
+    /**
+     * @brief Apply a tokenizer, a lexer or a parser of `Tok::attr` over a literal.
+     * @tparam N Most tokens the table can hold.
+     * @tparam Tokenizer A tokenizer, a lexer created by `Tok::lexer` or a parser of `Tok::attr`.
+     * @param[in] tokenizer A callable object of type `Tokenizer`.
+     * @param[in] input The literal.
+     * @returns The attribute of a parser, or else a `Tok::static_tokens` table.
+     */
+    template<std::size_t N, typename Tokenizer>
+      constexpr auto parse_statically(const Tokenizer& tokenizer, Input input)
+      {
+        if constexpr (attr::is_parser_v<Tokenizer>) {
+          return tokenizer.parse(input);
+        } else {
+          static_tokens<N> table;
+          const auto record = [&table](token_record token) {
+            if (table.count == N)
+              static_capacity_exceeded();
+            else
+              table.records[table.count++] = token;
+          };
+          auto rest = input;
+          if constexpr (is_lexer<Tokenizer>::value) {
+            rest = tokenizer(input, record);
+          } else {
+            VALIDATE_TOKENIZER_TYPE(Tokenizer);
+            while (!rest.empty()) {
+              const auto offset = input.size() - rest.size();
+              const auto token = tokenizer(rest);
+              if (!token || (*token).empty())
+                break;
+              record(token_record{0, offset, (*token).size()});
+            }
+          }
+          table.consumed = input.size() - rest.size();
+          table.complete = rest.empty();
+          return table;
+        }
+      }
+  }
 
   /**
-   * @brief Apply a callable object to the output of a sequence tokenizer.
-   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
-   * @tparam Map A callable type `void (Tok::Token_view)`. It is called on the extracted token.
-   * @param[in] seq A sequence tokenizer (returned by Tok::sequence).
-   * @param[in] func A callable object of type `Map`.
-   * @returns A lambda that accepts an ordered sequence of matches by two tokenizers and
-   * applies a callable object to the result.
+   * @brief The outcome of a tokenizer over a literal, computed at compile time.
+   * @details Being a `constexpr` variable, the outcome is guaranteed to be computed by the
+   * compiler, so it costs nothing at run time. A tokenizer that cannot run at compile time, e.g.
+   * because a Map captures a `std::string`, fails the build instead of silently running at startup.
+   * - A tokenizer is applied repeatedly, as by `Tok::tokens`, and its tokens are recorded, with
+   *   the identifier 0, in a `Tok::static_tokens` table.
+   * - A lexer created by `Tok::lexer` records its tokens and their rule identifiers in the table.
+   * - A parser of `Tok::attr` yields its attribute, e.g. the parsed integers of a command.
+   * ~~~.cpp
+   * static constexpr auto field = Tok::at_least_one(Tok::none_of(",")) & Tok::maybe(Tok::char_token(','));
+   * static constexpr char format[] = "AT+CGDCONT,1,IP,internet";
+   * constexpr auto& table = Tok::static_parse<field, format>;
+   * static_assert(table.size() == 4 && table[1].offset == 11);
+   * ~~~
+   * @tparam Tokenizer A `constexpr` tokenizer, lexer or parser with static storage duration.
+   * @tparam Text A `constexpr` character array or `Tok::Input` with static storage duration.
+   * @tparam N Most tokens the table can hold. Finding more fails the build.
    */
-  template<typename Tokenizer, typename Map>
-    constexpr auto map(Tokenizer&& seq, Map&& func) noexcept
-    {
-      VALIDATE_TOKENIZER_TYPE(Tokenizer);
-      VALIDATE_MAP_TYPE(Map);
-      return [seq = std::forward<Tokenizer>(seq),
-             func = std::forward<Map>(func)](Input& input) -> Token {
-               const auto token = seq(input);
-               if (!token)
-                 return {};
-               func(*token);
-               return {token};
-             };
-    }
+  template<const auto& Tokenizer, const auto& Text, std::size_t N = 64>
+    inline constexpr auto static_parse = impl::parse_statically<N>(Tokenizer, impl::literal_input(Text));
 
 }
 
 /**
  * @brief Create a tokenizer that accepts matches of multiple tokenizers in sequence.
- * @details All tokenizers must succeed for a successful match.
+ * @details All tokenizers must succeed for a successful match. Chains of sequences are
+ * flattened into a single `Tok::impl::sequence`, so `a & b & c` saves and restores the input
+ * once, however long the chain is.
  * @tparam TokenizerL A callable type `Tok::Token (Tok::Input& input)`.
  * @tparam TokenizerR A callable type `Tok::Token (Tok::Input& input)`.
  * @param[in] tl A callable object of type `TokenizerL`. This is first to be evaluated.
  * @param[in] tr A callable object of type `TokenizerR`. This is second to be evaluated.
- * @returns A lambda that accepts an ordered sequence of matches by two tokenizers.
+ * @returns A tokenizer that accepts an ordered sequence of matches by two tokenizers.
  */
 template<typename TokenizerL, typename TokenizerR,
   typename std::enable_if<
     std::is_invocable_r_v<Tok::Token, TokenizerL, Tok::Input&> &&
     std::is_invocable_r_v<Tok::Token, TokenizerR, Tok::Input&>
-  >* = nullptr>
+  >::type* = nullptr>
 constexpr auto operator&(TokenizerL&& tl, TokenizerR&& tr) noexcept
 {
-  return [tl = std::forward<TokenizerL>(tl),
-         tr = std::forward<TokenizerR>(tr)](Tok::Input& input) -> Tok::Token {
-           const auto input_tokenize = input;
-           const auto tokenL = tl(input);
-           if (!tokenL) {
-             input = input_tokenize;
-             return {};
-           }
-           const auto tokenR = tr(input);
-           if (!tokenR) {
-             input = input_tokenize;
-             return {};
-           }
-           return {input_tokenize.substr(0, (*tokenL).size() + (*tokenR).size())};
-         };
+  return Tok::impl::make_sequence(std::tuple_cat(
+        Tok::impl::parts_of(std::forward<TokenizerL>(tl)),
+        Tok::impl::parts_of(std::forward<TokenizerR>(tr))));
 }
 
 /**
  * @brief Create a tokenizer that chooses a successful match between two tokenizers.
- * @details At least one tokenizer must succeed for this tokenizer to succeed.
+ * @details At least one tokenizer must succeed for this tokenizer to succeed. Chains of
+ * alternations are flattened into a single `Tok::impl::alternation`, which only tries the
+ * branches whose FIRST set admits the next character of the input. Branches are still tried
+ * in the order they were listed, so the first successful one wins.
  * @tparam TokenizerL A callable type `Tok::Token (Tok::Input& input)`.
  * @tparam TokenizerR A callable type `Tok::Token (Tok::Input& input)`.
  * @param[in] tl A callable object of type `TokenizerL`. This is the first option to try.
  * @param[in] tr A callable object of type `TokenizerR`. This is the second option to try.
- * @returns A lambda that chooses the tokenizer that succeeds. In case all options fail,
+ * @returns A tokenizer that chooses the tokenizer that succeeds. In case all options fail,
  * the overall tokenizer also fails.
  */
 template<typename TokenizerL, typename TokenizerR,
   typename std::enable_if<
     std::is_invocable_r_v<Tok::Token, TokenizerL, Tok::Input&> &&
     std::is_invocable_r_v<Tok::Token, TokenizerR, Tok::Input&>
-  >* = nullptr>
+  >::type* = nullptr>
+constexpr auto operator|(TokenizerL&& tl, TokenizerR&& tr) noexcept
+{
+  return Tok::impl::make_alternation(std::tuple_cat(
+        Tok::impl::branches_of(std::forward<TokenizerL>(tl)),
+        Tok::impl::branches_of(std::forward<TokenizerR>(tr))));
+}
+
+/**
+ * @brief Create a tokenizer that accepts matches of multiple tokenizers in sequence, over input
+ * made of characters other than `char`, e.g. `Tok::utf16::Input`.
+ * @details Chains of sequences are flattened into a single `Tok::impl::basic_sequence`.
+ * @tparam TokenizerL A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+ * @tparam TokenizerR A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+ * @param[in] tl A callable object of type `TokenizerL`. This is first to be evaluated.
+ * @param[in] tr A callable object of type `TokenizerR`. This is second to be evaluated.
+ * @returns A tokenizer that accepts an ordered sequence of matches by two tokenizers.
+ */
+template<typename TokenizerL, typename TokenizerR,
+  typename std::enable_if<Tok::impl::common_char_type<TokenizerL, TokenizerR>::value>::type* = nullptr>
+constexpr auto operator&(TokenizerL&& tl, TokenizerR&& tr) noexcept
+{
+  using char_type = typename Tok::impl::common_char_type<TokenizerL, TokenizerR>::candidate;
+  return std::apply([](auto&&... all) {
+      return Tok::impl::basic_sequence<char_type, std::decay_t<decltype(all)>...>{{std::move(all)...}};
+    }, std::tuple_cat(Tok::impl::basic_parts_of<char_type>(std::forward<TokenizerL>(tl)),
+        Tok::impl::basic_parts_of<char_type>(std::forward<TokenizerR>(tr))));
+}
+
+/**
+ * @brief Create a tokenizer that chooses a successful match between two tokenizers, over input
+ * made of characters other than `char`, e.g. `Tok::utf16::Input`.
+ * @details Chains of alternations are flattened into a single `Tok::impl::basic_alternation`.
+ * Branches are tried in the order they were listed, so the first successful one wins.
+ * @tparam TokenizerL A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+ * @tparam TokenizerR A callable type `Tok::basic_token<CharT> (Tok::basic_input<CharT>& input)`.
+ * @param[in] tl A callable object of type `TokenizerL`. This is the first option to try.
+ * @param[in] tr A callable object of type `TokenizerR`. This is the second option to try.
+ * @returns A tokenizer that chooses the tokenizer that succeeds.
+ */
+template<typename TokenizerL, typename TokenizerR,
+  typename std::enable_if<Tok::impl::common_char_type<TokenizerL, TokenizerR>::value>::type* = nullptr>
 constexpr auto operator|(TokenizerL&& tl, TokenizerR&& tr) noexcept
 {
-  return [tl = std::forward<TokenizerL>(tl),
-         tr = std::forward<TokenizerR>(tr)](Tok::Input& input) -> Tok::Token {
-           if (const auto token = tl(input); token)
-             return token;
-           return tr(input);
-         };
+  using char_type = typename Tok::impl::common_char_type<TokenizerL, TokenizerR>::candidate;
+  return std::apply([](auto&&... all) {
+      return Tok::impl::basic_alternation<char_type, std::decay_t<decltype(all)>...>{{std::move(all)...}};
+    }, std::tuple_cat(Tok::impl::basic_branches_of<char_type>(std::forward<TokenizerL>(tl)),
+        Tok::impl::basic_branches_of<char_type>(std::forward<TokenizerR>(tr))));
 }
 
 #endif
@@ -0,0 +1,387 @@
+/**
+ * @file lextok_batch.h
+ * @author Nilangshu Bidyanta
+ * @version 0.4.0
+ * @copyright (c) 2018 Nilangshu Bidyanta. MIT License.
+ * @brief Parallel tokenization of large inputs such as memory-mapped log files.
+ * @details The input is cut into chunks at record delimiters. Worker threads take chunks one at a
+ * time, apply the same immutable tokenizer to every record in them and accumulate one result per
+ * chunk. The results are returned in the order of the chunks, so merging them preserves the order
+ * of the records. Inputs without delimiters can instead be lexed in parallel by `Tok::parallel_lex`,
+ * which resynchronizes the chunks where tokens straddle their boundaries.
+ *
+ * Unlike lextok.h, this header depends on threads and, for `Tok::mapped_file`, on POSIX.
+ */
+#ifndef LEXTOK_BATCH_H
+#define LEXTOK_BATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lextok.h"
+
+namespace Tok {
+
+  /**
+   * @brief A read-only file mapped into memory, viewed as an input.
+   */
+  class mapped_file {
+    public:
+      /**
+       * @brief Create an empty mapping.
+       */
+      mapped_file() noexcept = default;
+
+      /**
+       * @brief Map a file into memory.
+       * @param[in] path Path of the file.
+       * @details On failure the mapping is left empty and `is_open()` returns `false`. Empty files
+       * are opened successfully and viewed as an empty input.
+       */
+      explicit mapped_file(const char* path) noexcept
+      {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+          return;
+        struct stat info;
+        if (::fstat(fd, &info) == 0) {
+          size = static_cast<std::size_t>(info.st_size);
+          if (size == 0) {
+            opened = true;
+          } else if (void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); data != MAP_FAILED) {
+            ::madvise(data, size, MADV_SEQUENTIAL);
+            base = static_cast<const char*>(data);
+            opened = true;
+          }
+        }
+        ::close(fd);
+        if (!opened)
+          size = 0;
+      }
+
+      /**
+       * @brief Take over the mapping of another file.
+       * @param[in,out] other The mapping to be moved. It is left empty.
+       */
+      mapped_file(mapped_file&& other) noexcept :
+        base(std::exchange(other.base, nullptr)), size(std::exchange(other.size, 0)),
+        opened(std::exchange(other.opened, false))
+      {}
+
+      /**
+       * @brief Replace the mapping by that of another file.
+       * @param[in,out] other The mapping to be moved. It is left empty.
+       * @returns This mapping.
+       */
+      mapped_file& operator=(mapped_file&& other) noexcept
+      {
+        if (this != &other) {
+          unmap();
+          base = std::exchange(other.base, nullptr);
+          size = std::exchange(other.size, 0);
+          opened = std::exchange(other.opened, false);
+        }
+        return *this;
+      }
+
+      mapped_file(const mapped_file&) = delete;
+      mapped_file& operator=(const mapped_file&) = delete;
+
+      /**
+       * @brief Unmap the file.
+       */
+      ~mapped_file()
+      {
+        unmap();
+      }
+
+      /**
+       * @brief Check if the file was mapped.
+       * @retval true The file was mapped.
+       * @retval false The file could not be opened or mapped.
+       */
+      bool is_open() const noexcept
+      {
+        return opened;
+      }
+
+      /**
+       * @brief View the contents of the file.
+       * @returns The contents of the file. The view is valid as long as the mapping is.
+       */
+      Input view() const noexcept
+      {
+        return base ? Input(base, size) : Input();
+      }
+
+    private:
+      /**
+       * @brief Release the mapping, if any.
+       */
+      void unmap() noexcept
+      {
+        if (base)
+          ::munmap(const_cast<char*>(base), size);
+        base = nullptr;
+        size = 0;
+        opened = false;
+      }
+
+      const char* base = nullptr; /**< Start of the mapping. */
+      std::size_t size = 0;       /**< Size of the file. */
+      bool opened = false;        /**< `true` if the file was mapped. */
+  };
+
+  namespace impl {
+    /**
+     * @brief The tokens of a chunk, lexed from its start before the end of the previous chunk is known.
+     */
+    struct speculation {
+      std::vector<token_record> tokens;   /**< The tokens, in order. */
+      std::size_t stop = 0;               /**< Offset where lexing stopped, at or past the end of the chunk unless it failed. */
+      bool failed = false;                /**< `true` if no rule matched at `stop`. */
+    };
+
+    /**
+     * @brief Process chunks across a pool of threads.
+     * @details Each worker repeatedly claims the next unprocessed chunk, so fast workers pick up
+     * the slack of slow ones. The calling thread is one of the workers.
+     * @tparam Work A callable type `void (std::size_t chunk)`.
+     * @param[in] chunks Number of chunks.
+     * @param[in] threads Number of worker threads, 0 for one per hardware thread.
+     * @param[in] work Called once with the index of every chunk.
+     */
+    template<typename Work>
+      void for_each_chunk(std::size_t chunks, std::size_t threads, const Work& work)
+      {
+        std::atomic<std::size_t> next{0};
+        const auto claim = [&]() {
+          for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < chunks;
+              i = next.fetch_add(1, std::memory_order_relaxed))
+            work(i);
+        };
+        std::size_t count = threads ? threads : std::thread::hardware_concurrency();
+        count = std::max<std::size_t>(1, std::min(count, chunks));
+        std::vector<std::thread> workers;
+        workers.reserve(count - 1);
+        for (std::size_t i = 1; i < count; i++)
+          workers.emplace_back(claim);
+        claim();
+        for (auto& worker : workers)
+          worker.join();
+      }
+
+    /**
+     * @brief Lex one token and record it.
+     * @tparam Lexer A lexer created by `Tok::lexer`.
+     * @param[in] lexer The lexer.
+     * @param[in] input The whole input.
+     * @param[in,out] offset Offset of the token. It is advanced past the token on a match.
+     * @param[out] tokens Receives the token.
+     * @retval true A rule matched.
+     * @retval false No rule matched at the offset.
+     */
+    template<typename Lexer>
+      bool lex_one(const Lexer& lexer, Input input, std::size_t& offset, std::vector<token_record>& tokens)
+      {
+        auto rest = input.substr(offset);
+        std::size_t id = 0;
+        const auto token = lexer.match(rest, id);
+        if (!token)
+          return false;
+        tokens.push_back(token_record{id, offset, (*token).size()});
+        offset += (*token).size();
+        return true;
+      }
+  }
+
+  /**
+   * @brief Settings of a batch tokenization.
+   */
+  struct batch_options {
+    char delimiter = '\n';              /**< Character that ends every record. */
+    std::size_t chunk_size = 1 << 20;   /**< Approximate size of the chunks handed to the workers. */
+    std::size_t threads = 0;            /**< Number of worker threads, 0 for one per hardware thread. */
+  };
+
+  /**
+   * @brief Cut an input into chunks that hold whole records.
+   * @details Every chunk but the last is at least `chunk_size` characters long and ends just after a
+   * delimiter.
+   * @param[in] input The input to be cut.
+   * @param[in] delimiter Character that ends every record.
+   * @param[in] chunk_size Approximate size of the chunks.
+   * @returns The chunks, in order.
+   */
+  inline std::vector<Input> split_chunks(Input input, char delimiter, std::size_t chunk_size)
+  {
+    std::vector<Input> chunks;
+    if (chunk_size == 0)
+      chunk_size = 1;
+    while (!input.empty()) {
+      auto end = chunk_size < input.size() ? input.find(delimiter, chunk_size - 1) : Input::npos;
+      end = end == Input::npos ? input.size() : end + 1;
+      chunks.push_back(input.substr(0, end));
+      input.remove_prefix(end);
+    }
+    return chunks;
+  }
+
+  /**
+   * @brief Tokenize every record of a delimited input across a pool of threads.
+   * @details The input is cut into chunks with `Tok::split_chunks`. Each worker repeatedly claims
+   * the next unprocessed chunk, so fast workers pick up the slack of slow ones. Every record of a
+   * chunk, without its delimiter, is given to the tokenizer, and `visit` folds the outcome into the
+   * result of the chunk. The tokenizer is shared by all workers and must therefore not mutate state
+   * through its maps; `visit` only ever sees the result of the chunk it is working on.
+   * ~~~.cpp
+   * Tok::mapped_file log("modem.log");
+   * const auto counts = Tok::batch_tokenize<std::size_t>(log.view(), at_CGPADDR_cmd_parser,
+   *     [](std::size_t& count, Tok::Input record, Tok::Token token) { count += token.has_value(); });
+   * ~~~
+   * @tparam Result Default constructible type of the result of a chunk.
+   * @tparam Tokenizer A callable type `Tok::Token (Tok::Input& input)`.
+   * @tparam Visitor A callable type `void (Result&, Tok::Input record, Tok::Token token)`.
+   * @param[in] input The input to be tokenized.
+   * @param[in] tokenizer The tokenizer applied to every record.
+   * @param[in] visit Called with the result of the chunk, the record and its token, in record order within a chunk.
+   * @param[in] options Settings of the batch.
+   * @returns The result of every chunk, in the order of the chunks.
+   */
+  template<typename Result, typename Tokenizer, typename Visitor>
+    std::vector<Result> batch_tokenize(Input input, const Tokenizer& tokenizer, const Visitor& visit,
+        const batch_options& options = {})
+    {
+      VALIDATE_TOKENIZER_TYPE(Tokenizer);
+      static_assert(std::is_invocable_v<const Visitor&, Result&, Input, Token>,
+          "Visitor must be a callable type 'void (Result&, Tok::Input record, Tok::Token token)'");
+      const auto chunks = split_chunks(input, options.delimiter, options.chunk_size);
+      std::vector<Result> results(chunks.size());
+      impl::for_each_chunk(chunks.size(), options.threads, [&](std::size_t i) {
+          auto chunk = chunks[i];
+          while (!chunk.empty()) {
+            const auto end = chunk.find(options.delimiter);
+            const auto record = chunk.substr(0, end);
+            chunk.remove_prefix(end == Input::npos ? chunk.size() : end + 1);
+            auto rest = record;
+            visit(results[i], record, tokenizer(rest));
+          }
+        });
+      return results;
+    }
+
+  /**
+   * @brief Settings of a parallel lexing.
+   */
+  struct lex_options {
+    std::size_t chunk_size = 1 << 20;   /**< Size of the chunks handed to the workers. */
+    std::size_t threads = 0;            /**< Number of worker threads, 0 for one per hardware thread. */
+    char_set sync = {};                 /**< Characters a token is likely to start after, e.g. newlines, or none. */
+  };
+
+  /**
+   * @brief The tokens of a parallel lexing.
+   */
+  struct lex_result {
+    std::vector<token_record> tokens;   /**< The tokens, in order, with offsets from the start of the input. */
+    Input rest;                         /**< The input that could not be lexed, empty if all of it was. */
+    std::size_t relexed = 0;            /**< Characters lexed again to resynchronize at chunk boundaries. */
+  };
+
+  /**
+   * @brief Split a single large input into tokens across a pool of threads.
+   * @details The input is cut into chunks of `chunk_size` characters, wherever that falls. Every
+   * chunk is lexed speculatively, as if a token started right at its start, or right after the
+   * first character of `sync` in it if that set is not empty, until a token ends at or past its
+   * end, reading on into the next chunk if needed. The chunks are then stitched
+   * in order: where the tokens of the previous chunk really end, the speculative tokens of the
+   * next chunk are kept from the first one starting at that offset. Until they line up, tokens
+   * are lexed again from the real end, so only the misaligned prefix of a chunk is lexed twice.
+   * Since a lexer only looks ahead, the tokens are the same as those of lexing the input in one
+   * go, as long as the Maps of the rules are free of side effects. Most tokenizations line up
+   * again within a few tokens. Paired delimiters, such as quotes around text that can hold any
+   * token, can keep a chunk off by one delimiter to its end, so that all of it is lexed again;
+   * a `sync` set of characters they never enclose, such as newlines, avoids that.
+   * ~~~.cpp
+   * Tok::mapped_file trace("modem.trace");
+   * const auto lexed = Tok::parallel_lex(lex, trace.view(), {1 << 22, 0, Tok::char_class::newline});
+   * ~~~
+   * @tparam Lexer A lexer created by `Tok::lexer`.
+   * @param[in] lexer The lexer. It is shared by all workers.
+   * @param[in] input The input to be lexed.
+   * @param[in] options Settings of the lexing.
+   * @returns The tokens and the input that could not be lexed, as with sequential lexing.
+   */
+  template<typename Lexer>
+    lex_result parallel_lex(const Lexer& lexer, Input input, const lex_options& options = {})
+    {
+      const auto size = options.chunk_size ? options.chunk_size : 1;
+      const auto chunks = input.empty() ? 0 : (input.size() - 1) / size + 1;
+      std::vector<impl::speculation> guesses(chunks);
+      impl::for_each_chunk(chunks, options.threads, [&](std::size_t i) {
+          auto& guess = guesses[i];
+          const auto end = std::min(input.size(), (i + 1) * size);
+          guess.stop = i * size;
+          if (i > 0 && !(options.sync == char_set{}))
+            while (guess.stop < end && !options.sync.contains(input[guess.stop++]));
+          while (guess.stop < end)
+            if (!impl::lex_one(lexer, input, guess.stop, guess.tokens)) {
+              guess.failed = true;
+              break;
+            }
+        });
+
+      lex_result result;
+      std::vector<std::vector<token_record>> heads(chunks);
+      std::vector<std::size_t> kept(chunks);
+      std::size_t offset = 0;
+      bool failed = false;
+      for (std::size_t i = 0; i < chunks; i++) {
+        auto& guess = guesses[i];
+        const auto end = std::max(std::min(input.size(), (i + 1) * size), guess.stop);
+        auto next = guess.tokens.begin();
+        kept[i] = guess.tokens.size();
+        while (!failed && offset < end) {
+          next = std::lower_bound(next, guess.tokens.end(), offset,
+              [](const token_record& token, std::size_t at) { return token.offset < at; });
+          if (next != guess.tokens.end() && next->offset == offset) {
+            kept[i] = static_cast<std::size_t>(next - guess.tokens.begin());
+            offset = guess.stop;
+            failed = guess.failed;
+            break;
+          }
+          if (guess.failed && guess.stop == offset) {
+            failed = true;
+            break;
+          }
+          const auto start = offset;
+          failed = !impl::lex_one(lexer, input, offset, heads[i]);
+          result.relexed += offset - start;
+        }
+      }
+
+      std::vector<std::size_t> starts(chunks + 1);
+      for (std::size_t i = 0; i < chunks; i++)
+        starts[i + 1] = starts[i] + heads[i].size() + guesses[i].tokens.size() - kept[i];
+      result.tokens.resize(starts[chunks]);
+      impl::for_each_chunk(chunks, options.threads, [&](std::size_t i) {
+          const auto out = std::copy(heads[i].begin(), heads[i].end(), result.tokens.begin() +
+              static_cast<std::ptrdiff_t>(starts[i]));
+          std::copy(guesses[i].tokens.begin() + static_cast<std::ptrdiff_t>(kept[i]), guesses[i].tokens.end(), out);
+        });
+      result.rest = input.substr(offset);
+      return result;
+    }
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include <functional>
+#include <iostream>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lextok.h"
+
+// Final result codes of a modem, at most one of which matches any input
+static Tok::branch_stats stats;
+static constexpr auto result_code = Tok::adaptive_alt(stats, Tok::str_token("ERROR"),
+    Tok::str_token("NO CARRIER") | Tok::str_token("BUSY"), Tok::str_token("OK"));
+
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  return result_code(input) && input == "\r\n";
+}
+static_assert(constexpr_match("BUSY\r\n"));
+static_assert(Tok::first_of(result_code).chars.contains('O') && !Tok::first_of(result_code).chars.contains('R'));
+static_assert(Tok::width_of(result_code).min == 2 && Tok::width_of(result_code).max == 10);
+
+// Compilers that cannot tell constant evaluation apart always try the listed order
+#if defined(LEXTOK_CONSTANT_EVALUATED)
+static constexpr bool reorders = true;
+#else
+static constexpr bool reorders = false;
+#endif
+
+// Apply the result codes to an input many times
+static bool match_repeatedly(Tok::Input text, std::size_t times)
+{
+  for (std::size_t i = 0; i < times; i++) {
+    auto input = text;
+    const auto token = result_code(input);
+    if (!token || *token != text)
+      return false;
+  }
+  return true;
+}
+
+static Tok::Input input[] = {
+  {"ERROR"},            // Listed order at first
+  {"OK"},               // The most frequent branch is tried first
+  {"NO CARRIER"},       // Older matches weigh less
+  {"RING"},             // No branch matches
+  {"ignored"},          // Shared by threads
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto token = result_code(input);
+    return token && *token == "ERROR" && input.empty() && stats.branch(0) == 0 && stats.branch(3) == 3;
+  },
+
+  [](Tok::Input& input) -> bool {
+    return match_repeatedly(input, 4096) && (!reorders || (stats.branch(0) == 3 && stats.hits(3) > stats.hits(0)));
+  },
+
+  [](Tok::Input& input) -> bool {
+    return match_repeatedly(input, 8192) && (!reorders || (stats.branch(0) == 1 && stats.hits(1) > stats.hits(3)));
+  },
+
+  [](Tok::Input& input) -> bool {
+    return !result_code(input) && input == "RING";
+  },
+
+  [](Tok::Input&) -> bool {
+    stats.reset();
+    std::atomic<std::size_t> failures{0};
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < 4; t++)
+      workers.emplace_back([&failures, t] {
+        for (std::size_t i = 0; i < 20000; i++) {
+          Tok::Input text = i % 10 ? "BUSY" : (t % 2 ? "OK" : "ERROR");
+          const auto token = result_code(text);
+          failures += !token || !text.empty();
+        }
+      });
+    for (auto& worker : workers)
+      worker.join();
+    return failures == 0 && (!reorders || stats.branch(0) == 2);
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
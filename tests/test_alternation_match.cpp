@@ -0,0 +1,119 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+// FIRST sets are computed at compile time
+static constexpr auto result_code = Tok::str_token("OK") | Tok::str_token("ERROR") | Tok::str_token("+CME ERROR");
+static_assert(Tok::first_of(result_code).chars == Tok::char_set("OE+"));
+static_assert(!Tok::first_of(result_code).nullable);
+static_assert(Tok::first_of(Tok::maybe(Tok::digit()) & Tok::char_token('x')).chars == Tok::char_set("0123456789x"));
+static_assert(Tok::first_of(Tok::many(Tok::digit())).nullable);
+static_assert(!Tok::first_of(Tok::at_least_one(Tok::digit())).nullable);
+static_assert(Tok::first_of(Tok::exactly(Tok::digit(), 0)).chars.empty());
+static_assert(Tok::first_of(Tok::str_token("")).nullable);
+
+// Match one of this whole vocabulary
+static const char* const vocabulary[] = {
+  "OK", "CONNECT", "RING", "NO CARRIER", "ERROR", "NO DIALTONE", "BUSY", "NO ANSWER",
+  "+CME ERROR:", "+CMS ERROR:", "+CREG:", "+CGREG:", "+CEREG:", "+CMTI:", "+CMT:", "+CDS:",
+  "+CBM:", "+CLIP:", "+CRING:", "+CUSD:", "+CCWA:", "+CSSI:", "+CSSU:", "+CIEV:",
+  "^SYSSTART", "^SHUTDOWN", "^SIS:", "^SISW:", "^SISR:", "^SMSO", "RDY", "POWERED DOWN",
+  "+QIND:", "+QIURC:", "+QSTATE:", "+QPING:", "+QNTP:", "+QHTTPGET:", "+QMTRECV:", "+QMTSTAT:"
+};
+
+static Tok::Input input[] = {
+  {},                           // Empty input
+  {"ERROR"},                    // Match a later branch
+  {"OKAY"},                     // First branch wins
+  {"DONE"},                     // No branch can start with 'D'
+  {"+CME ERROR: 10"},           // Shared first character
+  {"42C"},                      // Nullable branch
+  {"z"},                        // Opaque branch
+  {"+QMTSTAT: 0,1"}             // Large alternation
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto token = result_code(input);
+    const auto nullable_token = (result_code | Tok::maybe(Tok::digit()))(input);
+    return !token && nullable_token && (*nullable_token).empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = result_code(input);
+    return token && *token == "ERROR" && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = (Tok::str_token("OK") | Tok::str_token("OKAY"))(input);
+    return token && *token == "OK" && input == "AY";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t calls = 0;
+    const auto token = (result_code | Tok::str_token("DONX", [&calls](Tok::Token_view) { calls++; }))(input);
+    return !token && calls == 0 && input == "DONE";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = (Tok::str_token("+CMS ERROR") | result_code)(input);
+    return token && *token == "+CME ERROR" && input == ": 10";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = ((Tok::char_token('x') | (Tok::many(Tok::digit()) & Tok::char_token('C'))) &
+        Tok::str_token(""))(input);
+    return token && *token == "42C";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto opaque = [](Tok::Input& input) -> Tok::Token {
+      if (input.empty() || input[0] != 'z')
+        return {};
+      const auto token = input.substr(0, 1);
+      input.remove_prefix(1);
+      return {token};
+    };
+    const auto token = (Tok::char_token('a') | opaque)(input);
+    return token && *token == "z";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t matched = sizeof(vocabulary) / sizeof(vocabulary[0]);
+    auto branch = [&matched](std::size_t i) {
+      return Tok::str_token(vocabulary[i], [&matched, i](Tok::Token_view) { matched = i; });
+    };
+    const auto urc = branch(0) | branch(1) | branch(2) | branch(3) | branch(4) | branch(5) | branch(6) |
+      branch(7) | branch(8) | branch(9) | branch(10) | branch(11) | branch(12) | branch(13) |
+      branch(14) | branch(15) | branch(16) | branch(17) | branch(18) | branch(19) | branch(20) |
+      branch(21) | branch(22) | branch(23) | branch(24) | branch(25) | branch(26) | branch(27) |
+      branch(28) | branch(29) | branch(30) | branch(31) | branch(32) | branch(33) | branch(34) |
+      branch(35) | branch(36) | branch(37) | branch(38) | branch(39);
+    // Every word must be recognized as itself
+    for (std::size_t i = 0; i < sizeof(vocabulary) / sizeof(vocabulary[0]); i++) {
+      Tok::Input word(vocabulary[i]);
+      if (!urc(word) || matched != i || !word.empty())
+        return false;
+    }
+    const auto token = urc(input);
+    return token && *token == "+QMTSTAT:" && matched == 39;
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
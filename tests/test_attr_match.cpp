@@ -0,0 +1,100 @@
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "lextok.h"
+
+struct csq_reading {
+  int rssi;
+  int ber;
+};
+
+// A whole parse can happen at compile time and yield a plain struct
+static constexpr auto csq = Tok::attr::as<csq_reading>(Tok::str_token("+CSQ: ") & Tok::attr::integer<int>() &
+    Tok::char_token(',') & Tok::attr::integer<int>());
+static constexpr int constexpr_rssi(Tok::Input input)
+{
+  const auto reading = csq.parse(input);
+  return reading ? reading->rssi * 100 + reading->ber : 0;
+}
+static_assert(constexpr_rssi("+CSQ: 21,99") == 2199);
+static_assert(constexpr_rssi("+CSQ: 21;99") == 0);
+
+static Tok::Input input[] = {
+  {"+CSQ: 21,99"},        // Attributes of a sequence
+  {"+CSQ: 21;99"},        // A mismatch leaves the input untouched
+  {"0x1f"},               // Alternations yield the attribute of the matching branch
+  {"7,-3.5"},             // Optional attributes
+  {"1,2,3;"},             // Repetitions write into an output iterator
+  {"rate=12"},            // Token views as attributes
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto pair = Tok::attr::integer<int>() & Tok::char_token(',') & Tok::attr::integer<long>();
+    auto digits = input.substr(6);
+    const std::optional<std::tuple<int, long>> values = pair.parse(digits);
+    const auto reading = csq.parse(input);
+    return values && std::get<0>(*values) == 21 && std::get<1>(*values) == 99 && digits.empty() &&
+      reading && reading->rssi == 21 && reading->ber == 99 && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto before = input;
+    return !csq.parse(input) && input == before;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto number = (Tok::str_token("0x") & Tok::attr::hex_integer<unsigned>()) | Tok::attr::integer<unsigned>();
+    Tok::Input decimal = "42";
+    const auto hex = number.parse(input);
+    const auto dec = number.parse(decimal);
+    return hex && *hex == 0x1f && dec && *dec == 42;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto pair = Tok::attr::integer<int>() & Tok::attr::maybe(Tok::char_token(',') & Tok::attr::decimal());
+    Tok::Input alone = "7;";
+    const auto both = pair.parse(input);
+    const auto first = pair.parse(alone);
+    return both && std::get<0>(*both) == 7 && std::get<1>(*both) == -3.5 &&
+      first && std::get<0>(*first) == 7 && !std::get<1>(*first) && alone == ";";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::vector<int> values;
+    const auto list = Tok::attr::integer<int>() &
+      Tok::attr::many(Tok::char_token(',') & Tok::attr::integer<int>(), std::back_inserter(values)) &
+      Tok::char_token(';');
+    const auto head = list.parse(input);
+    Tok::Input empty = "";
+    std::vector<int> none;
+    return head && *head == 1 && values == std::vector<int>{2, 3} && input.empty() &&
+      !Tok::attr::at_least_one(Tok::attr::integer<int>(), std::back_inserter(none)).parse(empty) && none.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto setting = Tok::attr::token(Tok::at_least_one(Tok::lower_alphabet())) & Tok::char_token('=') &
+      Tok::attr::integer<int>();
+    const auto parsed = setting.parse(input);
+    return parsed && std::get<0>(*parsed) == "rate" && std::get<1>(*parsed) == 12;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <cstring>
+#include <vector>
+
+#include "lextok_batch.h"
+
+// Lines of the form "+CGPADDR: <cid>,<ip>"
+static const auto response = Tok::str_token("+CGPADDR: ") & Tok::at_least_one(Tok::digit()) &
+  Tok::char_token(',') & Tok::at_least_one(Tok::digit() | Tok::char_token('.'));
+
+// Count the records that match as a whole
+static const auto count_matches = [](std::size_t& count, Tok::Input record, Tok::Token token) {
+  count += token && (*token).size() == record.size();
+};
+
+static std::string make_log(std::size_t lines)
+{
+  std::string log;
+  for (std::size_t i = 0; i < lines; i++)
+    log += i % 3 ? "+CGPADDR: " + std::to_string(i % 7) + ",10.0.0." + std::to_string(i % 256) + "\n" : "OK\n";
+  return log;
+}
+
+static Tok::Input input[] = {
+  {},                   // Empty input
+  {"a\nbb\nccc"},       // Chunks end after a delimiter
+  {"ignored"},          // Many chunks, many threads
+  {"ignored"},          // Order of the results
+  {"ignored"}           // Memory-mapped file
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto results = Tok::batch_tokenize<std::size_t>(input, response, count_matches);
+    return results.empty() && Tok::split_chunks(input, '\n', 4).empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto chunks = Tok::split_chunks(input, '\n', 3);
+    return chunks.size() == 2 && chunks[0] == "a\nbb\n" && chunks[1] == "ccc" &&
+      Tok::split_chunks(input, '\n', 100).size() == 1;
+  },
+
+  [](Tok::Input&) -> bool {
+    const auto log = make_log(10000);
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < 10000; i++)
+      expected += i % 3 != 0;
+    const auto results = Tok::batch_tokenize<std::size_t>(log, response, count_matches, {'\n', 512, 4});
+    std::size_t total = 0;
+    for (const auto count : results)
+      total += count;
+    return results.size() > 4 && total == expected;
+  },
+
+  [](Tok::Input&) -> bool {
+    const auto log = make_log(2000);
+    const auto collect = [](std::vector<std::string>& records, Tok::Input record, Tok::Token) {
+      records.emplace_back(record);
+    };
+    const auto results = Tok::batch_tokenize<std::vector<std::string>>(log, response, collect, {'\n', 256, 8});
+    std::string merged;
+    for (const auto& chunk : results)
+      for (const auto& record : chunk)
+        merged += record + "\n";
+    return merged == log;
+  },
+
+  [](Tok::Input&) -> bool {
+    char path[] = "/tmp/lextok_batch_XXXXXX";
+    const int fd = ::mkstemp(path);
+    if (fd < 0)
+      return false;
+    const auto log = make_log(3000);
+    const bool written = ::write(fd, log.data(), log.size()) == static_cast<ssize_t>(log.size());
+    ::close(fd);
+    Tok::mapped_file file(path);
+    const bool mapped = file.is_open() && file.view() == log;
+    const auto results = Tok::batch_tokenize<std::size_t>(file.view(), response, count_matches, {'\n', 1024, 3});
+    std::size_t total = 0;
+    for (const auto count : results)
+      total += count;
+    ::unlink(path);
+    return written && mapped && total == 2000 && !Tok::mapped_file("/nonexistent/lextok").is_open();
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+// Sets are built and composed at compile time
+static_assert(Tok::char_set("abc").contains('b'));
+static_assert(!Tok::char_set("abc").contains('d'));
+static_assert(Tok::char_set("abca").count() == 3);
+static_assert(Tok::char_set().empty());
+static_assert(Tok::char_set::all().count() == 256);
+static_assert(Tok::char_class::alphabet == (Tok::char_class::lower_alphabet | Tok::char_class::upper_alphabet));
+static_assert((Tok::char_class::hex_digit & Tok::char_class::alphabet) == Tok::char_set("abcdefABCDEF"));
+static_assert((Tok::char_class::hex_digit - Tok::char_class::digit).count() == 12);
+static_assert((~Tok::char_class::digit).count() == 246);
+static_assert(Tok::char_set::range('z', 'a').empty());
+static_assert(Tok::char_set::of('\xff').contains('\xff'));
+
+static Tok::Input input[] = {
+  {},                           // Empty input
+  {"\"quoted\""},               // Match any of a group
+  {"b"},                        // Mismatch any of a group
+  {"field,next"},               // Match none of a group
+  {"\r\n"},                     // Mismatch none of a group
+  {"x9F_"},                     // Composed sets
+  {"hello world"},              // Complemented set
+  {"\xe2\x82\xac"}              // High bytes
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::none_of("\"")(input);
+    return !token ? true : false;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::any_of("'\"")(input);
+    return token && *token == "\"";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::any_of("aAB")(input);
+    return !token && input == "b";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::many(Tok::none_of(",\r\n"))(input);
+    return token && *token == "field" && input == ",next";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::none_of(",\r\n")(input);
+    return !token ? true : false;
+  },
+
+  [](Tok::Input& input) -> bool {
+    constexpr auto identifier = Tok::char_class::alphabet | Tok::char_class::digit | Tok::char_set("_");
+    std::size_t sz = 0;
+    const auto token = Tok::many(Tok::any_of(identifier, [&sz](Tok::Token_view){ sz++; }))(input);
+    return token && *token == "x9F_" && sz == 4;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::at_least_one(Tok::none_of(Tok::char_class::whitespace))(input);
+    return token && *token == "hello";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::many(Tok::any_of(Tok::char_set::range('\x80', '\xff')))(input);
+    return token && (*token).size() == 3;
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
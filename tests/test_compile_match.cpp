@@ -0,0 +1,119 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+static constexpr auto number_tokenizer = Tok::at_least_one(Tok::digit()) &
+  Tok::maybe(Tok::char_token('.') & Tok::at_least_one(Tok::digit()));
+
+// The table is built at compile time
+static constexpr auto number = Tok::compile(number_tokenizer);
+static_assert(number.is_valid());
+static_assert(number.states() == 5);  // Dead, start, integer part, dot, fraction
+static_assert(Tok::first_of(number).chars == Tok::char_class::digit && !Tok::first_of(number).nullable);
+
+static constexpr std::size_t constexpr_match(Tok::Input input)
+{
+  const auto token = number(input);
+  return token ? (*token).size() : 0;
+}
+static_assert(constexpr_match("3.14 rad") == 4);
+static_assert(constexpr_match("42.") == 2);
+static_assert(constexpr_match(".5") == 0);
+
+// Equivalent states are merged
+static constexpr auto redundant = Tok::compile(Tok::at_least_one(Tok::str_token("ab")) |
+    (Tok::str_token("ab") & Tok::many(Tok::str_token("ab"))));
+static_assert(redundant.states() == 4);
+
+// Only regular tokenizers can be compiled
+static_assert(Tok::impl::is_regular<std::decay_t<decltype(number_tokenizer)>>::value);
+static const auto mapped_digit = Tok::digit([](Tok::Token_view) {});
+static_assert(!Tok::impl::is_regular<std::decay_t<decltype(mapped_digit)>>::value);
+
+static const auto identifier = (Tok::alphabet() | Tok::char_token('_')) &
+  Tok::many(Tok::alphabet() | Tok::digit() | Tok::char_token('_'));
+
+static Tok::Input input[] = {
+  {"if"},                   // Longest keyword wins over the first branch
+  {"123 456"},              // A repetition followed by an overlapping class
+  {"hello_world2 = 1"},     // Same tokens as the original tokenizer
+  {"2024-10-14T12:00"},     // Bounded repetitions
+  {"AT+CGPADDR=1"},         // Resumable matching
+  {"aaaa"}                  // Capacity exceeded at run time
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto compiled = Tok::compile(Tok::str_token("i") | Tok::str_token("if"));
+    auto rest = input;
+    const auto token = compiled(rest);
+    return token && *token == "if" && rest.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    // Fails as a combinator, since the greedy repetition leaves no digit for the rest
+    const auto tokenizer = Tok::many(Tok::digit()) & Tok::digit();
+    auto copy = input;
+    const auto compiled = Tok::compile(tokenizer);
+    const auto token = compiled(input);
+    return !tokenizer(copy) && token && *token == "123" && input == " 456";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::string mapped;
+    const auto compiled = Tok::compile(identifier, [&mapped](Tok::Token_view token) { mapped = token; });
+    auto copy = input;
+    const auto expected = identifier(copy);
+    const auto token = compiled(input);
+    return token && expected && *token == *expected && input == copy && mapped == "hello_world2";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto date = Tok::compile(Tok::exactly(Tok::digit(), 4) & Tok::char_token('-') &
+        Tok::exactly(Tok::digit(), 2) & Tok::char_token('-') & Tok::exactly(Tok::digit(), 2));
+    Tok::Input short_date = "2024-10-1";
+    const auto token = date(input);
+    return token && *token == "2024-10-14" && input == "T12:00" && !date(short_date);
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto command = Tok::compile(Tok::str_token("AT+") &
+        Tok::keyword_set({"CGPADDR", "CGDCONT", "CGACT"}) & Tok::char_token('=') & Tok::at_least_one(Tok::digit()));
+    auto matcher = Tok::resumable(command);
+    Tok::Token token;
+    std::size_t calls = 0;
+    auto status = Tok::match_status::incomplete;
+    for (std::size_t size = 1; size <= input.size() && status == Tok::match_status::incomplete; size++, calls++) {
+      Tok::Input received = input.substr(0, size);
+      status = matcher(received, token);
+    }
+    Tok::Input complete = input;
+    status = matcher(complete, token, true);
+    return calls == input.size() && status == Tok::match_status::matched && token && *token == input;
+  },
+
+  [](Tok::Input& input) -> bool {
+    // Five positions do not fit in four
+    const auto compiled = Tok::compile<4>(Tok::exactly(Tok::char_token('a'), 5));
+    auto copy = input;
+    return !compiled.is_valid() && !compiled(copy) && copy == input;
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
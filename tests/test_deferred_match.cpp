@@ -0,0 +1,102 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <vector>
+
+#include "lextok.h"
+
+static Tok::map_record records[16];
+static Tok::map_log log_buffer(records);
+
+static Tok::memo_entry arena[64];
+static Tok::memo_cache cache(arena);
+
+static std::vector<std::string> calls;
+
+static const auto record_call = [](Tok::Token_view token) { calls.emplace_back(token); };
+static const auto number = Tok::at_least_one(Tok::digit(), Tok::defer(record_call));
+static const auto word = Tok::at_least_one(Tok::alphabet(), Tok::defer(record_call));
+
+static Tok::Input input[] = {
+  {"12;"},          // Maps run once the whole tokenizer succeeded
+  {"12,"},          // No Map runs if it fails
+  {"12abc"},        // Only the Maps of the branch that succeeded run
+  {"1 2 3 x"},      // Instances of a failed repetition are dropped
+  {"7"},            // Outside of a transaction Maps run right away
+  {"12"},           // Overflow of the log
+  {"12b"}           // A memoized match recalled after a backtrack records its Maps again
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    calls.clear();
+    std::size_t during = 0;
+    const auto probe = Tok::map(Tok::char_token(';'), [&during](Tok::Token_view) { during = calls.size(); });
+    const auto reading = Tok::transaction(number & probe, log_buffer);
+    const auto token = reading(input);
+    return token && during == 0 && calls.size() == 1 && calls[0] == "12" && log_buffer.size() == 0;
+  },
+
+  [](Tok::Input& input) -> bool {
+    calls.clear();
+    const auto reading = Tok::transaction(number & Tok::char_token(';'), log_buffer);
+    return !reading(input) && calls.empty() && log_buffer.size() == 0 && input == "12,";
+  },
+
+  [](Tok::Input& input) -> bool {
+    calls.clear();
+    const auto reading = Tok::transaction((number & Tok::char_token(';')) | (number & word), log_buffer);
+    const auto token = reading(input);
+    return token && calls.size() == 2 && calls[0] == "12" && calls[1] == "abc";
+  },
+
+  [](Tok::Input& input) -> bool {
+    calls.clear();
+    const auto spaced = Tok::exactly(number & Tok::char_token(' '), 4);
+    const auto reading = Tok::transaction(spaced | Tok::many(number & Tok::char_token(' ')), log_buffer);
+    const auto token = reading(input);
+    return token && *token == "1 2 3 " && calls.size() == 3 && calls[2] == "3";
+  },
+
+  [](Tok::Input& input) -> bool {
+    calls.clear();
+    const auto token = (number & Tok::char_token(';'))(input);
+    return !token && calls.size() == 1 && calls[0] == "7";
+  },
+
+  [](Tok::Input& input) -> bool {
+    calls.clear();
+    Tok::map_record one[1];
+    Tok::map_log tiny(one);
+    const auto digits = Tok::many(Tok::digit(Tok::defer(record_call)));
+    const auto token = Tok::transaction(digits, tiny)(input);
+    const bool overflowed = tiny.overflowed();
+    tiny.clear();
+    return token && overflowed && calls.size() == 1 && !tiny.overflowed();
+  },
+
+  [](Tok::Input& input) -> bool {
+    calls.clear();
+    cache.clear();
+    const auto shared = Tok::memo(number, cache);
+    const auto reading = Tok::transaction((shared & Tok::char_token('a')) | (shared & Tok::char_token('b')), log_buffer);
+    const auto token = reading(input);
+    return token && *token == "12b" && calls.size() == 1 && calls[0] == "12";
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,85 @@
+#define LEXTOK_TRACK_FAILURES
+
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Diagnosed tokenizers still run at compile time, without recording
+static Tok::failure constexpr_failure;
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  return Tok::diagnose(constexpr_failure, Tok::str_token("AT") & Tok::char_token('+'))(input).has_value();
+}
+static_assert(constexpr_match("AT+CSQ") && !constexpr_match("ATD"));
+
+static constexpr auto number = Tok::at_least_one(Tok::digit());
+
+static Tok::Input input[] = {
+  {"+CSQ: 21,x"},                 // The part of a sequence that failed
+  {"+CME ERROR: x"},              // The furthest failure wins over the alternation that rewound
+  {"+CSQ: ,5"},                   // Named tokenizers
+  {"+CSQ: 21,99"},                // A match resets the failure
+  {"ERROR"},                      // Alternations join the expectations of their branches
+  {"+CSQ: 21 , x"},               // Diagnosing does not change what a skipping grammar matches
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    Tok::failure error;
+    const auto reply = Tok::diagnose(error, Tok::str_token("+CSQ: ") & number & Tok::char_token(',') & number);
+    const auto original = input;
+    return !reply(input) && input == original && error.failed && error.offset == 9 &&
+      error.expected.contains('7') && !error.expected.contains(',') && error.name == nullptr &&
+      constexpr_failure.failed == false;
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::failure error;
+    const auto reply = Tok::diagnose(error, (Tok::str_token("+CME ERROR: ") & number) | Tok::str_token("OK"));
+    return !reply(input) && error.offset == 12 && error.expected.contains('0') && !error.expected.contains('O');
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::failure error;
+    const auto reply = Tok::diagnose(error, Tok::str_token("+CSQ: ") & Tok::named("rssi", number) &
+        Tok::char_token(',') & Tok::named("ber", number));
+    return !reply(input) && error.offset == 6 && error.name && std::string(error.name) == "rssi";
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::failure error;
+    const auto reply = Tok::diagnose(error, Tok::str_token("+CSQ: ") & number & Tok::char_token(',') & number);
+    Tok::Input wrong = "+CSQ: x";
+    return !reply(wrong) && error.failed && reply(input) && !error.failed && error.offset == 0;
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::failure error;
+    const auto reply = Tok::diagnose(error, Tok::str_token("OK") | Tok::str_token("+CME ERROR: "));
+    return !reply(input) && error.offset == 0 && error.expected.contains('O') && error.expected.contains('+') &&
+      !error.expected.contains('E');
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::failure error;
+    const auto reply = Tok::skip(Tok::whitespace(), Tok::diagnose(error, Tok::str_token("+CSQ:") &
+        Tok::named("rssi", number) & Tok::char_token(',') & Tok::named("ber", number)));
+    return !reply(input) && error.offset == 11 && error.name && std::string(error.name) == "ber";
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Case is folded at compile time too
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  return Tok::istr_token("AT+CSQ")(input) && input.empty();
+}
+static_assert(constexpr_match("at+csq") && constexpr_match("At+cSq") && !constexpr_match("AT+CSR"));
+
+// Literals longer than a word, followed by more input
+static constexpr bool constexpr_prefix(Tok::Input input)
+{
+  return Tok::istr_token("AT+CGPADDR=")(input) && input == "1\r\n";
+}
+static_assert(constexpr_prefix("at+cgpaddr=1\r\n") && !constexpr_prefix("at+cgpaddq=1\r\n"));
+static_assert(Tok::istr_token("ok").first().chars.contains('O') && Tok::istr_token("ok").first().chars.contains('o'));
+
+static Tok::Input input[] = {
+  {"at+cgpaddr=1\r\n"},           // The token keeps the spelling of the input
+  {"@T+CSQ`[{"},                  // Only letters fold: '@' is not '`' and '[' is not '{'
+  {"Ok\r\n"},                     // Case-insensitive keyword sets
+  {"+cme error: 10"},             // Longest keyword, in any case
+  {"AT+CG"},                      // Resumable matching across chunks
+  {"at+csq\r\n"},                 // Case-insensitive literals compile to a DFA
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    std::string command;
+    const auto token = Tok::istr_token("AT+CGPADDR=", [&command](Tok::Token_view token) {
+        command = std::string(token);
+      })(input);
+    return token && *token == "at+cgpaddr=" && command == "at+cgpaddr=" && input == "1\r\n";
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::Input at = input;
+    Tok::Input brackets = input.substr(6);
+    return !Tok::istr_token("`T+CSQ")(at) && Tok::istr_token("@t+csq")(input) &&
+      !Tok::istr_token("{[")(brackets) && Tok::istr_token("`[{")(input);
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t index = 99;
+    const auto result = Tok::ikeyword_set({"ERROR", "OK", "ok"}, [&index](std::size_t i, Tok::Token_view) {
+        index = i;
+      });
+    return result(input) && index == 1 && input == "\r\n" && !Tok::keyword_set({"OK"})(input);
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::ikeyword_set({"+CME", "+CME ERROR: ", "+CMS ERROR: "})(input);
+    return token && *token == "+cme error: " && input == "10";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto command = Tok::istr_token("at+cgpaddr");
+    decltype(command)::state progress;
+    std::size_t size = 0;
+    return command.resume(input, size, progress, false) == Tok::match_status::incomplete &&
+      command.resume("AT+CGPADDR", size, progress, false) == Tok::match_status::matched && size == 10 &&
+      command.resume("AT+CX", size, progress, false) == Tok::match_status::mismatched;
+  },
+
+  [](Tok::Input& input) -> bool {
+    constexpr auto command = Tok::compile(Tok::istr_token("AT+") & Tok::ikeyword_set({"CSQ", "CREG"}));
+    const auto token = command(input);
+    return token && *token == "at+csq" && input == "\r\n";
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
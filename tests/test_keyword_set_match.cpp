@@ -0,0 +1,97 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+// Keyword sets can be built and applied at compile time
+static constexpr auto commands = Tok::keyword_set({"AT+CGPADDR", "AT+CSQ", "AT", "AT+CGATT", "AT+CG"});
+static_assert(Tok::first_of(commands).chars == Tok::char_set("A"));
+
+static constexpr std::size_t constexpr_match(Tok::Input input)
+{
+  const auto token = commands(input);
+  return token ? (*token).size() : 0;
+}
+static_assert(constexpr_match("AT+CSQ?") == 6);
+static_assert(constexpr_match("AT+CGATT=1") == 8);
+static_assert(constexpr_match("AT+CGX") == 5);
+static_assert(constexpr_match("AT+") == 2);
+static_assert(constexpr_match("BT") == 0);
+
+static Tok::Input input[] = {
+  {},                           // Empty input
+  {"AT+CGPADDR=1"},             // Longest keyword wins
+  {"AT+CSQ"},                   // Keyword at the end of the input
+  {"AT+C"},                     // Fall back to a shorter keyword
+  {"at+csq"},                   // Mismatch
+  {"+CME ERROR: 3"},            // Index reported to the map
+  {"\xff\x01"},                 // High bytes
+  {"ERRORS"}                    // Duplicate keywords
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto token = commands(input);
+    const auto nullable = Tok::keyword_set({"", "A"})(input);
+    return !token && nullable && (*nullable).empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = commands(input);
+    return token && *token == "AT+CGPADDR" && input == "=1";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = commands(input);
+    return token && *token == "AT+CSQ" && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = commands(input);
+    return token && *token == "AT" && input == "+C";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = commands(input);
+    return !token && input == "at+csq";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t matched = 0;
+    const auto result_code = Tok::keyword_set({"OK", "ERROR", "+CME ERROR", "+CMS ERROR"},
+        [&matched](std::size_t index, Tok::Token_view) { matched = index; });
+    const auto token = (result_code & Tok::str_token(": ") & Tok::at_least_one(Tok::digit()))(input);
+    return token && matched == 2;
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t matched = 0;
+    const auto token = Tok::keyword_set({"\x01", "\xff", "\xff\x01", "\x7f"},
+        [&matched](std::size_t index, Tok::Token_view) { matched = index; })(input);
+    return token && *token == "\xff\x01" && matched == 2;
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t matched = 0;
+    const auto token = Tok::keyword_set({"ERROR", "OK", "ERROR"},
+        [&matched](std::size_t index, Tok::Token_view) { matched = index; })(input);
+    return token && *token == "ERROR" && matched == 0 && input == "S";
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <vector>
+
+#include "lextok.h"
+
+enum class kind { keyword, identifier, number, op, blank };
+
+static const auto lex = Tok::lexer(
+    std::pair{kind::keyword, Tok::str_token("if") | Tok::str_token("else")},
+    std::pair{kind::identifier, Tok::at_least_one(Tok::alphabet())},
+    std::pair{kind::number, Tok::at_least_one(Tok::digit())},
+    std::pair{kind::op, Tok::str_token("==") | Tok::str_token("=") | Tok::char_token('<')},
+    std::pair{kind::blank, Tok::at_least_one(Tok::whitespace())});
+
+static std::vector<Tok::token_record> lex_all(Tok::Input& input)
+{
+  std::vector<Tok::token_record> records;
+  input = lex(input, [&records](Tok::token_record record) { records.push_back(record); });
+  return records;
+}
+
+static bool is(const Tok::token_record& record, kind id, std::size_t offset, std::size_t length)
+{
+  return record.id == static_cast<std::size_t>(id) && record.offset == offset && record.length == length;
+}
+
+// Lexers can run at compile time
+static constexpr std::size_t constexpr_count()
+{
+  constexpr auto words = Tok::lexer(std::pair{0, Tok::at_least_one(Tok::alphabet())},
+      std::pair{1, Tok::at_least_one(Tok::whitespace())});
+  std::size_t n = 0;
+  words("ab cd  ef", [&n](Tok::token_record record) { n += record.id == 0; });
+  return n;
+}
+static_assert(constexpr_count() == 3);
+
+static Tok::Input input[] = {
+  {"if"},               // Ties go to the rule listed first
+  {"iffy"},             // The longest match wins over the priority
+  {"a==b"},             // Longest operator
+  {"if x < 10 else"},   // A full statement
+  {"x = 1 ?"},          // Stop at the first position no rule matches
+  {}                    // Empty input
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto records = lex_all(input);
+    return input.empty() && records.size() == 1 && is(records[0], kind::keyword, 0, 2);
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto records = lex_all(input);
+    return input.empty() && records.size() == 1 && is(records[0], kind::identifier, 0, 4);
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto records = lex_all(input);
+    return input.empty() && records.size() == 3 && is(records[0], kind::identifier, 0, 1) &&
+      is(records[1], kind::op, 1, 2) && is(records[2], kind::identifier, 3, 1);
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto records = lex_all(input);
+    const kind expected[] = {kind::keyword, kind::blank, kind::identifier, kind::blank, kind::op,
+      kind::blank, kind::number, kind::blank, kind::keyword};
+    if (!input.empty() || records.size() != std::size(expected))
+      return false;
+    for (std::size_t i = 0; i < records.size(); i++)
+      if (records[i].id != static_cast<std::size_t>(expected[i]))
+        return false;
+    return is(records[6], kind::number, 7, 2);
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto records = lex_all(input);
+    std::size_t id = 0;
+    Tok::Input rest = input;
+    return records.size() == 6 && input == "?" && !lex.match(rest, id) && rest == "?";
+  },
+
+  [](Tok::Input& input) -> bool {
+    return lex_all(input).empty() && input.empty();
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+static bool at(Tok::source_position position, std::size_t line, std::size_t column)
+{
+  return position.line == line && position.column == column;
+}
+
+// Lines long enough for the vectorized scan
+static std::string make_text(std::size_t lines, std::size_t width)
+{
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++)
+    text += std::string(width, 'x') + (i % 3 == 0 ? "\n" : i % 3 == 1 ? "\r\n" : "\r");
+  return text;
+}
+
+static Tok::Input input[] = {
+  {"a\nbc\r\nd\re"},  // LF, CRLF and CR end a line once
+  {"ignored"},        // Only scanned as far as asked
+  {"ignored"},        // Arena too small for every line
+  {"OK\r\n+CGPADDR: 1,10.0.0.1\r\nERROR"},  // Positions of tokens
+  {""},               // Empty input
+  {"OK\r\n+CSQ: 20,99\r\n"},  // Positions of tokens matched in chunks
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    std::size_t arena[16];
+    Tok::line_index index(input, arena);
+    return at(index.position(8), 4, 1) && at(index.position(0), 1, 1) && at(index.position(1), 1, 2) &&
+      at(index.position(3), 2, 2) && at(index.position(4), 2, 3) && at(index.position(5), 2, 4) &&
+      at(index.position(6), 3, 1) && at(index.position(100), 4, 2) && index.size() == 4;
+  },
+
+  [](Tok::Input&) -> bool {
+    const auto text = make_text(1000, 70);
+    std::size_t arena[2048];
+    Tok::line_index index(text, arena);
+    if (index.size() != 0 || !at(index.position(71 + 72 + 71 + 5), 4, 6) || index.size() > 6)
+      return false;
+    const auto last = index.position(text.size() - 1);
+    return at(last, 1000, 71) && index.size() == 1001 && at(index.position(71 + 71), 2, 72);
+  },
+
+  [](Tok::Input&) -> bool {
+    const auto text = make_text(100, 40);
+    std::size_t arena[4];
+    Tok::line_index index(text, arena);
+    return at(index.position((41 + 42 + 41) * 25 + 3), 76, 4) && at(index.position(41), 2, 1) && index.size() == 4 &&
+      at(index.position(text.size()), 101, 1);
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t arena[8];
+    Tok::line_index index(input, arena);
+    auto rest = input;
+    const auto address = Tok::search(Tok::str_token("10.") & Tok::many(Tok::digit() | Tok::char_token('.')), rest);
+    auto error = input;
+    const auto end = Tok::search(Tok::str_token("ERROR"), error);
+    return address && end && at(index.position(*address), 2, 13) && at(index.position(*end), 3, 1);
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t arena[1];
+    Tok::line_index index(input, arena);
+    return at(index.position(0), 1, 1) && at(index.position(5), 1, 1) && index.size() == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t arena[4];
+    Tok::line_index index(input, arena);
+    std::size_t offset = input.size();
+    auto matcher = Tok::resumable(Tok::str_token("\r\n") & Tok::str_token("+CSQ: ", [&](Tok::Token_view token) {
+        offset = static_cast<std::size_t>(token.data() - input.data());
+      }));
+    Tok::Token token;
+    Tok::Input first = input.substr(2, 6);
+    Tok::Input second = input.substr(2, 12);
+    return matcher(first, token) == Tok::match_status::incomplete &&
+      matcher(second, token) == Tok::match_status::matched && at(index.position(offset), 2, 1);
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+static Tok::memo_entry arena[256];
+static Tok::memo_cache cache(arena);
+
+static std::size_t header_calls = 0;
+
+static const auto header = Tok::str_token("HDR:") & Tok::at_least_one(Tok::digit(), [](Tok::Token_view) {
+    header_calls++;
+  });
+
+// Each level tries the level below in two branches
+template<std::size_t Level>
+  static auto nested()
+  {
+    if constexpr (Level == 0) {
+      return Tok::memo(Tok::char_token('x'), cache);
+    } else {
+      const auto inner = nested<Level - 1>();
+      return Tok::memo((inner & Tok::char_token('a')) | (inner & Tok::char_token('b')), cache);
+    }
+  }
+
+static Tok::Input input[] = {
+  {"HDR:123,b"},      // Shared prefix is matched once
+  {"HDR:1"},          // Same outcome as without memoization
+  {"xbbbbbbbb"},  // Nested alternatives stay linear
+  {"HDR:1,a"},        // Clearing the cache
+  {"x"}               // Caches without slots
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    cache.clear();
+    header_calls = 0;
+    const auto shared = Tok::memo(header, cache);
+    const auto message = (shared & Tok::str_token(",a")) | (shared & Tok::str_token(",b")) |
+      (shared & Tok::str_token(",c"));
+    const auto token = message(input);
+    return token && *token == "HDR:123,b" && input.empty() && header_calls == 1 && cache.hits() == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    cache.clear();
+    const auto shared = Tok::memo(header & Tok::char_token(','), cache);
+    auto plain = input;
+    const bool expected = !(header & Tok::char_token(','))(plain);
+    const auto token = (shared | shared)(input);
+    // The failure is remembered too
+    return expected && !token && input == "HDR:1" && cache.hits() == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    cache.clear();
+    const auto rule = nested<8>();
+    const auto token = rule(input);
+    // Without memoization the leaf would be tried 2^8 times
+    return token && *token == "xbbbbbbbb" && input.empty() && cache.attempts() < 64;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto shared = Tok::memo(header, cache);
+    const auto message = (shared & Tok::str_token(",b")) | (shared & Tok::str_token(",a"));
+    cache.clear();
+    header_calls = 0;
+    auto first = input;
+    message(first);
+    cache.clear();
+    auto second = input;
+    message(second);
+    return first.empty() && second.empty() && header_calls == 2 && cache.hits() == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::memo_cache empty(arena, 0);
+    const auto token = Tok::memo(Tok::char_token('x'), empty)(input);
+    return token && input.empty() && empty.hits() == 0 && empty.attempts() == 0;
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+// Values can be parsed at compile time
+static constexpr int constexpr_parse(Tok::Input input)
+{
+  const auto value = Tok::integer<int>().parse(input);
+  return value ? *value : 0;
+}
+static_assert(constexpr_parse("-2147483648") == -2147483648);
+static_assert(constexpr_parse("2147483648") == 0);
+static_assert(Tok::first_of(Tok::integer<unsigned>()).chars == Tok::char_class::digit);
+
+static Tok::Input input[] = {
+  {"+CSQ: -113,99"},          // Signed values, written into variables
+  {"255 256"},                // Overflow does not match
+  {"0x1F2e"},                 // Hexadecimal digits
+  {"-12.5e-3 rad"},           // Decimal numbers
+  {"+CGPADDR: 128.14.178.01"},// Values passed to a Sink
+  {"1."}                      // Resumable matching
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    int rssi = 0;
+    long ber = 0;
+    const auto csq = Tok::str_token("+CSQ: ") & Tok::integer(rssi) & Tok::char_token(',') & Tok::integer(ber);
+    const auto token = csq(input);
+    return token && input.empty() && rssi == -113 && ber == 99;
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::uint8_t value = 7;
+    Tok::Input too_big = input.substr(4);
+    Tok::Input negative = "-1";
+    const auto fits = Tok::integer(value)(input);
+    const auto stored = value;
+    return fits && stored == 255 && !Tok::integer(value)(too_big) && too_big == "256" && value == 255 &&
+      !Tok::integer(value)(negative) && negative == "-1";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::uint16_t value = 0;
+    Tok::Input overflow = "12345";
+    const auto token = (Tok::str_token("0x") & Tok::hex_integer(value))(input);
+    return token && value == 0x1F2E && !Tok::hex_integer(value)(overflow);
+  },
+
+  [](Tok::Input& input) -> bool {
+    double value = 0;
+    Tok::Input exponent_without_digits = "3e+";
+    Tok::Input point_only = ".";
+    Tok::Input fraction_only = ".25";
+    const auto token = Tok::decimal(value)(input);
+    const auto parsed = value;
+    const bool partial = Tok::decimal(value)(exponent_without_digits) && value == 3 && exponent_without_digits == "e+";
+    const auto fraction = Tok::decimal().parse(fraction_only);
+    return token && *token == "-12.5e-3" && parsed == -12.5e-3 && partial && !Tok::decimal(value)(point_only) &&
+      fraction && *fraction == 0.25;
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::uint32_t address = 0;
+    const auto octet = Tok::integer<std::uint8_t>([&address](std::uint8_t value) { address = address << 8 | value; });
+    const auto ip = Tok::str_token("+CGPADDR: ") & octet & Tok::exactly(Tok::char_token('.') & octet, 3);
+    return ip(input) && address == 0x800EB201;
+  },
+
+  [](Tok::Input& input) -> bool {
+    double value = 0;
+    auto matcher = Tok::resumable(Tok::decimal(value));
+    Tok::Token token;
+    auto partial = input;
+    const auto first = matcher(partial, token);
+    Tok::Input more = "1.75;";
+    const auto second = matcher(more, token);
+    return first == Tok::match_status::incomplete && second == Tok::match_status::matched &&
+      *token == "1.75" && value == 1.75;
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
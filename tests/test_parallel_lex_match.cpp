@@ -0,0 +1,95 @@
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lextok_batch.h"
+
+enum { WORD, NUMBER, QUOTED, PUNCTUATION, BLANK };
+
+// Quoted strings make the tokens depend on where lexing started
+static const auto lex = Tok::lexer(std::pair{WORD, Tok::at_least_one(Tok::alphabet())},
+    std::pair{NUMBER, Tok::at_least_one(Tok::digit())},
+    std::pair{QUOTED, Tok::char_token('"') & Tok::many(Tok::none_of("\"")) & Tok::char_token('"')},
+    std::pair{PUNCTUATION, Tok::any_of("+=:,.?")},
+    std::pair{BLANK, Tok::at_least_one(Tok::whitespace())});
+
+// A raw AT trace without framing
+static std::string make_trace(std::size_t lines)
+{
+  std::string trace;
+  for (std::size_t i = 0; i < lines; i++)
+    trace += i % 2 ? "+CGPADDR: " + std::to_string(i % 7) + ",\"10 0 0 " + std::to_string(i % 256) + " ok, sure\"\r\n" :
+      "AT+CGPADDR=" + std::to_string(i % 5) + "\r\nOK\r\n";
+  return trace;
+}
+
+// Compare parallel lexing with lexing in one go
+static bool same_as_sequential(Tok::Input input, const Tok::lex_options& options)
+{
+  std::vector<Tok::token_record> expected;
+  const auto rest = lex(input, [&expected](Tok::token_record token) { expected.push_back(token); });
+  const auto result = Tok::parallel_lex(lex, input, options);
+  if (result.rest != rest || result.rest.data() != rest.data() || result.tokens.size() != expected.size())
+    return false;
+  for (std::size_t i = 0; i < expected.size(); i++)
+    if (result.tokens[i].id != expected[i].id || result.tokens[i].offset != expected[i].offset ||
+        result.tokens[i].length != expected[i].length)
+      return false;
+  return true;
+}
+
+static Tok::Input input[] = {
+  {""},                             // Empty input
+  {"AT+CGPADDR=1\r\n\"a b\" 7"},    // Tiny chunks
+  {"ignored"},                      // Tokens straddle the chunk boundaries
+  {"ignored"},                      // Lexing stops in the middle
+  {"ignored"},                      // Little is lexed again after a newline
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto result = Tok::parallel_lex(lex, input);
+    return result.tokens.empty() && result.rest.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    return same_as_sequential(input, {1, 4}) && same_as_sequential(input, {3, 2}) &&
+      same_as_sequential(input, {100, 4});
+  },
+
+  [](Tok::Input&) -> bool {
+    const auto trace = make_trace(2000);
+    for (const std::size_t size : {7, 64, 1000, 4096})
+      if (!same_as_sequential(trace, {size, 4}) || !same_as_sequential(trace, {size, 1}) ||
+          !same_as_sequential(trace, {size, 4, Tok::char_set("\n")}))
+        return false;
+    return true;
+  },
+
+  [](Tok::Input&) -> bool {
+    auto trace = make_trace(2000);
+    trace[trace.size() / 2] = '\x01';
+    return same_as_sequential(trace, {512, 4}) && !Tok::parallel_lex(lex, trace, {512, 4}).rest.empty();
+  },
+
+  [](Tok::Input&) -> bool {
+    const auto trace = make_trace(20000);
+    const auto result = Tok::parallel_lex(lex, trace, {1 << 16, 4, Tok::char_class::newline});
+    return result.rest.empty() && result.relexed < (trace.size() >> 16) * 64;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,93 @@
+#define LEXTOK_PROFILE
+#define LEXTOK_PROFILE_CYCLES
+
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Profiled tokenizers still run at compile time, without counting
+static Tok::profile constexpr_profile{"constexpr"};
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  return Tok::profiled(constexpr_profile, Tok::str_token("AT"))(input).has_value();
+}
+static_assert(constexpr_match("AT+CSQ"));
+
+static Tok::Input input[] = {
+  {"AT+CSQ\r\n"},                 // Invocations, matches and bytes
+  {"+CME ERROR: 10\r\n"},         // Backtracks of sequences and branches of alternations
+  {"OK\r\n"},                     // Events of nested nodes count for the innermost one
+  {"x"},                          // A report of the counters
+  {"x = 1;"},                     // Profiling does not change what a skipping grammar matches
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    Tok::profile prefix{"prefix"};
+    const auto at = Tok::profiled(prefix, Tok::str_token("AT"));
+    Tok::Input other = "ATD";
+    Tok::Input wrong = "OK";
+    const bool matched = at(input) && at(other) && !at(wrong);
+    return matched && prefix.invocations == 3 && prefix.matches == 2 && prefix.bytes == 4 &&
+      prefix.backtracks == 0 && prefix.branches == 0 && constexpr_profile.invocations == 0;
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::profile result{"result"};
+    const auto code = Tok::str_token("+CME ERROR: ") & Tok::at_least_one(Tok::digit());
+    const auto line = Tok::profiled(result, (Tok::str_token("+CME ERROR: ") & Tok::char_token('x')) |
+        Tok::str_token("OK") | code);
+    const auto token = line(input);
+    return token && *token == "+CME ERROR: 10" && result.backtracks == 1 && result.branches == 2 &&
+      result.matches == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::profile outer{"outer"};
+    Tok::profile inner{"inner"};
+    const auto ok = Tok::profiled(inner, Tok::str_token("ERROR") | Tok::str_token("OK"));
+    const auto line = Tok::profiled(outer, (ok & Tok::str_token("\r\n")) | Tok::str_token("OK"));
+    const auto token = line(input);
+    outer.reset();
+    return token && *token == "OK\r\n" && inner.branches == 1 && inner.matches == 1 &&
+      outer.invocations == 0 && outer.branches == 0 && std::string(outer.name) == "outer";
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::profile any{"any"};
+    Tok::profiled(any, Tok::any())(input);
+    std::FILE* out = std::tmpfile();
+    Tok::write_profile(out, {&any});
+    std::rewind(out);
+    char header[128] = {};
+    char row[128] = {};
+    const bool read = std::fgets(header, sizeof(header), out) && std::fgets(row, sizeof(row), out);
+    std::fclose(out);
+    return read && std::string(header).find("invocations") != std::string::npos &&
+      std::string(row).rfind("any", 0) == 0 && any.invocations == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::profile assignment{"assignment"};
+    const auto statement = Tok::skip(Tok::whitespace(),
+        Tok::profiled(assignment, Tok::alphabet() & Tok::char_token('=') & Tok::digit()) & Tok::char_token(';'));
+    const auto token = statement(input);
+    return token && *token == "x = 1;" && input.empty() && assignment.matches == 1 && assignment.bytes == 5;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+static Tok::Input input[] = {
+  {"\r\n+CGPADDR: 128.14.178.01\r\n"},  // Extract IP address from chunks
+  {"X+CGPADDR"},                        // Early mismatch
+  {"ERROR"},                            // Alternation
+  {"12345"},                            // Run of digits needs the end of input
+  {"AT+CGX"},                           // Keyword set falls back to a shorter keyword
+  {"abc;"},                             // Lambda inside a sequence
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+// Feed 'input' to 'matcher' in chunks of 'chunk' characters, checking the status after each one
+template<typename Matcher>
+static Tok::match_status feed(Matcher& matcher, Tok::Input input, std::size_t chunk, Tok::Token& token,
+    bool end_of_input)
+{
+  auto status = Tok::match_status::incomplete;
+  for (std::size_t received = 0; status == Tok::match_status::incomplete && received < input.size();) {
+    received = std::min(received + chunk, input.size());
+    Tok::Input buffer = input.substr(0, received);
+    status = matcher(buffer, token, end_of_input && received == input.size());
+  }
+  return status;
+}
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    for (std::size_t chunk = 1; chunk <= input.size(); chunk++) {
+      std::string IP;
+      std::size_t calls = 0;
+      const auto IPv4_addr = Tok::map(
+          Tok::at_least_one(Tok::digit()) &
+          Tok::exactly(Tok::char_token('.') & Tok::at_least_one(Tok::digit()) , 3),
+          [&IP, &calls](Tok::Token_view token) { IP = token; calls++; });
+      const auto ip_at_cmd_resp = Tok::str_token("\r\n+CGPADDR: ") &
+        IPv4_addr & Tok::exactly(Tok::newline(), 2);
+      auto matcher = Tok::resumable(ip_at_cmd_resp);
+      Tok::Token token;
+      if (feed(matcher, input, chunk, token, false) != Tok::match_status::matched ||
+          !token || *token != input || IP != "128.14.178.01" || calls != 1)
+        return false;
+    }
+    return true;
+  },
+
+  [](Tok::Input& input) -> bool {
+    auto matcher = Tok::resumable(Tok::str_token("\r\n+CGPADDR: "));
+    Tok::Token token;
+    Tok::Input first_chunk = input.substr(0, 1);
+    return matcher(first_chunk, token) == Tok::match_status::mismatched && !token;
+  },
+
+  [](Tok::Input& input) -> bool {
+    auto matcher = Tok::resumable(Tok::str_token("OK") | Tok::str_token("ERROR") | Tok::str_token("+CME ERROR"));
+    Tok::Token token;
+    Tok::Input partial = input.substr(0, 3);
+    Tok::Input wrong("ERRX");
+    const auto partial_status = matcher(partial, token);
+    const auto complete_status = matcher(input, token);
+    const auto wrong_status = matcher(wrong, token);
+    return partial_status == Tok::match_status::incomplete &&
+      complete_status == Tok::match_status::matched && input.empty() &&
+      wrong_status == Tok::match_status::mismatched;
+  },
+
+  [](Tok::Input& input) -> bool {
+    auto matcher = Tok::resumable(Tok::at_least_one(Tok::digit()));
+    Tok::Token token;
+    const auto status = feed(matcher, input, 2, token, false);
+    Tok::Input last = input;
+    const auto last_status = matcher(last, token, true);
+    return status == Tok::match_status::incomplete && last_status == Tok::match_status::matched &&
+      token && *token == "12345";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t matched = 0;
+    auto matcher = Tok::resumable(Tok::keyword_set({"AT", "AT+CG", "AT+CGATT"},
+          [&matched](std::size_t index, Tok::Token_view) { matched = index; }));
+    Tok::Token token;
+    return feed(matcher, input, 1, token, false) == Tok::match_status::matched &&
+      token && *token == "AT+CG" && matched == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto word = [](Tok::Input& input) -> Tok::Token {
+      std::size_t i = 0;
+      while (i < input.size() && input[i] >= 'a' && input[i] <= 'z')
+        i++;
+      if (i == 0)
+        return {};
+      const auto token = input.substr(0, i);
+      input.remove_prefix(i);
+      return {token};
+    };
+    auto matcher = Tok::resumable(word & Tok::char_token(';'));
+    Tok::Token token;
+    return feed(matcher, input, input.size(), token, false) == Tok::match_status::matched &&
+      token && *token == "abc;";
+  }
+
+};
+
+// Resuming a long run of characters must only look at every character once
+static bool resumes_linearly()
+{
+  std::size_t calls = 0;
+  const auto counted_digit = Tok::impl::single_char_tokenizer([&calls](char c) {
+      calls++;
+      return c >= '0' && c <= '9';
+    }, Tok::mapper::none);
+  auto matcher = Tok::resumable(Tok::char_token('[') & Tok::many(counted_digit) & Tok::char_token(']'));
+  const std::string payload = "[" + std::string(4096, '5') + "]";
+  Tok::Token token;
+  return feed(matcher, payload, 64, token, false) == Tok::match_status::matched &&
+    token && (*token).size() == payload.size() && calls <= 4097 + 64;
+}
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  if (!resumes_linearly()) {
+    std::cerr << "Resumed matching is not linear\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lextok.h"
+
+static Tok::Input input[] = {
+  {"(1,(2,3),((4)))\r\n"},        // Nested parameter lists
+  {"(1,(2,3)"},                   // Unbalanced lists do not match
+  {"{{{{x}}}}"},                  // Depth limit
+  {"x"},                          // Undefined rules do not match
+  {"(5,(6,x))"},                  // Maps of nested rules and redefinitions
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    Tok::rule list;
+    const auto item = Tok::at_least_one(Tok::digit()) | Tok::ref(list);
+    list = Tok::char_token('(') & item & Tok::many(Tok::char_token(',') & item) & Tok::char_token(')');
+    const auto token = list(input);
+    return token && *token == "(1,(2,3),((4)))" && input == "\r\n" && list.is_defined();
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::rule list;
+    const auto item = Tok::at_least_one(Tok::digit()) | Tok::ref(list);
+    list = Tok::char_token('(') & item & Tok::many(Tok::char_token(',') & item) & Tok::char_token(')');
+    const auto original = input;
+    return !list(input) && input == original;
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::rule<512> deep(5);
+    Tok::rule<512> shallow(4);
+    deep = Tok::char_token('x') | (Tok::char_token('{') & Tok::ref(deep) & Tok::char_token('}'));
+    shallow = Tok::char_token('x') | (Tok::char_token('{') & Tok::ref(shallow) & Tok::char_token('}'));
+    Tok::Input other = input;
+    Tok::Input inner = "{{x}}";
+    return !shallow(input) && shallow(inner) && deep(other) && other.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::rule undefined;
+    const auto either = Tok::ref(undefined) | Tok::char_token('x');
+    return !undefined.is_defined() && either(input) && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::vector<std::string> numbers;
+    Tok::rule list;
+    const auto number = Tok::at_least_one(Tok::digit(), [&numbers](Tok::Token_view token) {
+        numbers.emplace_back(token);
+      });
+    const auto item = number | Tok::ref(list);
+    list = Tok::char_token('(') & item & Tok::many(Tok::char_token(',') & item) & Tok::char_token(')');
+    Tok::Input copy = input;
+    if (list(copy) || numbers != std::vector<std::string>{"5", "6"})
+      return false;
+    list = Tok::char_token('(') & item & Tok::many(Tok::char_token(',') & (item | Tok::lower_alphabet())) &
+      Tok::char_token(')');
+    numbers.clear();
+    return list(input) && input.empty() && numbers == std::vector<std::string>{"5", "6"};
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
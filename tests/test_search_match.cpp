@@ -0,0 +1,71 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Searching works at compile time
+static constexpr std::size_t constexpr_search(Tok::Input input)
+{
+  const auto start = input.data();
+  const auto token = Tok::search(Tok::str_token("OK") & Tok::newline(), input);
+  return token ? static_cast<std::size_t>(token->data() - start) : 0;
+}
+static_assert(constexpr_search("noise O OK\r") == 8);
+static_assert(constexpr_search("noise O OK") == 0);
+
+static Tok::Input input[] = {
+  {"\r\n+CSQ: 1,2\r\n+CGPADDR: 1,10.0.0.1\r\nOK"},  // A literal prefix
+  {"+CGPAD +CGPADDR: x +CGPADDR: 3"},            // Candidates that fail the full tokenizer
+  {"status: idle, count=1234;"},                 // No literal prefix, but a FIRST set
+  {"no digits here"},                            // No match leaves the input untouched
+  {"abc"},                                       // Nullable tokenizers match at the start
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    unsigned cid = 0;
+    const auto address = Tok::str_token("+CGPADDR: ") & Tok::integer(cid) & Tok::char_token(',');
+    const auto token = Tok::search(address, input);
+    return token && *token == "+CGPADDR: 1," && cid == 1 && input == "10.0.0.1\r\nOK";
+  },
+
+  [](Tok::Input& input) -> bool {
+    unsigned cid = 0;
+    const auto address = Tok::str_token("+CGPADDR: ") & Tok::integer(cid);
+    const auto token = Tok::search(address, input);
+    return token && *token == "+CGPADDR: 3" && cid == 3 && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto number = Tok::at_least_one(Tok::digit());
+    const auto token = Tok::search(number, input);
+    const auto lambda = [](Tok::Input& in) -> Tok::Token { return Tok::char_token(';')(in); };
+    const auto end = Tok::search(lambda, input);
+    return token && *token == "1234" && end && *end == ";" && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto before = input;
+    return !Tok::search(Tok::digit(), input) && input == before;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::search(Tok::many(Tok::digit()), input);
+    return token && token->empty() && input == "abc";
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include <functional>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "lextok.h"
+
+// Chains of operators build a single flat node
+static constexpr auto date = Tok::at_least_one(Tok::digit()) & Tok::char_token('/') &
+  Tok::at_least_one(Tok::digit()) & Tok::char_token('/') & Tok::at_least_one(Tok::digit());
+static_assert(std::tuple_size_v<decltype(date.parts)> == 5);
+static_assert(std::is_same_v<decltype(Tok::seq(Tok::digit(), Tok::digit() & Tok::digit())),
+    decltype(Tok::digit() & Tok::digit() & Tok::digit())>);
+static_assert(std::is_same_v<decltype(Tok::alt(Tok::digit(), Tok::digit() | Tok::digit())),
+    decltype(Tok::digit() | Tok::digit() | Tok::digit())>);
+
+// FIRST sets join the parts up to the first one that is not nullable
+static constexpr auto sign_number = Tok::maybe(Tok::char_token('-')) & Tok::maybe(Tok::char_token('+')) &
+  Tok::digit() & Tok::char_token('x');
+static_assert(sign_number.first().chars.contains('-') && sign_number.first().chars.contains('+') &&
+    sign_number.first().chars.contains('7') && !sign_number.first().chars.contains('x') &&
+    !sign_number.first().nullable);
+
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  return Tok::seq(Tok::str_token("+CREG: "), Tok::digit(), Tok::char_token(','), Tok::digit())(input) &&
+    input.empty();
+}
+static_assert(constexpr_match("+CREG: 0,1"));
+
+static Tok::Input input[] = {
+  {"12/10/2026 rest"},            // The token spans every part
+  {"12/10/x"},                    // A failing part restores the input
+  {"+CGREG: 2,1"},                // Maps of parts that matched are called
+  {"+CGREG: 2,"},                 // Resumable matching across chunks
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto token = date(input);
+    return token && *token == "12/10/2026" && input == " rest";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto original = input;
+    return !date(input) && input == original;
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::string stat;
+    const auto reply = Tok::seq(Tok::str_token("+CGREG: "), Tok::digit(), Tok::char_token(','),
+        Tok::digit([&stat](Tok::Token_view token) { stat = std::string(token); }));
+    return reply(input) && stat == "1";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto reply = Tok::str_token("+CGREG: ") & Tok::digit() & Tok::char_token(',') &
+      Tok::at_least_one(Tok::digit());
+    decltype(reply)::state progress;
+    std::size_t size = 0;
+    if (reply.resume(input, size, progress, false) != Tok::match_status::incomplete)
+      return false;
+    const std::string whole = std::string(input) + "5\r\n";
+    return reply.resume(whole, size, progress, false) == Tok::match_status::matched && size == 11 &&
+      reply.resume("+CGREG: x", size, progress, true) == Tok::match_status::mismatched;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Calls with free whitespace and comments between their elements
+static constexpr auto comment = Tok::char_token('#') & Tok::until('\n');
+static constexpr auto name = Tok::lexeme(Tok::alphabet() & Tok::many(Tok::alphabet() | Tok::digit()));
+static constexpr auto arg = Tok::at_least_one(Tok::digit()) | name;
+static constexpr auto call = Tok::skip(Tok::whitespace() | comment,
+    name & Tok::char_token('(') & Tok::maybe(arg & Tok::many(Tok::char_token(',') & arg)) & Tok::char_token(')'));
+
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  const auto token = call(input);
+  return token && *token == "f( 1 ,2)" && input == "x";
+}
+static_assert(constexpr_match(" f( 1 ,2)  x"));
+static_assert(Tok::first_of(call).chars.contains(' ') && Tok::first_of(call).chars.contains('#'));
+
+static Tok::Input input[] = {
+  {"  foo ( 1 ,# first\n bar , 22 )  rest"},  // Whitespace and comments between elements
+  {"f oo(1)"},                                // Nothing is skipped within a lexeme
+  {"a \t 12  b"},                             // Maps see tokens without the skipped text
+  {"foo(1,)"},                                // A mismatch leaves the input untouched
+  {"# only comments\n# are skipped\nx  y"},   // Skippers without runs of characters
+  {"( 1 ) [ 2 ]  ( 3 )x"},                    // Transactions, memoization and adaptive alternations are looked through
+  {"HDR : 12 , b"},                           // Copies of a memoized rule still share its outcomes
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto token = call(input);
+    return token && *token == "foo ( 1 ,# first\n bar , 22 )" && input == "rest";
+  },
+
+  [](Tok::Input& input) -> bool {
+    auto spaced = input;
+    const auto loose = Tok::skip(Tok::whitespace(), Tok::alphabet() & Tok::many(Tok::alphabet() | Tok::digit()));
+    const auto token = loose(spaced);
+    return !call(input) && input == "f oo(1)" && token && *token == "f oo" && spaced == "(1)";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::string number;
+    const auto pair = Tok::skip(Tok::many(Tok::whitespace()),
+        Tok::char_token('a') & Tok::at_least_one(Tok::digit(), [&number](Tok::Token_view token) { number = std::string(token); }));
+    const auto token = pair(input);
+    return token && *token == "a \t 12" && number == "12" && input == "b";
+  },
+
+  [](Tok::Input& input) -> bool {
+    return !call(input) && input == "foo(1,)";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto words = Tok::skip(comment & Tok::newline(), Tok::at_least_one(Tok::alphabet()));
+    const auto token = words(input);
+    return token && *token == "x" && input == "  y";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::string digits;
+    Tok::map_record records[4];
+    Tok::map_log journal(records);
+    Tok::memo_entry arena[16];
+    Tok::memo_cache cache(arena);
+    Tok::branch_stats stats;
+    const auto digit = Tok::digit(Tok::defer([&digits](Tok::Token_view token) { digits += token; }));
+    const auto round = Tok::transaction(Tok::char_token('(') & digit & Tok::char_token(')'), journal);
+    const auto square = Tok::memo(Tok::char_token('[') & digit & Tok::char_token(']'), cache);
+    const auto items = Tok::skip(Tok::whitespace(), Tok::at_least_one(Tok::adaptive_alt(stats, round, square)));
+    const auto token = items(input);
+    return token && *token == "( 1 ) [ 2 ]  ( 3 )" && input == "x" && digits == "123";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t header_calls = 0;
+    Tok::memo_entry arena[16];
+    Tok::memo_cache cache(arena);
+    const auto header = Tok::memo(Tok::str_token("HDR") & Tok::char_token(':') &
+        Tok::at_least_one(Tok::digit(), [&header_calls](Tok::Token_view) { header_calls++; }), cache);
+    const auto message = Tok::skip(Tok::whitespace(),
+        (header & Tok::char_token(',') & Tok::char_token('a')) | (header & Tok::char_token(',') & Tok::char_token('b')));
+    Tok::Input plain = "HDR:12";
+    const bool unskipped = header(plain).has_value() && cache.hits() == 0;
+    const auto token = message(input);
+    return unskipped && token && *token == "HDR : 12 , b" && header_calls == 2 && cache.hits() == 1;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
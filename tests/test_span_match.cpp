@@ -0,0 +1,138 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <cstring>
+
+#include "lextok.h"
+
+// The run-length kernels must remain usable at compile time
+static constexpr std::size_t constexpr_span()
+{
+  Tok::Input input("0123456789abc");
+  const auto token = Tok::many(Tok::digit())(input);
+  return token ? (*token).size() : 0;
+}
+static_assert(constexpr_span() == 10);
+
+static const Tok::char_set sets[] = {
+  Tok::char_class::digit,
+  Tok::char_class::hex_digit,
+  Tok::char_class::alphabet | Tok::char_class::digit | Tok::char_set("_"),
+  Tok::char_class::whitespace,
+  ~Tok::char_set("\",\r\n"),
+  Tok::char_set("aceg!~") | Tok::char_set::range('\x80', '\xff'),
+  Tok::char_set::all(),
+  Tok::char_set()
+};
+
+// Build a buffer that is a long run of members of 'set' followed by a non-member
+static std::string make_run(const Tok::char_set& set, std::size_t length, std::mt19937& gen)
+{
+  std::string members, others;
+  for (int c = 0; c < 256; c++)
+    (set.contains(static_cast<char>(c)) ? members : others).push_back(static_cast<char>(c));
+  std::string run;
+  for (std::size_t i = 0; i < length && !members.empty(); i++)
+    run.push_back(members[gen() % members.size()]);
+  if (!others.empty())
+    run.push_back(others[gen() % others.size()]);
+  return run + "tail";
+}
+
+static Tok::Input input[] = {
+  {},                                       // Empty input
+  {"12345678901234567890123456789012345"},  // Longer than a vector block
+  {"\"a quoted field that spans several vector blocks\""},
+  {"deadBEEF0123456789abcdefABCDEF0123456789xyz"},
+  {"BEEF:"},                                // Exact number of matches
+  {"12a"},                                  // Exact number of matches (negative)
+  {"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab"} // Custom predicate
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto many_token = Tok::many(Tok::digit())(input);
+    const auto at_least_one_token = Tok::at_least_one(Tok::digit())(input);
+    return many_token && *many_token == "" && !at_least_one_token;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::at_least_one(Tok::digit())(input);
+    return token && (*token).size() == 35 && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::string str;
+    const auto token = (
+        Tok::char_token('"') &
+        Tok::at_least_one(Tok::none_of("\""), [&str](Tok::Token_view token) { str = token; }) &
+        Tok::char_token('"'))(input);
+    return token && str == "a quoted field that spans several vector blocks";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::many(Tok::hex_digit())(input);
+    return token && (*token).size() == 40 && input == "xyz";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = (Tok::exactly(Tok::hex_digit(), 4) & Tok::char_token(':'))(input);
+    return token && *token == "BEEF:" && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::exactly(Tok::digit(), 3)(input);
+    return !token && input == "12a";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto is_a = Tok::impl::single_char_tokenizer([](char c) { return c == 'a'; }, Tok::mapper::none);
+    const auto token = (Tok::at_least_one(is_a) & Tok::exactly(Tok::impl::single_char_tokenizer(
+            [](char c) { return c == 'b'; }, Tok::mapper::none), 1))(input);
+    return token && (*token).size() == 38 && Tok::many(is_a)(input) && input.empty();
+  }
+
+};
+
+// Compare the run-length kernel against the per-character protocol on random runs
+static bool compare_with_per_character_protocol()
+{
+  std::mt19937 gen(42);
+  for (const auto& set : sets)
+    for (std::size_t length = 0; length < 300; length++) {
+      const auto buffer = make_run(set, length, gen);
+      for (std::size_t offset = 0; offset < 4 && offset < buffer.size(); offset++) {
+        Tok::Input fast(buffer.data() + offset, buffer.size() - offset);
+        Tok::Input slow = fast;
+        std::size_t count = 0;
+        const auto fast_token = Tok::many(Tok::any_of(set))(fast);
+        const auto slow_token = Tok::many(Tok::any_of(set, [&count](Tok::Token_view){ count++; }))(slow);
+        if (!fast_token || !slow_token || *fast_token != *slow_token || fast != slow || count != (*slow_token).size())
+          return false;
+        Tok::Input fast_plus(buffer.data() + offset, buffer.size() - offset);
+        const auto plus_token = Tok::at_least_one(Tok::any_of(set))(fast_plus);
+        if (bool(plus_token) != !(*slow_token).empty())
+          return false;
+      }
+    }
+  return true;
+}
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  if (!compare_with_per_character_protocol()) {
+    std::cerr << "Run-length kernel disagrees with the per-character protocol\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Fields of a command, split at compile time
+static constexpr auto field = Tok::at_least_one(Tok::none_of(",")) & Tok::maybe(Tok::char_token(','));
+static constexpr char command[] = "AT+CGDCONT,1,IP,internet";
+static constexpr auto& fields = Tok::static_parse<field, command>;
+static_assert(fields.size() == 4 && fields.complete && fields.consumed == sizeof(command) - 1);
+static_assert(fields[1].offset == 11 && fields[1].length == 2 && fields[3].length == 8);
+
+// Lexers record the identifier of the rule
+enum class kind { word, number, blank };
+static constexpr auto lex = Tok::lexer(std::pair{kind::word, Tok::at_least_one(Tok::alphabet())},
+    std::pair{kind::number, Tok::at_least_one(Tok::digit())},
+    std::pair{kind::blank, Tok::at_least_one(Tok::whitespace())});
+static constexpr Tok::Input format = "rssi 31 ber ?";
+static constexpr auto& lexed = Tok::static_parse<lex, format, 8>;
+static_assert(lexed.size() == 6 && !lexed.complete && lexed.consumed == 12);
+static_assert(lexed[2].id == static_cast<std::size_t>(kind::number) && lexed[2].offset == 5);
+
+// Parsers yield their attributes
+struct csq_reading {
+  int rssi;
+  int ber;
+};
+static constexpr auto csq = Tok::attr::as<csq_reading>(Tok::str_token("+CSQ: ") & Tok::attr::integer<int>() &
+    Tok::char_token(',') & Tok::attr::integer<int>());
+static constexpr char response[] = "+CSQ: 21,99";
+static constexpr auto reading = Tok::static_parse<csq, response>;
+static_assert(reading && reading->rssi == 21 && reading->ber == 99);
+
+static Tok::Input input[] = {
+  {"AT+CGDCONT,1,IP,internet"},   // The tables are usable at run time
+  {"rssi 31 ber ?"},              // Tokens of a lexer
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    std::string joined;
+    for (const auto& token : fields)
+      joined += std::string(input.substr(token.offset, token.length)) + "|";
+    return joined == "AT+CGDCONT,|1,|IP,|internet|";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t words = 0;
+    for (const auto& token : lexed)
+      words += token.id == static_cast<std::size_t>(kind::word);
+    return words == 2 && input.substr(lexed.consumed) == "?";
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+enum { KEYWORD, IDENTIFIER, NUMBER, BLANK };
+
+static const auto lex = Tok::lexer(std::pair{KEYWORD, Tok::str_token("if")},
+    std::pair{IDENTIFIER, Tok::at_least_one(Tok::alphabet())},
+    std::pair{NUMBER, Tok::at_least_one(Tok::digit())},
+    std::pair{BLANK, Tok::at_least_one(Tok::whitespace())});
+
+static Tok::token_arena<8> arena;
+static Tok::token_buffer buffer(arena);
+
+static Tok::Input input[] = {
+  {"if x 42"},              // Sink of a lexer
+  {"iffy 7 y"},             // Reused for another input
+  {"a b c d e f g h i j"},  // Tokens that do not fit are dropped
+  {"1,22,333,x"},           // Filled from a lazy range
+  {"1,2,3,4,5,6,7,8,9,"},   // A lazy range stops at the first token that does not fit
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto rest = lex(input, buffer);
+    return rest.empty() && buffer.size() == 5 && !buffer.overflowed() &&
+      buffer.ids()[0] == KEYWORD && buffer.ids()[2] == IDENTIFIER && buffer.ids()[4] == NUMBER &&
+      buffer.offsets()[4] == 5 && buffer.lengths()[4] == 2 && buffer.view(4, input) == "42" &&
+      buffer[2].id == IDENTIFIER && buffer[2].offset == 3 && buffer[2].length == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    buffer.clear();
+    lex(input, buffer);
+    return buffer.size() == 5 && buffer.ids()[0] == IDENTIFIER && buffer.view(0, input) == "iffy" &&
+      buffer.view(4, input) == "y";
+  },
+
+  [](Tok::Input& input) -> bool {
+    buffer.clear();
+    lex(input, buffer);
+    return buffer.size() == 8 && buffer.overflowed() && buffer.view(7, input) == " ";
+  },
+
+  [](Tok::Input& input) -> bool {
+    buffer.clear();
+    const auto rest = Tok::tokens(Tok::at_least_one(Tok::digit()) & Tok::char_token(','), input).collect(buffer, NUMBER);
+    return rest == "x" && buffer.size() == 3 && buffer.ids()[2] == NUMBER && buffer.view(1, input) == "22," &&
+      buffer.offsets()[2] == 5 && !buffer.overflowed();
+  },
+
+  [](Tok::Input& input) -> bool {
+    buffer.clear();
+    buffer.append(IDENTIFIER, 0, 0);
+    const auto rest = Tok::tokens(Tok::digit() & Tok::char_token(','), input).collect(buffer);
+    return rest == "8,9," && buffer.size() == 8 && buffer.overflowed() && buffer.view(7, input) == "7," &&
+      buffer.ids()[0] == IDENTIFIER && buffer.ids()[1] == 0;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <cstring>
+#include <vector>
+
+#include "lextok.h"
+
+// Ranges can be iterated at compile time
+static constexpr std::size_t constexpr_count()
+{
+  std::size_t n = 0;
+  for (const auto token : Tok::tokens(Tok::at_least_one(Tok::digit()) & Tok::maybe(Tok::char_token(',')), "1,22,333"))
+    n += token.size();
+  return n;
+}
+static_assert(constexpr_count() == 8);
+
+static Tok::Input input[] = {
+  {},                                   // Empty input
+  {"alpha beta  gamma"},                // Words separated by whitespace
+  {"1,2,3,x,5"},                        // Stop at the first mismatch
+  {"STOP here and never lex the rest"}, // Stop early
+  {"aaa"}                               // Empty matches end the range
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto range = Tok::tokens(Tok::any(), input);
+    return range.begin() == range.end();
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::vector<std::string> words;
+    const auto word = Tok::at_least_one(Tok::alphabet(), [&words](Tok::Token_view token) {
+        words.emplace_back(token);
+      }) & Tok::many(Tok::whitespace());
+    const auto range = Tok::tokens(word, input);
+    const auto count = std::distance(range.begin(), range.end());
+    return count == 3 && words.size() == 3 && words[0] == "alpha" && words[2] == "gamma";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto range = Tok::tokens(Tok::digit() & Tok::char_token(','), input);
+    auto it = range.begin();
+    std::size_t count = 0;
+    for (; it != range.end(); ++it)
+      count++;
+    // The input the tokenizer failed on is still reachable after the loop
+    auto last = range.begin();
+    while (std::next(last) != range.end())
+      ++last;
+    return count == 3 && last.remaining() == "x,5" && *last == "3,";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t lexed = 0;
+    const auto word = Tok::at_least_one(Tok::none_of(" "), [&lexed](Tok::Token_view) { lexed++; }) &
+      Tok::many(Tok::char_token(' '));
+    for (const auto token : Tok::tokens(word, input))
+      if (token == "STOP ")
+        break;
+    return lexed == 1;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto range = Tok::tokens(Tok::many(Tok::digit()), input);
+    return range.begin() == range.end();
+  }
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
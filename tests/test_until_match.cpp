@@ -0,0 +1,92 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Delimited spans can be matched at compile time
+static constexpr std::size_t constexpr_until(Tok::Input input)
+{
+  const auto token = Tok::until(Tok::str_token("\r\n"))(input);
+  return token ? token->size() : 0;
+}
+static_assert(constexpr_until("OK\r\n") == 2);
+static_assert(constexpr_until("\r\r\n") == 1);
+static_assert(Tok::first_of(Tok::until('"')).nullable);
+static_assert(!Tok::first_of(Tok::until('"')).chars.contains('"'));
+
+static Tok::Input input[] = {
+  {"0,\"IP\",\"internet\"\r\n"},                    // A closing quote
+  {"payload;more"},                                 // No delimiter does not match
+  {"abc\t def"},                                    // A set of delimiters
+  {"+CGPADDR: 1,\"10.0.0.1\"\r\r\nOK\r\n"},         // A delimiting string
+  {"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx|"}, // Long spans, beyond a vector block
+  {"partial\r"},                                    // Resumable matching
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    Tok::Token_view apn;
+    const auto quoted = Tok::char_token('"') & Tok::until('"', [&apn](Tok::Token_view t) { apn = t; }) &
+      Tok::char_token('"');
+    const auto context = Tok::str_token("0,") & quoted & Tok::char_token(',') & quoted;
+    Tok::Input empty = "\"\"";
+    return context(input) && apn == "internet" && input == "\r\n" && quoted(empty) && apn.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto before = input;
+    Tok::Input at_start = ":x";
+    const auto empty = Tok::until(':')(at_start);
+    return !Tok::until(':')(input) && input == before && empty && empty->empty() && at_start == ":x";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto word = Tok::until(Tok::char_class::whitespace);
+    const auto same = Tok::until(Tok::Predicate(" \t\r\n"));
+    auto other = input;
+    const auto token = word(input);
+    return token && *token == "abc" && input == "\t def" && same(other) && other == input;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto line = Tok::until(Tok::str_token("\r\n")) & Tok::str_token("\r\n");
+    const auto first = line(input);
+    const auto second = line(input);
+    return first && *first == "+CGPADDR: 1,\"10.0.0.1\"\r\r\n" && second && *second == "OK\r\n" && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    auto by_set = input;
+    const auto token = Tok::until('|')(input);
+    const auto same = Tok::until(Tok::char_set::of('|') | Tok::char_set::of('#'))(by_set);
+    return token && token->size() == 50 && input == "|" && same && *same == *token;
+  },
+
+  [](Tok::Input& input) -> bool {
+    auto matcher = Tok::resumable(Tok::until(Tok::str_token("\r\n")));
+    Tok::Token token;
+    const auto first = matcher(input, token);
+    Tok::Input more = "partial\r\nOK";
+    const auto second = matcher(more, token);
+    const auto line = token;
+    Tok::Input none = "x";
+    const auto last = matcher(none, token, true);
+    return first == Tok::match_status::incomplete && second == Tok::match_status::matched &&
+      *line == "partial" && more == "\r\nOK" && last == Tok::match_status::mismatched;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
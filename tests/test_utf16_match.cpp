@@ -0,0 +1,79 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Entries of a SIM phonebook, as read with AT+CPBR in the UCS2 character set
+static constexpr auto number = Tok::utf16::at_least_one(Tok::utf16::digit());
+static constexpr auto quoted_number = Tok::utf16::char_token(u'"') & Tok::utf16::maybe(Tok::utf16::char_token(u'+')) &
+  number & Tok::utf16::char_token(u'"');
+
+// UTF-16 input is matched at compile time too
+static constexpr bool constexpr_match(Tok::utf16::Input input)
+{
+  return quoted_number(input) && input == u",145";
+}
+static_assert(constexpr_match(u"\"+4912345\",145") && !constexpr_match(u"\"+49x\",145"));
+
+static Tok::utf16::Input input[] = {
+  {u"+CPBR: 1,\"+4912345\",145,\"Jürgen\"\r\n"},  // An entry, matched in place
+  {u"\U0001F600\U0001F600!"},       // Surrogate pairs are one code point
+  {u"\xd83d x"},                    // Lone surrogates never match
+  {u"ЖЖЖЖ"},    // Bounds count instances
+  {u"+CPBR: 2,\"\",129"},           // A mismatch leaves the input untouched
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::utf16::Input);
+
+static std::function<bool(Tok::utf16::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::utf16::Input& input) -> bool {
+    Tok::utf16::Token_view name;
+    const auto text = Tok::utf16::char_token(u'"') &
+      Tok::utf16::many(Tok::utf16::letter() | Tok::utf16::char_token(u' '),
+          [&name](Tok::utf16::Token_view token) { name = token; }) & Tok::utf16::char_token(u'"');
+    const auto entry = Tok::utf16::str_token(u"+CPBR: ") & number & Tok::utf16::char_token(u',') & quoted_number &
+      Tok::utf16::char_token(u',') & number & Tok::utf16::char_token(u',') & text;
+    const auto token = entry(input);
+    return token && input == u"\r\n" && name == u"Jürgen" && name.data() > (*token).data() &&
+      name.data() < input.data();
+  },
+
+  [](Tok::utf16::Input& input) -> bool {
+    const auto emoji = Tok::utf16::range(0x1f600, 0x1f64f);
+    const auto token = Tok::utf16::exactly(emoji, 2)(input);
+    return token && (*token).size() == 4 && input == u"!";
+  },
+
+  [](Tok::utf16::Input& input) -> bool {
+    auto rest = input;
+    const bool lone = !Tok::utf16::code_point()(rest) && rest == input;
+    rest.remove_prefix(1);
+    return lone && Tok::utf16::code_point()(rest) && rest == u"x";
+  },
+
+  [](Tok::utf16::Input& input) -> bool {
+    Tok::utf16::Input five = input;
+    const auto token = Tok::utf16::between(Tok::utf16::letter(), 1, 3)(input);
+    return token && (*token).size() == 3 && input.size() == 1 && !Tok::utf16::exactly(Tok::utf16::letter(), 5)(five);
+  },
+
+  [](Tok::utf16::Input& input) -> bool {
+    const auto original = input;
+    const auto entry = (Tok::utf16::str_token(u"+CPBR: ") & number & Tok::utf16::char_token(u',') & quoted_number) |
+      Tok::utf16::str_token(u"ERROR");
+    return !entry(input) && input == original;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
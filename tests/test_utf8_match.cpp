@@ -0,0 +1,82 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Code points are decoded at compile time too
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  return Tok::at_least_one(Tok::utf8::letter())(input) && input == " 42";
+}
+static_assert(constexpr_match("Grüße 42"));
+static_assert(Tok::utf8::letter().first().chars.contains('\xc3') && !Tok::utf8::letter().first().chars.contains('1'));
+
+static Tok::Input input[] = {
+  {"Привет, мир"},                // Letters of other scripts, matched in place
+  {"abc\xc3\xa9\xe4\xb8\xad" "def!"}, // Mixed ASCII runs and multi-byte code points
+  {"\xc0\xaf\xed\xa0\x80\xf4\x90\x80\x80"}, // Overlong encodings, surrogates and out of range code points
+  {"€€€€"},                       // Bounds count code points
+  {"\xe2\x82"},                   // Code points split across chunks
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    std::string word;
+    const auto token = Tok::at_least_one(Tok::utf8::letter(), [&word](Tok::Token_view token) {
+        word = std::string(token);
+      })(input);
+    return token && word == "Привет" && input == ", мир";
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::size_t count = 0;
+    Tok::Input copy = input;
+    while (Tok::utf8::letter()(copy))
+      count++;
+    const auto token = Tok::many(Tok::utf8::letter())(input);
+    return token && (*token).size() == 11 && count == 8 && input == "!";
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::Input overlong = input.substr(0, 2);
+    Tok::Input surrogate = input.substr(2, 3);
+    Tok::Input beyond = input.substr(5);
+    return !Tok::utf8::code_point()(overlong) && !Tok::utf8::code_point()(surrogate) &&
+      !Tok::utf8::code_point()(beyond) && !Tok::many(Tok::utf8::code_point())(beyond)->size();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto euros = Tok::exactly(Tok::utf8::range(0x20ac, 0x20ac), 3);
+    const auto token = euros(input);
+    return token && (*token).size() == 9 && input == "€";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto word = Tok::at_least_one(Tok::utf8::code_point());
+    decltype(word)::state progress;
+    std::size_t size = 0;
+    if (word.resume(input, size, progress, false) != Tok::match_status::incomplete)
+      return false;
+    const std::string whole = std::string(input) + "\xac" "1 ";
+    Tok::utf8::code_point_set digits = Tok::utf8::code_point_set::range('0', '9') |
+      Tok::utf8::code_point_set::range(0x660, 0x669);
+    Tok::Input arabic = "\xd9\xa3" "7x";
+    return word.resume(whole, size, progress, true) == Tok::match_status::matched && size == 5 &&
+      Tok::at_least_one(Tok::utf8::any_of(digits))(arabic) && arabic == "x";
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "lextok.h"
+
+// Widths are known at compile time
+static constexpr auto sep = Tok::str_token("\r\n+CGPADDR: ");
+static constexpr auto quad = Tok::exactly(Tok::hex_digit(), 4);
+static constexpr auto address = quad & Tok::exactly(Tok::char_token(':') & quad, 7);
+static_assert(Tok::width_of(sep).min == 12 && Tok::width_of(sep).max == 12);
+static_assert(Tok::width_of(quad).min == 4 && Tok::width_of(quad).max == 4);
+static_assert(Tok::width_of(address).min == 39 && Tok::width_of(address).max == 39);
+static_assert(Tok::width_of(Tok::maybe(sep)).min == 0 && Tok::width_of(Tok::maybe(sep)).max == 12);
+static_assert(Tok::width_of(Tok::many(Tok::digit())).max == Tok::impl::unbounded);
+static_assert(Tok::width_of(Tok::str_token("OK") | Tok::str_token("ERROR")).min == 2 &&
+    Tok::width_of(Tok::str_token("OK") | Tok::str_token("ERROR")).max == 5);
+static_assert(Tok::width_of(Tok::keyword_set({"OK", "NO CARRIER", "ERROR"})).max == 10);
+static_assert(Tok::width_of(Tok::between(Tok::str_token("\r\n"), 1, 3)).min == 2 &&
+    Tok::width_of(Tok::between(Tok::str_token("\r\n"), 1, 3)).max == 6);
+static_assert(Tok::width_of(Tok::at_least_one(Tok::utf8::letter())).min == 1);
+static_assert(Tok::width_of([](Tok::Input&) -> Tok::Token { return {}; }).max == Tok::impl::unbounded);
+
+// Sequences of constant width, and repetitions of them, store no shortest match
+static constexpr auto hhmm = Tok::digit() & Tok::char_token(':') & Tok::digit();
+static_assert(sizeof(hhmm) == sizeof(std::tuple<decltype(Tok::digit()), decltype(Tok::char_token(':')),
+    decltype(Tok::digit())>));
+static_assert(sizeof(Tok::exactly(hhmm, 2)) == sizeof(hhmm) + 3 * sizeof(std::size_t));
+
+static constexpr bool constexpr_match(Tok::Input input)
+{
+  return Tok::between(Tok::digit(), 1, 3)(input) && input == "4";
+}
+static_assert(constexpr_match("1234"));
+
+static Tok::Input input[] = {
+  {"fe80:0000:0000:0000:0204:61ff:fe9d:f156"},  // Fixed width sequences
+  {"fe80:0000:0000"},             // Input too short for the narrowest match
+  {"\r\n\r\n\r\n\r\nOK"},         // Bounded repetitions
+  {"\r"},                         // Input shorter than the least number of instances
+  {"7,"},                         // Maps still run when a part matches
+  {"1:2,3:"},                     // Constant width sequences
+};
+
+static constexpr std::size_t number_of_tests = sizeof(input) / sizeof(Tok::Input);
+
+static std::function<bool(Tok::Input& input)> test_drivers[number_of_tests] = {
+
+  [](Tok::Input& input) -> bool {
+    const auto token = address(input);
+    return token && (*token).size() == 39 && input.empty();
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto original = input;
+    return !address(input) && input == original;
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto token = Tok::between(Tok::str_token("\r\n"), 1, 3)(input);
+    return token && (*token).size() == 6 && input == "\r\nOK";
+  },
+
+  [](Tok::Input& input) -> bool {
+    Tok::Input empty = "";
+    return !Tok::between(Tok::str_token("\r\n"), 1, 3)(input) && input == "\r" &&
+      Tok::between(Tok::str_token("\r\n"), 0, 3)(empty);
+  },
+
+  [](Tok::Input& input) -> bool {
+    std::string seen;
+    const auto reading = Tok::digit([&seen](Tok::Token_view token) { seen = std::string(token); }) &
+      Tok::char_token(',') & Tok::digit();
+    return !reading(input) && seen == "7" && input == "7,";
+  },
+
+  [](Tok::Input& input) -> bool {
+    const auto times = hhmm & Tok::char_token(',') & hhmm;
+    const auto token = hhmm(input);
+    Tok::Input again = "1:2,3:";
+    return token && *token == "1:2" && !times(again) && again == "1:2,3:" && Tok::width_of(times).min == 7;
+  },
+
+};
+
+int main()
+{
+  for (std::size_t i = 0; i < number_of_tests; i++)
+    if (!test_drivers[i](input[i])) {
+      std::cerr << "Subtest " << i << " has failed\n";
+      return 1;
+    }
+  return 0;
+}